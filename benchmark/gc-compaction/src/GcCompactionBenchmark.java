@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+public class GcCompactionBenchmark {
+    private static final int NUM_NODES = 1 << 19;
+
+    static class Node {
+        Node next;
+        Object garbage;
+        long payload;
+    }
+
+    // Live set which has to be compacted on every GC. Every other node is dropped on each
+    // iteration, so that the survivors slide on compaction.
+    private static Node head;
+
+    static {
+        Node node = null;
+        for (int i = 0; i < NUM_NODES; ++i) {
+            Node n = new Node();
+            n.next = node;
+            n.payload = i;
+            node = n;
+        }
+        head = node;
+    }
+
+    private static void fragment() {
+        // Interleave new nodes with the existing ones so that half of the heap is garbage.
+        for (Node n = head; n != null; n = n.next) {
+            n.garbage = new long[8];
+        }
+        for (Node n = head; n != null; n = n.next) {
+            n.garbage = null;
+        }
+    }
+
+    public void timeCompaction(int count) {
+        for (int i = 0; i < count; ++i) {
+            fragment();
+            Runtime.getRuntime().gc();
+        }
+    }
+
+    public void timeMutatorDuringCompaction(int count) {
+        // Walk the live set while the collector compacts it. Every access to a page which is not
+        // compacted yet stalls until it is.
+        long sum = 0;
+        for (int i = 0; i < count; ++i) {
+            fragment();
+            Thread gc = new Thread() {
+                public void run() {
+                    Runtime.getRuntime().gc();
+                }
+            };
+            gc.start();
+            for (int j = 0; j < 4; ++j) {
+                sum += $noinline$walk(head);
+            }
+            try {
+                gc.join();
+            } catch (InterruptedException e) {
+                throw new Error(e);
+            }
+        }
+        if (sum == 42) { throw new Error(); }
+    }
+
+    static long $noinline$walk(Node node) {
+        if (doThrow) { throw new Error(); }
+        long sum = 0;
+        for (Node n = node; n != null; n = n.next) {
+            sum += n.payload;
+        }
+        return sum;
+    }
+
+    public static boolean doThrow = false;
+}
@@ -0,0 +1,99 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+import java.util.Random;
+
+public class GcThpBenchmark {
+    // About 48MiB of nodes, well beyond what the TLB covers with 4KiB pages.
+    private static final int NUM_NODES = 1 << 20;
+
+    static class Node {
+        Node next;
+        Node other;
+        long payload0;
+        long payload1;
+        long payload2;
+        long payload3;
+    }
+
+    private static Node head;
+
+    static {
+        Node[] nodes = new Node[NUM_NODES];
+        for (int i = 0; i < NUM_NODES; ++i) {
+            nodes[i] = new Node();
+            nodes[i].payload0 = i;
+        }
+        // Link the nodes in a random order so that every step touches a different page.
+        Random random = new Random(42);
+        for (int i = NUM_NODES - 1; i > 0; --i) {
+            int j = random.nextInt(i + 1);
+            Node tmp = nodes[i];
+            nodes[i] = nodes[j];
+            nodes[j] = tmp;
+        }
+        for (int i = 0; i < NUM_NODES; ++i) {
+            nodes[i].next = nodes[(i + 1) % NUM_NODES];
+            nodes[i].other = nodes[random.nextInt(NUM_NODES)];
+        }
+        head = nodes[0];
+    }
+
+    public void timePointerChase(int count) {
+        Node node = head;
+        long sum = 0;
+        for (int i = 0; i < count; ++i) {
+            sum += $noinline$chase(node, NUM_NODES);
+        }
+        if (sum == 42) { throw new Error(); }
+    }
+
+    public void timePointerChaseAfterGc(int count) {
+        // Let the collector move the graph so that it is accessed in its compacted layout.
+        Runtime.getRuntime().gc();
+        timePointerChase(count);
+    }
+
+    public void timeAllocateAndChase(int count) {
+        Node node = head;
+        long sum = 0;
+        for (int i = 0; i < count; ++i) {
+            // Short-lived garbage to keep the collector busy while the graph is being read.
+            for (int j = 0; j < 1024; ++j) {
+                $noinline$allocate();
+            }
+            sum += $noinline$chase(node, NUM_NODES / 16);
+        }
+        if (sum == 42) { throw new Error(); }
+    }
+
+    static long $noinline$chase(Node node, int steps) {
+        if (doThrow) { throw new Error(); }
+        long sum = 0;
+        for (int i = 0; i < steps; ++i) {
+            sum += node.payload0 + node.other.payload1;
+            node = node.next;
+        }
+        return sum;
+    }
+
+    static Object $noinline$allocate() {
+        if (doThrow) { throw new Error(); }
+        return new long[64];
+    }
+
+    public static boolean doThrow = false;
+}
@@ -0,0 +1,56 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+import java.util.Random;
+
+public class LosChurnBenchmark {
+    // Few enough live buffers that the collector frees most of them on every GC.
+    private static final int NUM_LIVE = 64;
+
+    private static final byte[][] live = new byte[NUM_LIVE][];
+
+    public void timeChurnSameSize16K(int count) {
+        churn(count, 16 * 1024, 16 * 1024);
+    }
+
+    public void timeChurnSameSize256K(int count) {
+        churn(count, 256 * 1024, 256 * 1024);
+    }
+
+    public void timeChurnMixedSizes(int count) {
+        churn(count, 16 * 1024, 1024 * 1024);
+    }
+
+    private static void churn(int count, int minSize, int maxSize) {
+        Random random = new Random(42);
+        long sum = 0;
+        for (int i = 0; i < count; ++i) {
+            int size = minSize + (maxSize == minSize ? 0 : random.nextInt(maxSize - minSize));
+            byte[] buffer = $noinline$allocate(size);
+            buffer[size - 1] = (byte) i;
+            live[i % NUM_LIVE] = buffer;
+            sum += buffer[0];
+        }
+        if (sum == 42) { throw new Error(); }
+    }
+
+    static byte[] $noinline$allocate(int size) {
+        if (doThrow) { throw new Error(); }
+        return new byte[size];
+    }
+
+    public static boolean doThrow = false;
+}
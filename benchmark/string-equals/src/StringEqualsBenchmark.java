@@ -0,0 +1,76 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+public class StringEqualsBenchmark {
+    public static final String string4 = "0123";
+    public static final String string36 = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ";  // length = 36
+    public static final String string36Utf16 = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXY\u0100";
+    public static final String string144 = string36 + string36 + string36 + string36;
+
+    // Use new copies so that the comparisons are not short-circuited by reference equality.
+    public static final String copy4 = new String(string4);
+    public static final String copy36 = new String(string36);
+    public static final String copy36Utf16 = new String(string36Utf16);
+    public static final String copy144 = new String(string144);
+    public static final String differentLast144 = string144.substring(0, 143) + "_";
+
+    public void timeEquals4(int count) {
+        String s = string4;
+        String t = copy4;
+        for (int i = 0; i < count; ++i) {
+            $noinline$equals(s, t);
+        }
+    }
+
+    public void timeEquals36(int count) {
+        String s = string36;
+        String t = copy36;
+        for (int i = 0; i < count; ++i) {
+            $noinline$equals(s, t);
+        }
+    }
+
+    public void timeEquals36Utf16(int count) {
+        String s = string36Utf16;
+        String t = copy36Utf16;
+        for (int i = 0; i < count; ++i) {
+            $noinline$equals(s, t);
+        }
+    }
+
+    public void timeEquals144(int count) {
+        String s = string144;
+        String t = copy144;
+        for (int i = 0; i < count; ++i) {
+            $noinline$equals(s, t);
+        }
+    }
+
+    public void timeNotEquals144(int count) {
+        String s = string144;
+        String t = differentLast144;
+        for (int i = 0; i < count; ++i) {
+            $noinline$equals(s, t);
+        }
+    }
+
+    static boolean $noinline$equals(String s, String t) {
+        if (doThrow) { throw new Error(); }
+        return s.equals(t);
+    }
+
+    public static boolean doThrow = false;
+}
@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+public class StringInternBenchmark {
+    // Field names such as those seen when parsing JSON or protobuf text.
+    private static final String[] NAMES = {
+        "id", "name", "type", "value", "timestamp", "status", "version", "count",
+        "description", "createdAt", "updatedAt", "owner", "labels", "items", "next", "error",
+    };
+
+    // Names that are string literals in the boot image, so they are found in frozen tables.
+    private static final String[] BOOT_IMAGE_NAMES = {
+        "java.lang.Object", "java.lang.String", "toString", "hashCode", "equals", "length",
+        "<init>", "<clinit>", "getClass", "valueOf", "charAt", "substring", "intern", "run",
+        "close", "get",
+    };
+
+    private static String[] copies(String[] names) {
+        String[] result = new String[names.length];
+        for (int i = 0; i < names.length; ++i) {
+            // Create a new String object so that `intern()` has to look it up.
+            result[i] = new String(names[i].toCharArray());
+        }
+        return result;
+    }
+
+    private static void internInThreads(final String[] names, int numThreads, final int count) {
+        Thread[] threads = new Thread[numThreads];
+        for (int t = 0; t < numThreads; ++t) {
+            threads[t] = new Thread() {
+                public void run() {
+                    String[] local = copies(names);
+                    for (int i = 0; i < count; ++i) {
+                        $noinline$intern(local[i & (local.length - 1)]);
+                    }
+                }
+            };
+        }
+        for (Thread thread : threads) {
+            thread.start();
+        }
+        for (Thread thread : threads) {
+            try {
+                thread.join();
+            } catch (InterruptedException e) {
+                throw new Error(e);
+            }
+        }
+    }
+
+    public void timeInternNames1Thread(int count) {
+        internInThreads(NAMES, 1, count);
+    }
+
+    public void timeInternNames4Threads(int count) {
+        internInThreads(NAMES, 4, count);
+    }
+
+    public void timeInternNames16Threads(int count) {
+        internInThreads(NAMES, 16, count);
+    }
+
+    public void timeInternBootImageNames1Thread(int count) {
+        internInThreads(BOOT_IMAGE_NAMES, 1, count);
+    }
+
+    public void timeInternBootImageNames4Threads(int count) {
+        internInThreads(BOOT_IMAGE_NAMES, 4, count);
+    }
+
+    public void timeInternBootImageNames16Threads(int count) {
+        internInThreads(BOOT_IMAGE_NAMES, 16, count);
+    }
+
+    static String $noinline$intern(String s) {
+        if (doThrow) { throw new Error(); }
+        return s.intern();
+    }
+
+    public static boolean doThrow = false;
+}
@@ -42,6 +42,7 @@ CompilerOptions::CompilerOptions()
       huge_method_threshold_(kDefaultHugeMethodThreshold),
       large_method_threshold_(kDefaultLargeMethodThreshold),
       inline_max_code_units_(kUnsetInlineMaxCodeUnits),
+      jit_compilation_time_budget_ms_(kDefaultJitCompilationTimeBudgetMs),
       instruction_set_(kRuntimeISA == InstructionSet::kArm ? InstructionSet::kThumb2 : kRuntimeISA),
       instruction_set_features_(nullptr),
       no_inline_from_(),
@@ -79,6 +80,7 @@ CompilerOptions::CompilerOptions()
       count_hotness_in_compiled_code_(false),
       resolve_startup_const_strings_(false),
       initialize_app_image_classes_(false),
+      assume_closed_class_hierarchy_(false),
       check_profiled_methods_(ProfileMethodsCheck::kNone),
       max_image_block_size_(std::numeric_limits<uint32_t>::max()),
       register_allocation_strategy_(RegisterAllocator::kRegisterAllocatorDefault),
@@ -67,6 +67,8 @@ class CompilerOptions final {
   static const bool kDefaultGenerateMiniDebugInfo = true;
   static const size_t kDefaultInlineMaxCodeUnits = 32;
   static constexpr size_t kUnsetInlineMaxCodeUnits = -1;
+  // Thread CPU time a single JIT compilation may use before the optional passes are skipped.
+  static constexpr size_t kDefaultJitCompilationTimeBudgetMs = 50;
 
   enum class CompilerType : uint8_t {
     kAotCompiler,             // AOT compiler.
@@ -140,6 +142,10 @@ class CompilerOptions final {
     inline_max_code_units_ = units;
   }
 
+  size_t GetJitCompilationTimeBudgetMs() const {
+    return jit_compilation_time_budget_ms_;
+  }
+
   bool EmitReadBarrier() const {
     return emit_read_barrier_;
   }
@@ -375,6 +381,12 @@ class CompilerOptions final {
     return initialize_app_image_classes_;
   }
 
+  // Whether the compiled code of an app may rely on class hierarchy analysis of the classes
+  // loaded during compilation. Not supported for the boot image or boot image extensions.
+  bool AssumeClosedClassHierarchy() const {
+    return assume_closed_class_hierarchy_ && !IsBootImage() && !IsBootImageExtension();
+  }
+
   // Returns true if `dex_file` is within an oat file we're producing right now.
   bool WithinOatFile(const DexFile* dex_file) const {
     return ContainsElement(GetDexFilesForOatFile(), dex_file);
@@ -394,6 +406,7 @@ class CompilerOptions final {
   size_t huge_method_threshold_;
   size_t large_method_threshold_;
   size_t inline_max_code_units_;
+  size_t jit_compilation_time_budget_ms_;
 
   InstructionSet instruction_set_;
   std::unique_ptr<const InstructionSetFeatures> instruction_set_features_;
@@ -476,6 +489,9 @@ class CompilerOptions final {
   // Whether we attempt to run class initializers for app image classes.
   bool initialize_app_image_classes_;
 
+  // Whether we devirtualize app methods based on the class hierarchy seen during compilation.
+  bool assume_closed_class_hierarchy_;
+
   // When running profile-guided compilation, check that methods intended to be compiled end
   // up compiled and are not punted.
   ProfileMethodsCheck check_profiled_methods_;
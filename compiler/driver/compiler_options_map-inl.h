@@ -59,6 +59,7 @@ inline bool ReadCompilerOptions(Base& map, CompilerOptions* options, std::string
   map.AssignIfExists(Base::HugeMethodMaxThreshold, &options->huge_method_threshold_);
   map.AssignIfExists(Base::LargeMethodMaxThreshold, &options->large_method_threshold_);
   map.AssignIfExists(Base::InlineMaxCodeUnitsThreshold, &options->inline_max_code_units_);
+  map.AssignIfExists(Base::JitCompilationTimeBudgetMs, &options->jit_compilation_time_budget_ms_);
   map.AssignIfExists(Base::GenerateDebugInfo, &options->generate_debug_info_);
   map.AssignIfExists(Base::GenerateMiniDebugInfo, &options->generate_mini_debug_info_);
   map.AssignIfExists(Base::GenerateBuildID, &options->generate_build_id_);
@@ -94,6 +95,7 @@ inline bool ReadCompilerOptions(Base& map, CompilerOptions* options, std::string
   }
   map.AssignIfExists(Base::ResolveStartupConstStrings, &options->resolve_startup_const_strings_);
   map.AssignIfExists(Base::InitializeAppImageClasses, &options->initialize_app_image_classes_);
+  map.AssignIfExists(Base::AssumeClosedClassHierarchy, &options->assume_closed_class_hierarchy_);
   if (map.Exists(Base::CheckProfiledMethods)) {
     options->check_profiled_methods_ = *map.Get(Base::CheckProfiledMethods);
   }
@@ -144,6 +146,12 @@ NO_INLINE void AddCompilerOptionsArgumentParserOptions(Builder& b) {
                     "A zero value will disable inlining. Honored only by Optimizing. Has priority\n"
                     "over the --compiler-filter option. Intended for development/experimental use.")
           .IntoKey(Map::InlineMaxCodeUnitsThreshold)
+      .Define("--jit-compilation-time-budget-ms=_")
+          .template WithType<unsigned int>()
+          .WithHelp("the thread CPU time in milliseconds a JIT compilation may use before the\n"
+                    "optional optimization passes are skipped. A zero value skips them for every\n"
+                    "JIT compilation. Ignored by AOT compilation. Intended for testing.")
+          .IntoKey(Map::JitCompilationTimeBudgetMs)
 
       .Define({"--generate-debug-info", "-g", "--no-generate-debug-info"})
           .WithValues({true, true, false})
@@ -242,6 +250,15 @@ NO_INLINE void AddCompilerOptionsArgumentParserOptions(Builder& b) {
           .WithValueMap({{"false", false}, {"true", true}})
           .IntoKey(Map::InitializeAppImageClasses)
 
+      .Define("--assume-closed-class-hierarchy=_")
+          .template WithType<bool>()
+          .WithValueMap({{"false", false}, {"true", true}})
+          .WithHelp("If true, the compiler devirtualizes calls to app methods that have no\n"
+                    "override in the loaded class hierarchy. The oat file records these\n"
+                    "assumptions and the runtime stops using the dependent compiled code when\n"
+                    "a class loaded later invalidates them.")
+          .IntoKey(Map::AssumeClosedClassHierarchy)
+
       .Define("--verbose-methods=_")
           .template WithType<ParseStringList<','>>()
           .WithHelp("Restrict the dumped CFG data to methods whose name is listed.\n"
@@ -197,7 +197,9 @@ bool JitCompiler::CompileMethod(
                                       ? "Compiling OSR"
                                       : compilation_kind == CompilationKind::kOptimized
                                           ? "Compiling optimized"
-                                          : "Compiling baseline",
+                                          : compilation_kind == CompilationKind::kBaselinePlus
+                                              ? "Compiling baseline-plus"
+                                              : "Compiling baseline",
                                   &logger);
     JitCodeCache* const code_cache = jit->GetCodeCache();
     metrics::AutoTimer timer{runtime->GetMetrics()->JitMethodCompileTotalTime()};
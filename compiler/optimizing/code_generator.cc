@@ -296,7 +296,13 @@ void CodeGenerator::Compile() {
                                    GetGraph()->GetNumberOfVRegs(),
                                    GetGraph()->IsCompilingBaseline(),
                                    GetGraph()->IsDebuggable(),
-                                   GetGraph()->HasShouldDeoptimizeFlag());
+                                   GetGraph()->HasShouldDeoptimizeFlag(),
+                                   GetGraph()->IsCompilingBaselinePlus());
+  if (!GetCompilerOptions().IsJitCompiler()) {
+    // The JIT registers these with the code cache instead, see `JitCodeCache::Commit`.
+    GetStackMapStream()->AddCHADependencies(
+        GetGraph()->GetCHASingleImplementationList(), &graph_->GetDexFile(), this);
+  }
 
   size_t frame_start = GetAssembler()->CodeSize();
   GenerateFrameEntry();
@@ -1796,6 +1802,9 @@ void CodeGenerator::EmitJitRoots(uint8_t* code,
 }
 
 QuickEntrypointEnum CodeGenerator::GetArrayAllocationEntrypoint(HNewArray* new_array) {
+  if (new_array->IsPretenured()) {
+    return kQuickAllocArrayNonMoving;
+  }
   switch (new_array->GetComponentSizeShift()) {
     case 0: return kQuickAllocArrayResolved8;
     case 1: return kQuickAllocArrayResolved16;
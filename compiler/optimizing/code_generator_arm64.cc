@@ -4603,12 +4603,17 @@ void CodeGeneratorARM64::MaybeGenerateInlineCacheCheck(HInstruction* instruction
     DCHECK(info != nullptr);
     InlineCache* cache = info->GetInlineCache(instruction->GetDexPc());
     uint64_t address = reinterpret_cast64<uint64_t>(cache);
-    vixl::aarch64::Label done;
+    vixl::aarch64::Label update, done;
     __ Mov(x8, address);
     __ Ldr(w9, MemOperand(x8, InlineCache::ClassesOffset().Int32Value()));
     // Fast path for a monomorphic cache.
     __ Cmp(klass.W(), w9);
-    __ B(eq, &done);
+    __ B(ne, &update);
+    __ Ldr(w9, MemOperand(x8, InlineCache::CountsOffset().Int32Value()));
+    __ Add(w9, w9, 1);
+    __ Str(w9, MemOperand(x8, InlineCache::CountsOffset().Int32Value()));
+    __ B(&done);
+    __ Bind(&update);
     InvokeRuntime(kQuickUpdateInlineCache, instruction, instruction->GetDexPc());
     __ Bind(&done);
   }
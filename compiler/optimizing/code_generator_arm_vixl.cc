@@ -3694,14 +3694,19 @@ void CodeGeneratorARMVIXL::MaybeGenerateInlineCacheCheck(HInstruction* instructi
     DCHECK(info != nullptr);
     InlineCache* cache = info->GetInlineCache(instruction->GetDexPc());
     uint32_t address = reinterpret_cast32<uint32_t>(cache);
-    vixl32::Label done;
+    vixl32::Label update, done;
     UseScratchRegisterScope temps(GetVIXLAssembler());
     temps.Exclude(ip);
     __ Mov(r4, address);
     __ Ldr(ip, MemOperand(r4, InlineCache::ClassesOffset().Int32Value()));
     // Fast path for a monomorphic cache.
     __ Cmp(klass, ip);
-    __ B(eq, &done, /* is_far_target= */ false);
+    __ B(ne, &update, /* is_far_target= */ false);
+    __ Ldr(ip, MemOperand(r4, InlineCache::CountsOffset().Int32Value()));
+    __ Add(ip, ip, 1);
+    __ Str(ip, MemOperand(r4, InlineCache::CountsOffset().Int32Value()));
+    __ B(&done);
+    __ Bind(&update);
     InvokeRuntime(kQuickUpdateInlineCache, instruction, instruction->GetDexPc());
     __ Bind(&done);
   }
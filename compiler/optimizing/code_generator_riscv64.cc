@@ -6737,13 +6737,19 @@ void CodeGeneratorRISCV64::MaybeGenerateInlineCacheCheck(HInstruction* instructi
     srs.ExcludeXRegister(ic_reg);
     DCHECK_EQ(srs.AvailableXRegisters(), 1u);
     __ LoadConst64(ic_reg, address);
+    Riscv64Label update;
     {
       ScratchRegisterScope srs2(GetAssembler());
       XRegister tmp = srs2.AllocateXRegister();
       __ Loadd(tmp, ic_reg, InlineCache::ClassesOffset().Int32Value());
       // Fast path for a monomorphic cache.
-      __ Beq(klass, tmp, &done);
+      __ Bne(klass, tmp, &update);
+      __ Loadwu(tmp, ic_reg, InlineCache::CountsOffset().Int32Value());
+      __ Addiw(tmp, tmp, 1);
+      __ Storew(tmp, ic_reg, InlineCache::CountsOffset().Int32Value());
+      __ J(&done);
     }
+    __ Bind(&update);
     InvokeRuntime(kQuickUpdateInlineCache, instruction, instruction->GetDexPc());
     __ Bind(&done);
   }
@@ -3103,11 +3103,14 @@ void CodeGeneratorX86_64::MaybeGenerateInlineCacheCheck(HInstruction* instructio
     DCHECK(info != nullptr);
     InlineCache* cache = info->GetInlineCache(instruction->GetDexPc());
     uint64_t address = reinterpret_cast64<uint64_t>(cache);
-    NearLabel done;
+    NearLabel update, done;
     __ movq(CpuRegister(TMP), Immediate(address));
     // Fast path for a monomorphic cache.
     __ cmpl(Address(CpuRegister(TMP), InlineCache::ClassesOffset().Int32Value()), klass);
-    __ j(kEqual, &done);
+    __ j(kNotEqual, &update);
+    __ addl(Address(CpuRegister(TMP), InlineCache::CountsOffset().Int32Value()), Immediate(1));
+    __ jmp(&done);
+    __ Bind(&update);
     GenerateInvokeRuntime(
         GetThreadOffset<kX86_64PointerSize>(kQuickUpdateInlineCache).Int32Value());
     __ Bind(&done);
@@ -919,6 +919,40 @@ void GraphChecker::VisitInstanceOf(HInstanceOf* instruction) {
   HandleTypeCheckInstruction(instruction);
 }
 
+void GraphChecker::HandleInstanceFieldAccess(HInstruction* instruction) {
+  // Passes that scalar replace objects (LSE, partial escape analysis) rewrite the object and
+  // value inputs of field accesses, so make sure they still have the expected types.
+  HInstruction* object = instruction->InputAt(0);
+  if (object->GetType() != DataType::Type::kReference) {
+    AddError(StringPrintf("%s %d has a non-reference object input %s:%d of type %s.",
+                          instruction->DebugName(),
+                          instruction->GetId(),
+                          object->DebugName(),
+                          object->GetId(),
+                          DataType::PrettyDescriptor(object->GetType())));
+  }
+}
+
+void GraphChecker::VisitInstanceFieldGet(HInstanceFieldGet* instruction) {
+  VisitInstruction(instruction);
+  HandleInstanceFieldAccess(instruction);
+}
+
+void GraphChecker::VisitInstanceFieldSet(HInstanceFieldSet* instruction) {
+  VisitInstruction(instruction);
+  HandleInstanceFieldAccess(instruction);
+  HInstruction* value = instruction->GetValue();
+  if (instruction->GetFieldType() == DataType::Type::kReference &&
+      value->GetType() != DataType::Type::kReference) {
+    AddError(StringPrintf("%s %d stores %s:%d of type %s into a reference field.",
+                          instruction->DebugName(),
+                          instruction->GetId(),
+                          value->DebugName(),
+                          value->GetId(),
+                          DataType::PrettyDescriptor(value->GetType())));
+  }
+}
+
 void GraphChecker::HandleLoop(HBasicBlock* loop_header) {
   int id = loop_header->GetBlockId();
   HLoopInformation* loop_information = loop_header->GetLoopInformation();
@@ -68,6 +68,8 @@ class GraphChecker : public HGraphDelegateVisitor {
   void VisitConstant(HConstant* instruction) override;
   void VisitDeoptimize(HDeoptimize* instruction) override;
   void VisitIf(HIf* instruction) override;
+  void VisitInstanceFieldGet(HInstanceFieldGet* instruction) override;
+  void VisitInstanceFieldSet(HInstanceFieldSet* instruction) override;
   void VisitInstanceOf(HInstanceOf* check) override;
   void VisitInvoke(HInvoke* invoke) override;
   void VisitInvokeStaticOrDirect(HInvokeStaticOrDirect* invoke) override;
@@ -92,6 +94,7 @@ class GraphChecker : public HGraphDelegateVisitor {
   void HandleTypeCheckInstruction(HTypeCheckInstruction* instruction);
   void HandleLoop(HBasicBlock* loop_header);
   void HandleBooleanInput(HInstruction* instruction, size_t input_index);
+  void HandleInstanceFieldAccess(HInstruction* instruction);
 
   // Was the last visit of the graph valid?
   bool IsValid() const {
@@ -127,6 +127,30 @@ TEST_F(GraphCheckerTest, BlockEndingWithNonBranchInstruction) {
   ASSERT_FALSE(graph_checker.IsValid());
 }
 
+// Test case with an invalid graph storing an int into a reference field.
+TEST_F(GraphCheckerTest, InstanceFieldSetOfWrongType) {
+  HGraph* graph = CreateSimpleCFG();
+  HBasicBlock* entry_block = graph->GetEntryBlock();
+  HInstruction* object = new (GetAllocator()) HParameterValue(
+      graph->GetDexFile(), dex::TypeIndex(0), 0, DataType::Type::kReference);
+  entry_block->InsertInstructionBefore(object, entry_block->GetLastInstruction());
+  HInstruction* store = new (GetAllocator()) HInstanceFieldSet(object,
+                                                               graph->GetIntConstant(1),
+                                                               /* field= */ nullptr,
+                                                               DataType::Type::kReference,
+                                                               MemberOffset(32),
+                                                               /* is_volatile= */ false,
+                                                               /* field_idx= */ 0,
+                                                               /* declaring_class_def_index= */ 0,
+                                                               graph->GetDexFile(),
+                                                               /* dex_pc= */ 0);
+  entry_block->InsertInstructionBefore(store, entry_block->GetLastInstruction());
+
+  GraphChecker graph_checker(graph);
+  graph_checker.Run();
+  ASSERT_FALSE(graph_checker.IsValid());
+}
+
 TEST_F(GraphCheckerTest, SSAPhi) {
   // This code creates one Phi function during the conversion to SSA form.
   const std::vector<uint16_t> data = ONE_REGISTER_CODE_ITEM(
@@ -16,6 +16,9 @@
 
 #include "inliner.h"
 
+#include <array>
+#include <numeric>
+
 #include "art_method-inl.h"
 #include "base/enums.h"
 #include "base/logging.h"
@@ -69,6 +72,28 @@ static constexpr size_t kMaximumNumberOfRecursiveCalls = 4;
 // recursive calls at all.
 static constexpr size_t kMaximumNumberOfPolymorphicRecursiveCalls = 0;
 
+// Weight of a call site executed once per invocation of the method. Call sites are visited in
+// decreasing order of weight, so that the instruction budget is spent on the hottest first.
+static constexpr uint64_t kCallSiteBaseWeight = 1u << 16;
+
+// Each enclosing loop multiplies the weight of a call site by this factor, up to
+// kMaximumLoopDepthForCallSiteWeight loops.
+static constexpr uint64_t kCallSiteLoopWeightFactor = 8;
+static constexpr size_t kMaximumLoopDepthForCallSiteWeight = 4;
+
+// Factor applied to the weight of a call site whose callee is hot in the AOT profile.
+static constexpr uint64_t kCallSiteHotCalleeWeightFactor = 4;
+
+// Minimum number of calls recorded in a megamorphic inline cache before we look for
+// dominant receivers.
+static constexpr uint64_t kMegamorphicMinimumNumberOfCalls = 64;
+
+// Maximum number of receivers of a megamorphic call that we inline, and the minimum share
+// of the recorded calls that each of them and all of them together must cover.
+static constexpr size_t kMaximumNumberOfMegamorphicTargets = 3;
+static constexpr uint64_t kMegamorphicMinimumTargetPercent = 10;
+static constexpr uint64_t kMegamorphicMinimumCoveragePercent = 80;
+
 // Controls the use of inline caches in AOT mode.
 static constexpr bool kUseAOTInlineCaches = true;
 
@@ -166,40 +191,61 @@ bool HInliner::Run() {
   const bool honor_inline_directives =
       honor_noinline_directives && Runtime::Current()->IsAotCompiler();
 
-  // Keep a copy of all blocks when starting the visit.
-  ArenaVector<HBasicBlock*> blocks = graph_->GetReversePostOrder();
-  DCHECK(!blocks.empty());
-  // Because we are changing the graph when inlining,
-  // we just iterate over the blocks of the outer method.
-  // This avoids doing the inlining work again on the inlined blocks.
-  for (HBasicBlock* block : blocks) {
-    for (HInstruction* instruction = block->GetFirstInstruction(); instruction != nullptr;) {
-      HInstruction* next = instruction->GetNext();
-      HInvoke* call = instruction->AsInvokeOrNull();
+  // Collect the call sites of the outer method before visiting them. Because we are changing
+  // the graph when inlining, we only consider the invokes of the outer method. This avoids doing
+  // the inlining work again on the inlined blocks.
+  ArenaVector<CallSite> call_sites(graph_->GetAllocator()->Adapter(kArenaAllocOptimization));
+  for (HBasicBlock* block : graph_->GetReversePostOrder()) {
+    for (HInstructionIterator it(block->GetInstructions()); !it.Done(); it.Advance()) {
+      HInvoke* call = it.Current()->AsInvokeOrNull();
       // As long as the call is not intrinsified, it is worth trying to inline.
       if (call != nullptr && !codegen_->IsImplementedIntrinsic(call)) {
-        if (honor_noinline_directives) {
-          // Debugging case: directives in method names control or assert on inlining.
-          std::string callee_name =
-              call->GetMethodReference().PrettyMethod(/* with_signature= */ false);
-          // Tests prevent inlining by having $noinline$ in their method names.
-          if (callee_name.find("$noinline$") == std::string::npos) {
-            if (TryInline(call)) {
-              did_inline = true;
-            } else if (honor_inline_directives) {
-              bool should_have_inlined = (callee_name.find("$inline$") != std::string::npos);
-              CHECK(!should_have_inlined) << "Could not inline " << callee_name;
-            }
-          }
-        } else {
-          DCHECK(!honor_inline_directives);
-          // Normal case: try to inline.
-          if (TryInline(call)) {
-            did_inline = true;
-          }
+        call_sites.push_back({call, ComputeCallSiteWeight(call)});
+      }
+    }
+  }
+  // Visit the hottest call sites first, so that they get the inlining budget. Call sites of
+  // equal weight keep their reverse post order.
+  std::stable_sort(call_sites.begin(),
+                   call_sites.end(),
+                   [](const CallSite& lhs, const CallSite& rhs) {
+                     return lhs.weight > rhs.weight;
+                   });
+
+  for (const CallSite& call_site : call_sites) {
+    HInvoke* call = call_site.invoke;
+    if (call->GetBlock() == nullptr) {
+      continue;  // Removed while inlining another call site.
+    }
+    const bool is_cold = (call_site.weight == 0u);
+    if (is_cold) {
+      // The profile shows that this call site has not been reached: only inline small methods.
+      LOG_NOTE() << "Cold call site " << call->GetMethodReference().PrettyMethod();
+      MaybeRecordStat(stats_, MethodCompilationStat::kColdCallSite);
+      inlining_budget_ = std::min(inlining_budget_, kMaximumNumberOfInstructionsForSmallMethod);
+    }
+    if (honor_noinline_directives) {
+      // Debugging case: directives in method names control or assert on inlining.
+      std::string callee_name =
+          call->GetMethodReference().PrettyMethod(/* with_signature= */ false);
+      // Tests prevent inlining by having $noinline$ in their method names.
+      if (callee_name.find("$noinline$") == std::string::npos) {
+        if (TryInline(call)) {
+          did_inline = true;
+        } else if (honor_inline_directives) {
+          bool should_have_inlined = (callee_name.find("$inline$") != std::string::npos);
+          CHECK(!should_have_inlined) << "Could not inline " << callee_name;
         }
       }
-      instruction = next;
+    } else {
+      DCHECK(!honor_inline_directives);
+      // Normal case: try to inline.
+      if (TryInline(call)) {
+        did_inline = true;
+      }
+    }
+    if (is_cold) {
+      UpdateInliningBudget();
     }
   }
 
@@ -218,6 +264,71 @@ bool HInliner::Run() {
   return did_inline || graph_->HasAlwaysThrowingInvokes();
 }
 
+uint64_t HInliner::ComputeCallSiteWeight(HInvoke* invoke_instruction) const {
+  HBasicBlock* call_block = invoke_instruction->GetBlock();
+  uint64_t weight = kCallSiteBaseWeight;
+  size_t loop_depth = 0;
+  for (HLoopInformation* loop_info = call_block->GetLoopInformation();
+       loop_info != nullptr && loop_depth < kMaximumLoopDepthForCallSiteWeight;
+       loop_info = loop_info->GetPreHeader()->GetLoopInformation()) {
+    weight *= kCallSiteLoopWeightFactor;
+    ++loop_depth;
+  }
+
+  // JIT: scale the weight by the probability of the profiled branches leading to the call.
+  ProfilingInfo* profiling_info = graph_->GetProfilingInfo();
+  if (profiling_info != nullptr) {
+    for (HBasicBlock* block = call_block;
+         block->GetDominator() != nullptr && weight != 0u;
+         block = block->GetDominator()) {
+      HIf* hif = block->GetDominator()->GetLastInstruction()->AsIfOrNull();
+      if (hif == nullptr) {
+        continue;
+      }
+      BranchCache* cache = profiling_info->GetBranchCache(hif->GetDexPc());
+      if (cache == nullptr || cache->GetExecutionCount() == 0u) {
+        continue;
+      }
+      uint64_t taken;
+      if (hif->IfTrueSuccessor()->Dominates(block)) {
+        taken = cache->GetTrue();
+      } else if (hif->IfFalseSuccessor()->Dominates(block)) {
+        taken = cache->GetFalse();
+      } else {
+        continue;
+      }
+      weight = (taken == 0u)
+          ? 0u
+          : std::max<uint64_t>(1u, weight * taken / cache->GetExecutionCount());
+    }
+    return weight;
+  }
+
+  // AOT: a virtual or interface call site without an inline cache in a hot method that has
+  // inline caches for other call sites was not reached while profiling. Profiles that record no
+  // inline caches for the method say nothing about its call sites. Calls to hot methods are
+  // favored.
+  const ProfileCompilationInfo* pci = codegen_->GetCompilerOptions().GetProfileCompilationInfo();
+  if (pci != nullptr) {
+    ProfileCompilationInfo::MethodHotness caller_hotness = pci->GetMethodHotness(MethodReference(
+        caller_compilation_unit_.GetDexFile(), caller_compilation_unit_.GetDexMethodIndex()));
+    if (caller_hotness.IsHot() &&
+        (invoke_instruction->IsInvokeVirtual() || invoke_instruction->IsInvokeInterface())) {
+      const ProfileCompilationInfo::InlineCacheMap* inline_caches =
+          caller_hotness.GetInlineCacheMap();
+      DCHECK(inline_caches != nullptr);
+      if (!inline_caches->empty() &&
+          inline_caches->find(invoke_instruction->GetDexPc()) == inline_caches->end()) {
+        return 0u;
+      }
+    }
+    if (pci->GetMethodHotness(invoke_instruction->GetMethodReference()).IsHot()) {
+      weight *= kCallSiteHotCalleeWeightFactor;
+    }
+  }
+  return weight;
+}
+
 static bool IsMethodOrDeclaringClassFinal(ArtMethod* method)
     REQUIRES_SHARED(Locks::mutator_lock_) {
   return method->IsFinal() || method->GetDeclaringClass()->IsFinal();
@@ -366,8 +477,18 @@ ArtMethod* HInliner::FindMethodFromCHA(ArtMethod* resolved_method) {
     return nullptr;
   }
   if (Runtime::Current()->IsAotCompiler()) {
-    // No CHA-based devirtulization for AOT compiler (yet).
-    return nullptr;
+    const CompilerOptions& compiler_options = codegen_->GetCompilerOptions();
+    if (!compiler_options.AssumeClosedClassHierarchy()) {
+      // No CHA-based devirtulization for AOT compiler unless requested.
+      return nullptr;
+    }
+    // The runtime can only map an invalidated assumption back to the AOT code relying on it
+    // for a concrete method of the dex files we compile, which is its own single implementation.
+    if (resolved_method->IsAbstract() ||
+        resolved_method->GetDeclaringClass()->IsInterface() ||
+        !compiler_options.WithinOatFile(resolved_method->GetDexFile())) {
+      return nullptr;
+    }
   }
   if (Runtime::Current()->IsZygote()) {
     // No CHA-based devirtulization for Zygote, as it compiles with
@@ -383,6 +504,9 @@ ArtMethod* HInliner::FindMethodFromCHA(ArtMethod* resolved_method) {
   if (single_impl == nullptr) {
     return nullptr;
   }
+  if (Runtime::Current()->IsAotCompiler() && single_impl != resolved_method) {
+    return nullptr;
+  }
   if (single_impl->IsProxyMethod()) {
     // Proxy method is a generic invoker that's not worth
     // devirtualizing/inlining. It also causes issues when the proxy
@@ -481,6 +605,13 @@ bool HInliner::TryInline(HInvoke* invoke_instruction) {
       ? invoke_instruction->GetResolvedMethod()
       : FindVirtualOrInterfaceTarget(invoke_instruction);
 
+  if (graph_->IsCompilingBaselinePlus()) {
+    // Baseline-plus code keeps profiling the calls it does not replace with a trivial pattern,
+    // so we do not speculate on the targets of virtual and interface calls.
+    return actual_method != nullptr &&
+           TryReplaceWithSimplePattern(invoke_instruction, actual_method);
+  }
+
   if (actual_method != nullptr) {
     // Single target.
     bool result = TryInlineAndReplace(invoke_instruction,
@@ -595,12 +726,14 @@ bool HInliner::TryInlineFromInlineCache(HInvoke* invoke_instruction)
   }
 
   StackHandleScope<InlineCache::kIndividualCacheSize> classes(Thread::Current());
+  // Only the runtime inline caches record the number of calls for each class.
+  uint32_t counts[InlineCache::kIndividualCacheSize] = {};
   // The Zygote JIT compiles based on a profile, so we shouldn't use runtime inline caches
   // for it.
   InlineCacheType inline_cache_type =
       (Runtime::Current()->IsAotCompiler() || Runtime::Current()->IsZygote())
           ? GetInlineCacheAOT(invoke_instruction, &classes)
-          : GetInlineCacheJIT(invoke_instruction, &classes);
+          : GetInlineCacheJIT(invoke_instruction, &classes, counts);
 
   switch (inline_cache_type) {
     case kInlineCacheNoData: {
@@ -633,11 +766,14 @@ bool HInliner::TryInlineFromInlineCache(HInvoke* invoke_instruction)
     }
 
     case kInlineCacheMegamorphic: {
+      MaybeRecordStat(stats_, MethodCompilationStat::kMegamorphicCall);
+      if (TryInlineMegamorphicCall(invoke_instruction, classes, counts)) {
+        return true;
+      }
       LOG_FAIL_NO_STAT()
           << "Interface or virtual call to "
           << invoke_instruction->GetMethodReference().PrettyMethod()
           << " is megamorphic and not inlined";
-      MaybeRecordStat(stats_, MethodCompilationStat::kMegamorphicCall);
       return false;
     }
 
@@ -654,7 +790,8 @@ bool HInliner::TryInlineFromInlineCache(HInvoke* invoke_instruction)
 
 HInliner::InlineCacheType HInliner::GetInlineCacheJIT(
     HInvoke* invoke_instruction,
-    /*out*/StackHandleScope<InlineCache::kIndividualCacheSize>* classes) {
+    /*out*/StackHandleScope<InlineCache::kIndividualCacheSize>* classes,
+    /*out*/uint32_t* counts) {
   DCHECK(codegen_->GetCompilerOptions().IsJitCompiler());
 
   ArtMethod* caller = graph_->GetArtMethod();
@@ -667,7 +804,8 @@ HInliner::InlineCacheType HInliner::GetInlineCacheJIT(
 
   Runtime::Current()->GetJit()->GetCodeCache()->CopyInlineCacheInto(
       *profiling_info->GetInlineCache(invoke_instruction->GetDexPc()),
-      classes);
+      classes,
+      counts);
   return GetInlineCacheType(*classes);
 }
 
@@ -957,13 +1095,29 @@ static void MaybeReplaceAndRemove(HInstruction* new_instruction, HInstruction* o
   old_instruction->GetBlock()->RemoveInstruction(old_instruction);
 }
 
+bool HInliner::TryReplaceWithSimplePattern(HInvoke* invoke_instruction, ArtMethod* method) {
+  HInstruction* return_replacement = nullptr;
+  if (!TryPatternSubstitution(invoke_instruction, method, &return_replacement)) {
+    LOG_FAIL_NO_STAT() << "Method " << method->PrettyMethod() << " is not a simple pattern";
+    return false;
+  }
+  LOG_SUCCESS() << "Successfully replaced pattern of invoke " << method->PrettyMethod();
+  MaybeRecordStat(stats_, MethodCompilationStat::kReplacedInvokeWithSimplePattern);
+  MaybeReplaceAndRemove(return_replacement, invoke_instruction);
+  FixUpReturnReferenceType(method, return_replacement);
+  MaybeRunReferenceTypePropagation(return_replacement, invoke_instruction);
+  return true;
+}
+
 bool HInliner::TryInlinePolymorphicCall(
     HInvoke* invoke_instruction,
-    const StackHandleScope<InlineCache::kIndividualCacheSize>& classes) {
+    const StackHandleScope<InlineCache::kIndividualCacheSize>& classes,
+    bool is_megamorphic) {
   DCHECK(invoke_instruction->IsInvokeVirtual() || invoke_instruction->IsInvokeInterface())
       << invoke_instruction->DebugName();
 
-  if (TryInlinePolymorphicCallToSameTarget(invoke_instruction, classes)) {
+  // Receivers of a megamorphic call not in `classes` may call a different method.
+  if (!is_megamorphic && TryInlinePolymorphicCallToSameTarget(invoke_instruction, classes)) {
     return true;
   }
 
@@ -996,7 +1150,7 @@ bool HInliner::TryInlinePolymorphicCall(
 
     // In monomorphic cases when UseOnlyPolymorphicInliningWithNoDeopt() is true, we call
     // `TryInlinePolymorphicCall` even though we are monomorphic.
-    const bool actually_monomorphic = number_of_types == 1;
+    const bool actually_monomorphic = !is_megamorphic && number_of_types == 1;
     DCHECK_IMPLIES(actually_monomorphic, UseOnlyPolymorphicInliningWithNoDeopt());
 
     // We only want to limit recursive polymorphic cases, not monomorphic ones.
@@ -1029,6 +1183,7 @@ bool HInliner::TryInlinePolymorphicCall(
       // If we have inlined all targets before, and this receiver is the last seen,
       // we deoptimize instead of keeping the original invoke instruction.
       bool deoptimize = !UseOnlyPolymorphicInliningWithNoDeopt() &&
+          !is_megamorphic &&
           all_targets_inlined &&
           (i + 1 == number_of_types);
 
@@ -1055,7 +1210,9 @@ bool HInliner::TryInlinePolymorphicCall(
     return false;
   }
 
-  MaybeRecordStat(stats_, MethodCompilationStat::kInlinedPolymorphicCall);
+  MaybeRecordStat(stats_,
+                  is_megamorphic ? MethodCompilationStat::kInlinedMegamorphicCall
+                                 : MethodCompilationStat::kInlinedPolymorphicCall);
 
   // Run type propagation to get the guards typed.
   ReferenceTypePropagation rtp_fixup(graph_,
@@ -1065,6 +1222,54 @@ bool HInliner::TryInlinePolymorphicCall(
   return true;
 }
 
+bool HInliner::TryInlineMegamorphicCall(
+    HInvoke* invoke_instruction,
+    const StackHandleScope<InlineCache::kIndividualCacheSize>& classes,
+    const uint32_t* counts) {
+  if (classes.Size() != InlineCache::kIndividualCacheSize) {
+    // Profile-based inline caches do not record the receivers of megamorphic calls.
+    return false;
+  }
+  uint64_t total_calls = 0u;
+  for (size_t i = 0; i != InlineCache::kIndividualCacheSize; ++i) {
+    total_calls += counts[i];
+  }
+  if (total_calls < kMegamorphicMinimumNumberOfCalls) {
+    // No counts (AOT profile) or not enough calls seen to find dominant receivers.
+    return false;
+  }
+
+  // The last entry of a megamorphic inline cache is shared by all the receivers that
+  // did not fit in the other entries, so it is not a candidate target.
+  std::array<size_t, InlineCache::kIndividualCacheSize - 1u> order;
+  std::iota(order.begin(), order.end(), 0u);
+  std::stable_sort(order.begin(), order.end(), [counts](size_t lhs, size_t rhs) {
+    return counts[lhs] > counts[rhs];
+  });
+
+  StackHandleScope<InlineCache::kIndividualCacheSize> dominant_classes(Thread::Current());
+  uint64_t covered_calls = 0u;
+  for (size_t index : order) {
+    if (dominant_classes.Size() == kMaximumNumberOfMegamorphicTargets ||
+        uint64_t{counts[index]} * 100u < total_calls * kMegamorphicMinimumTargetPercent) {
+      break;
+    }
+    dominant_classes.NewHandle(classes.GetReference(index)->AsClass());
+    covered_calls += counts[index];
+  }
+  if (covered_calls * 100u < total_calls * kMegamorphicMinimumCoveragePercent) {
+    LOG_FAIL_NO_STAT()
+        << "Megamorphic call to " << invoke_instruction->GetMethodReference().PrettyMethod()
+        << " has no dominant receivers: " << covered_calls << " of " << total_calls
+        << " calls covered";
+    return false;
+  }
+  LOG_NOTE() << "Megamorphic call to " << invoke_instruction->GetMethodReference().PrettyMethod()
+             << " has " << dominant_classes.Size() << " dominant receivers covering "
+             << covered_calls << " of " << total_calls << " calls";
+  return TryInlinePolymorphicCall(invoke_instruction, dominant_classes, /* is_megamorphic= */ true);
+}
+
 void HInliner::CreateDiamondPatternForPolymorphicInline(HInstruction* compare,
                                                         HInstruction* return_replacement,
                                                         HInstruction* invoke_instruction) {
@@ -73,8 +73,24 @@ class HInliner : public HOptimization {
     kInlineCacheMissingTypes = 5
   };
 
+  // A call site of the graph being compiled, with its estimated relative execution weight.
+  struct CallSite {
+    HInvoke* invoke;
+    uint64_t weight;
+  };
+
+  // Estimate how often `invoke_instruction` executes relative to the entry of the graph, from
+  // its loop depth, the branch profile (JIT) and the method profile (AOT). A weight of zero
+  // means the profile shows that the call site has not been reached.
+  uint64_t ComputeCallSiteWeight(HInvoke* invoke_instruction) const;
+
   bool TryInline(HInvoke* invoke_instruction);
 
+  // Replace `invoke_instruction` with the simple pattern (getter, setter, constant, ...) that
+  // `method` implements, if any. Used when only trivial methods should be inlined.
+  bool TryReplaceWithSimplePattern(HInvoke* invoke_instruction, ArtMethod* method)
+    REQUIRES_SHARED(Locks::mutator_lock_);
+
   // Try to inline `resolved_method` in place of `invoke_instruction`. `do_rtp` is whether
   // reference type propagation can run after the inlining. If the inlining is successful, this
   // method will replace and remove the `invoke_instruction`.
@@ -182,10 +198,12 @@ class HInliner : public HOptimization {
 
   // Try getting the inline cache from JIT code cache.
   // Return true if the inline cache was successfully allocated and the
-  // invoke info was found in the profile info.
+  // invoke info was found in the profile info. If `counts` is not null, it
+  // receives the number of calls seen for each of the classes.
   InlineCacheType GetInlineCacheJIT(
       HInvoke* invoke_instruction,
-      /*out*/StackHandleScope<InlineCache::kIndividualCacheSize>* classes)
+      /*out*/StackHandleScope<InlineCache::kIndividualCacheSize>* classes,
+      /*out*/uint32_t* counts = nullptr)
     REQUIRES_SHARED(Locks::mutator_lock_);
 
   // Try getting the inline cache from AOT offline profile.
@@ -209,9 +227,19 @@ class HInliner : public HOptimization {
                                 const StackHandleScope<InlineCache::kIndividualCacheSize>& classes)
     REQUIRES_SHARED(Locks::mutator_lock_);
 
-  // Try to inline targets of a polymorphic call.
+  // Try to inline targets of a polymorphic call. For a megamorphic call, `classes` only
+  // holds some of the receivers seen, so the original invoke is always kept as fallback.
   bool TryInlinePolymorphicCall(HInvoke* invoke_instruction,
-                                const StackHandleScope<InlineCache::kIndividualCacheSize>& classes)
+                                const StackHandleScope<InlineCache::kIndividualCacheSize>& classes,
+                                bool is_megamorphic = false)
+    REQUIRES_SHARED(Locks::mutator_lock_);
+
+  // Try to inline the dominant targets of a megamorphic call, as found from the number
+  // of calls seen for each class in `classes`, guarded by type checks with a virtual or
+  // interface call as fallback.
+  bool TryInlineMegamorphicCall(HInvoke* invoke_instruction,
+                                const StackHandleScope<InlineCache::kIndividualCacheSize>& classes,
+                                const uint32_t* counts)
     REQUIRES_SHARED(Locks::mutator_lock_);
 
   bool TryInlinePolymorphicCallToSameTarget(
@@ -33,6 +33,7 @@
 #include "intrinsics.h"
 #include "intrinsics_utils.h"
 #include "jit/jit.h"
+#include "jit/profiling_info.h"
 #include "mirror/dex_cache.h"
 #include "oat_file.h"
 #include "optimizing_compiler_stats.h"
@@ -1445,6 +1446,14 @@ HNewInstance* HInstructionBuilder::BuildNewInstance(dex::TypeIndex type_index, u
   if (!klass.IsNull() && klass->IsStringClass()) {
     entrypoint = kQuickAllocStringObject;
   }
+  // Only pretenure allocations of initialized classes which need no checks, as the
+  // non-moving entrypoint expects an initialized class. With an HClinitCheck, the check
+  // may later be merged into the allocation, which then needs the resolved entrypoint.
+  if (cls == load_class &&
+      entrypoint == kQuickAllocObjectInitialized &&
+      ShouldPretenureAllocation(dex_pc)) {
+    entrypoint = kQuickAllocObjectNonMoving;
+  }
 
   // Consider classes we haven't resolved as potentially finalizable.
   bool finalizable = (klass == nullptr) || klass->IsFinalizable();
@@ -2427,10 +2436,24 @@ HNewArray* HInstructionBuilder::BuildNewArray(uint32_t dex_pc,
   size_t component_type_shift = Primitive::ComponentSizeShift(Primitive::GetType(descriptor[1]));
 
   HNewArray* new_array = new (allocator_) HNewArray(cls, length, dex_pc, component_type_shift);
+  if (ShouldPretenureAllocation(dex_pc)) {
+    new_array->SetPretenured();
+  }
   AppendInstruction(new_array);
   return new_array;
 }
 
+bool HInstructionBuilder::ShouldPretenureAllocation(uint32_t dex_pc) const {
+  // Allocation sites are only profiled for JIT compilation. Only the graph of the
+  // method being compiled has a profiling info, so inlined allocations are not pretenured.
+  ProfilingInfo* info = graph_->GetProfilingInfo();
+  if (info == nullptr) {
+    return false;
+  }
+  AllocationSiteCache* cache = info->GetAllocationSiteCache(dex_pc);
+  return cache != nullptr && cache->ShouldPretenure();
+}
+
 HNewArray* HInstructionBuilder::BuildFilledNewArray(uint32_t dex_pc,
                                                     dex::TypeIndex type_index,
                                                     const InstructionOperands& operands) {
@@ -286,6 +286,10 @@ class HInstructionBuilder : public ValueObject {
   bool IsInitialized(ObjPtr<mirror::Class> cls) const
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Return whether the runtime found the objects allocated at `dex_pc` to be
+  // long-lived, in which case we allocate them directly in the non-moving space.
+  bool ShouldPretenureAllocation(uint32_t dex_pc) const;
+
   // Try to resolve a field using the class linker. Return null if it could not
   // be found.
   ArtField* ResolveField(uint16_t field_idx, bool is_static, bool is_put);
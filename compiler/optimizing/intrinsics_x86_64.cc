@@ -1267,6 +1267,12 @@ void IntrinsicLocationsBuilderX86_64::VisitStringEquals(HInvoke* invoke) {
 
   // Set output, RSI needed for repe_cmpsq instruction anyways.
   locations->SetOut(Location::RegisterLocation(RSI), Location::kOutputOverlap);
+
+  if (codegen_->GetInstructionSetFeatures().HasSSE4_1()) {
+    // Compare 16 bytes at a time instead of using repe_cmpsq.
+    locations->AddTemp(Location::RequiresFpuRegister());
+    locations->AddTemp(Location::RequiresFpuRegister());
+  }
 }
 
 void IntrinsicCodeGeneratorX86_64::VisitStringEquals(HInvoke* invoke) {
@@ -1355,10 +1361,38 @@ void IntrinsicCodeGeneratorX86_64::VisitStringEquals(HInvoke* invoke) {
   DCHECK_ALIGNED(value_offset, 8);
   static_assert(IsAligned<8>(kObjectAlignment), "String is not zero padded");
 
-  // Loop to compare strings four characters at a time starting at the beginning of the string.
-  __ repe_cmpsq();
-  // If strings are not equal, zero flag will be cleared.
-  __ j(kNotEqual, &return_false);
+  if (codegen_->GetInstructionSetFeatures().HasSSE4_1()) {
+    // The microcoded repe_cmpsq has a high startup cost, so compare 16 bytes at a time
+    // with SIMD instead and finish with a single 8-byte comparison if needed. This does not
+    // read past the zero padding of the string values.
+    XmmRegister lhs = locations->GetTemp(2).AsFpuRegister<XmmRegister>();
+    XmmRegister rhs = locations->GetTemp(3).AsFpuRegister<XmmRegister>();
+    NearLabel loop, tail;
+    __ cmpl(rcx, Immediate(2));
+    __ j(kLess, &tail);
+    __ Bind(&loop);
+    __ movdqu(lhs, Address(rsi, 0));
+    __ movdqu(rhs, Address(rdi, 0));
+    __ pxor(lhs, rhs);
+    __ ptest(lhs, lhs);
+    __ j(kNotZero, &return_false);
+    __ addq(rsi, Immediate(16));
+    __ addq(rdi, Immediate(16));
+    __ subl(rcx, Immediate(2));
+    __ cmpl(rcx, Immediate(2));
+    __ j(kGreaterEqual, &loop);
+    __ Bind(&tail);
+    __ testl(rcx, rcx);
+    __ j(kZero, &return_true);
+    __ movq(rcx, Address(rsi, 0));
+    __ cmpq(rcx, Address(rdi, 0));
+    __ j(kNotEqual, &return_false);
+  } else {
+    // Loop to compare strings four characters at a time starting at the beginning of the string.
+    __ repe_cmpsq();
+    // If strings are not equal, zero flag will be cleared.
+    __ j(kNotEqual, &return_false);
+  }
 
   // Return true and exit the function.
   // If loop does not result in returning false, we return true.
@@ -1374,6 +1408,7 @@ void IntrinsicCodeGeneratorX86_64::VisitStringEquals(HInvoke* invoke) {
 
 static void CreateStringIndexOfLocations(HInvoke* invoke,
                                          ArenaAllocator* allocator,
+                                         CodeGeneratorX86_64* codegen,
                                          bool start_at_zero) {
   LocationSummary* locations = new (allocator) LocationSummary(invoke,
                                                                LocationSummary::kCallOnSlowPath,
@@ -1395,6 +1430,67 @@ static void CreateStringIndexOfLocations(HInvoke* invoke,
   locations->AddTemp(Location::RegisterLocation(RCX));
   // Need another temporary to be able to compute the result.
   locations->AddTemp(Location::RequiresRegister());
+
+  if (codegen->GetInstructionSetFeatures().HasSSE4_1()) {
+    // Scan 16 bytes at a time before falling back to repne scasw for the tail.
+    locations->AddTemp(Location::RequiresRegister());
+    locations->AddTemp(Location::RequiresFpuRegister());
+    locations->AddTemp(Location::RequiresFpuRegister());
+  }
+}
+
+// Scans the string 16 bytes at a time for the char in `search_value` while at least
+// 16 bytes are left, then falls through to let repne scas handle the remaining chars.
+// The 16-byte loads never go past the last char. On a match, jumps to `found` with
+// `counter` as repne scas would leave it after the matching char.
+static void GenerateStringIndexOfVectorLoop(X86_64Assembler* assembler,
+                                            LocationSummary* locations,
+                                            bool compressed,
+                                            Label* found) {
+  CpuRegister data = locations->InAt(0).AsRegister<CpuRegister>();
+  CpuRegister search_value = locations->InAt(1).AsRegister<CpuRegister>();
+  CpuRegister counter = locations->GetTemp(0).AsRegister<CpuRegister>();
+  CpuRegister mask = locations->GetTemp(2).AsRegister<CpuRegister>();
+  XmmRegister needle = locations->GetTemp(3).AsFpuRegister<XmmRegister>();
+  XmmRegister chars = locations->GetTemp(4).AsFpuRegister<XmmRegister>();
+  const int32_t chars_per_vector = compressed ? 16 : 8;
+
+  // Broadcast the searched char to all lanes.
+  __ movd(needle, search_value, /* is64bit= */ false);
+  if (compressed) {
+    __ punpcklbw(needle, needle);
+  }
+  __ punpcklwd(needle, needle);
+  __ pshufd(needle, needle, Immediate(0));
+
+  NearLabel loop, match, tail;
+  __ Bind(&loop);
+  __ cmpl(counter, Immediate(chars_per_vector));
+  __ j(kLess, &tail);
+  __ movdqu(chars, Address(data, 0));
+  if (compressed) {
+    __ pcmpeqb(chars, needle);
+  } else {
+    __ pcmpeqw(chars, needle);
+  }
+  __ pmovmskb(mask, chars);
+  __ testl(mask, mask);
+  __ j(kNotZero, &match);
+  __ addq(data, Immediate(16));
+  __ subl(counter, Immediate(chars_per_vector));
+  __ jmp(&loop);
+
+  __ Bind(&match);
+  // The lowest set bit of the byte mask gives the offset of the first matching char.
+  __ bsfl(mask, mask);
+  if (!compressed) {
+    __ shrl(mask, Immediate(1));
+  }
+  __ subl(counter, mask);
+  __ subl(counter, Immediate(1));
+  __ jmp(found);
+
+  __ Bind(&tail);
 }
 
 static void GenerateStringIndexOf(HInvoke* invoke,
@@ -1450,6 +1546,10 @@ static void GenerateStringIndexOf(HInvoke* invoke,
   // Load the count field of the string containing the length and compression flag.
   __ movl(string_length, Address(string_obj, count_offset));
 
+  // Not a NearLabel, the vector loops may be far from the code computing the index.
+  const bool use_vector_loop = codegen->GetInstructionSetFeatures().HasSSE4_1();
+  Label found_label;
+
   // Do a zero-length check. Even with string compression `count == 0` means empty.
   // TODO: Support jecxz.
   NearLabel not_found_label;
@@ -1506,6 +1606,9 @@ static void GenerateStringIndexOf(HInvoke* invoke,
     // Check if RAX (search_value) is ASCII.
     __ cmpl(search_value, Immediate(127));
     __ j(kGreater, &not_found_label);
+    if (use_vector_loop) {
+      GenerateStringIndexOfVectorLoop(assembler, locations, /* compressed= */ true, &found_label);
+    }
     // Comparing byte-per-byte.
     __ repne_scasb();
     __ jmp(&comparison_done);
@@ -1513,15 +1616,22 @@ static void GenerateStringIndexOf(HInvoke* invoke,
     //   * Comparison address in RDI.
     //   * Counter in ECX.
     __ Bind(&uncompressed_string_comparison);
+    if (use_vector_loop) {
+      GenerateStringIndexOfVectorLoop(assembler, locations, /* compressed= */ false, &found_label);
+    }
     __ repne_scasw();
     __ Bind(&comparison_done);
   } else {
+    if (use_vector_loop) {
+      GenerateStringIndexOfVectorLoop(assembler, locations, /* compressed= */ false, &found_label);
+    }
     __ repne_scasw();
   }
   // Did we find a match?
   __ j(kNotEqual, &not_found_label);
 
   // Yes, we matched.  Compute the index of the result.
+  __ Bind(&found_label);
   __ subl(string_length, counter);
   __ leal(out, Address(string_length, -1));
 
@@ -1540,7 +1650,7 @@ static void GenerateStringIndexOf(HInvoke* invoke,
 }
 
 void IntrinsicLocationsBuilderX86_64::VisitStringIndexOf(HInvoke* invoke) {
-  CreateStringIndexOfLocations(invoke, allocator_, /* start_at_zero= */ true);
+  CreateStringIndexOfLocations(invoke, allocator_, codegen_, /* start_at_zero= */ true);
 }
 
 void IntrinsicCodeGeneratorX86_64::VisitStringIndexOf(HInvoke* invoke) {
@@ -1548,7 +1658,7 @@ void IntrinsicCodeGeneratorX86_64::VisitStringIndexOf(HInvoke* invoke) {
 }
 
 void IntrinsicLocationsBuilderX86_64::VisitStringIndexOfAfter(HInvoke* invoke) {
-  CreateStringIndexOfLocations(invoke, allocator_, /* start_at_zero= */ false);
+  CreateStringIndexOfLocations(invoke, allocator_, codegen_, /* start_at_zero= */ false);
 }
 
 void IntrinsicCodeGeneratorX86_64::VisitStringIndexOfAfter(HInvoke* invoke) {
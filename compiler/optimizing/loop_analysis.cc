@@ -88,6 +88,8 @@ class ArchDefaultLoopHelper : public ArchNoOptsLoopHelper {
   static constexpr uint32_t kScalarHeuristicMaxBodySizeBlocks = 6;
   // Maximum number of instructions to be created as a result of full unrolling.
   static constexpr uint32_t kScalarHeuristicFullyUnrolledMaxInstrThreshold = 35;
+  // Maximum number of instructions in both versions of a loop as a result of unswitching.
+  static constexpr uint32_t kScalarHeuristicUnswitchedMaxInstrThreshold = 35;
 
   bool IsLoopNonBeneficialForScalarOpts(LoopAnalysisInfo* analysis_info) const override {
     return analysis_info->HasLongTypeInstructions() ||
@@ -120,6 +122,11 @@ class ArchDefaultLoopHelper : public ArchNoOptsLoopHelper {
     return (trip_count * instr_num < kScalarHeuristicFullyUnrolledMaxInstrThreshold);
   }
 
+  bool IsLoopUnswitchingBeneficial(LoopAnalysisInfo* analysis_info) const override {
+    size_t instr_num = analysis_info->GetNumberOfInstructions();
+    return (2 * instr_num < kScalarHeuristicUnswitchedMaxInstrThreshold);
+  }
+
  protected:
   bool IsLoopTooBig(LoopAnalysisInfo* loop_analysis_info,
                     size_t instr_threshold,
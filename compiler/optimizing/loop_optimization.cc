@@ -436,6 +436,22 @@ static void PeelByCount(HLoopInformation* loop_info,
   }
 }
 
+// Returns an "if" inside the loop body, other than a loop exit, whose condition is
+// loop-invariant, or nullptr if there is no such "if".
+static HIf* FindLoopInvariantIf(HLoopInformation* loop_info) {
+  for (HBlocksInLoopIterator it_loop(*loop_info); !it_loop.Done(); it_loop.Advance()) {
+    HIf* hif = it_loop.Current()->GetLastInstruction()->AsIfOrNull();
+    if (hif != nullptr &&
+        !hif->InputAt(0)->IsConstant() &&
+        loop_info->IsDefinedOutOfTheLoop(hif->InputAt(0)) &&
+        loop_info->Contains(*hif->IfTrueSuccessor()) &&
+        loop_info->Contains(*hif->IfFalseSuccessor())) {
+      return hif;
+    }
+  }
+  return nullptr;
+}
+
 // Returns the narrower type out of instructions a and b types.
 static DataType::Type GetNarrowerType(HInstruction* a, HInstruction* b) {
   DataType::Type type = a->GetType();
@@ -526,8 +542,7 @@ HLoopOptimization::HLoopOptimization(HGraph* graph,
       vector_refs_(nullptr),
       vector_static_peeling_factor_(0),
       vector_dynamic_peeling_candidate_(nullptr),
-      vector_runtime_test_a_(nullptr),
-      vector_runtime_test_b_(nullptr),
+      vector_runtime_tests_(nullptr),
       vector_map_(nullptr),
       vector_permanent_map_(nullptr),
       vector_external_set_(nullptr),
@@ -588,6 +603,8 @@ bool HLoopOptimization::LocalRun() {
   ScopedArenaSafeMap<HInstruction*, HInstruction*> reds(
       std::less<HInstruction*>(), loop_allocator_->Adapter(kArenaAllocLoopOptimization));
   ScopedArenaSet<ArrayReference> refs(loop_allocator_->Adapter(kArenaAllocLoopOptimization));
+  ScopedArenaVector<std::pair<HInstruction*, HInstruction*>> tests(
+      loop_allocator_->Adapter(kArenaAllocLoopOptimization));
   ScopedArenaSafeMap<HInstruction*, HInstruction*> map(
       std::less<HInstruction*>(), loop_allocator_->Adapter(kArenaAllocLoopOptimization));
   ScopedArenaSafeMap<HInstruction*, HInstruction*> perm(
@@ -599,6 +616,7 @@ bool HLoopOptimization::LocalRun() {
   iset_ = &iset;
   reductions_ = &reds;
   vector_refs_ = &refs;
+  vector_runtime_tests_ = &tests;
   vector_map_ = &map;
   vector_permanent_map_ = &perm;
   vector_external_set_ = &ext_set;
@@ -609,6 +627,7 @@ bool HLoopOptimization::LocalRun() {
   iset_ = nullptr;
   reductions_ = nullptr;
   vector_refs_ = nullptr;
+  vector_runtime_tests_ = nullptr;
   vector_map_ = nullptr;
   vector_permanent_map_ = nullptr;
   vector_external_set_ = nullptr;
@@ -1085,6 +1104,47 @@ bool HLoopOptimization::TryFullUnrolling(LoopAnalysisInfo* analysis_info, bool g
   return true;
 }
 
+bool HLoopOptimization::TryUnswitchingForLoopInvariantCondition(LoopAnalysisInfo* analysis_info,
+                                                                bool generate_code) {
+  HLoopInformation* loop_info = analysis_info->GetLoopInfo();
+  if (!arch_loop_helper_->IsLoopPeelingEnabled() ||
+      !arch_loop_helper_->IsLoopUnswitchingBeneficial(analysis_info)) {
+    return false;
+  }
+
+  HIf* hif = FindLoopInvariantIf(loop_info);
+  if (hif == nullptr) {
+    return false;
+  }
+
+  if (generate_code) {
+    // Version the loop and select the version with the invariant condition in the preheader.
+    // Each version then has the condition statically known and the branch is folded away:
+    //
+    //                                    if (cond) {
+    //   for (...) {                        for (...) { A; B; }
+    //     if (cond) { A; }      ==>      } else {
+    //     B;                               for (...) { B; }
+    //   }                                }
+    //
+    HInstruction* condition = hif->InputAt(0);
+    HBasicBlock* preheader = loop_info->GetPreHeader();
+    LoopClonerSimpleHelper helper(loop_info, &induction_range_);
+    helper.DoVersioning();
+
+    // After versioning the original preheader branches to the original loop (first successor)
+    // and to its copy (second successor), but still ends with a goto.
+    DCHECK_EQ(preheader->GetSuccessors().size(), 2u);
+    DCHECK(preheader->GetLastInstruction()->IsGoto());
+    HIf* guard = new (global_allocator_) HIf(condition);
+    preheader->ReplaceAndRemoveInstructionWith(preheader->GetLastInstruction(), guard);
+    TryToEvaluateIfCondition(guard, graph_);
+    MaybeRecordStat(stats_, MethodCompilationStat::kLoopUnswitched);
+  }
+
+  return true;
+}
+
 bool HLoopOptimization::TryLoopScalarOpts(LoopNode* node) {
   HLoopInformation* loop_info = node->loop_info;
   int64_t trip_count = LoopAnalysis::GetLoopTripCount(loop_info, &induction_range_);
@@ -1098,6 +1158,7 @@ bool HLoopOptimization::TryLoopScalarOpts(LoopNode* node) {
 
   if (!TryFullUnrolling(&analysis_info, /*generate_code*/ false) &&
       !TryPeelingForLoopInvariantExitsElimination(&analysis_info, /*generate_code*/ false) &&
+      !TryUnswitchingForLoopInvariantCondition(&analysis_info, /*generate_code*/ false) &&
       !TryUnrollingForBranchPenaltyReduction(&analysis_info, /*generate_code*/ false) &&
       !TryToRemoveSuspendCheckFromLoopHeader(&analysis_info, /*generate_code*/ false)) {
     return false;
@@ -1115,6 +1176,7 @@ bool HLoopOptimization::TryLoopScalarOpts(LoopNode* node) {
 
   return TryFullUnrolling(&analysis_info) ||
          TryPeelingForLoopInvariantExitsElimination(&analysis_info) ||
+         TryUnswitchingForLoopInvariantCondition(&analysis_info) ||
          TryUnrollingForBranchPenaltyReduction(&analysis_info) || removed_suspend_check;
 }
 
@@ -1133,8 +1195,7 @@ bool HLoopOptimization::CanVectorizeDataFlow(LoopNode* node,
   vector_refs_->clear();
   vector_static_peeling_factor_ = 0;
   vector_dynamic_peeling_candidate_ = nullptr;
-  vector_runtime_test_a_ =
-  vector_runtime_test_b_ = nullptr;
+  vector_runtime_tests_->clear();
 
   // Traverse the data flow of the loop, in the original program order.
   for (HBlocksInLoopReversePostOrderIterator block_it(*header->GetLoopInformation());
@@ -1207,16 +1268,8 @@ bool HLoopOptimization::CanVectorizeDataFlow(LoopNode* node,
           // Found a[i+x] vs. b[i+y]. Accept if x == y (at worst loop-independent data dependence).
           // Conservatively assume a potential loop-carried data dependence otherwise, avoided by
           // generating an explicit a != b disambiguation runtime test on the two references.
-          if (x != y) {
-            // To avoid excessive overhead, we only accept one a != b test.
-            if (vector_runtime_test_a_ == nullptr) {
-              // First test found.
-              vector_runtime_test_a_ = a;
-              vector_runtime_test_b_ = b;
-            } else if ((vector_runtime_test_a_ != a || vector_runtime_test_b_ != b) &&
-                       (vector_runtime_test_a_ != b || vector_runtime_test_b_ != a)) {
-              return false;  // second test would be needed
-            }
+          if (x != y && !AddArrayRefsDisambiguationTest(a, b)) {
+            return false;  // too many tests would be needed
           }
         }
       }
@@ -1299,15 +1352,10 @@ void HLoopOptimization::VectorizePredicated(LoopNode* node,
   HInstruction* vtc = stc;
   vector_index_ = graph_->GetConstant(induc_type, 0);
   bool needs_disambiguation_test = false;
-  // Generate runtime disambiguation test:
+  // Generate runtime disambiguation tests:
   // vtc = a != b ? vtc : 0;
   if (NeedsArrayRefsDisambiguationTest()) {
-    HInstruction* rt = Insert(
-        preheader,
-        new (global_allocator_) HNotEqual(vector_runtime_test_a_, vector_runtime_test_b_));
-    vtc = Insert(preheader,
-                 new (global_allocator_)
-                 HSelect(rt, vtc, graph_->GetConstant(induc_type, 0), kNoDexPc));
+    vtc = GenerateArrayRefsDisambiguationTests(preheader, induc_type, vtc);
     needs_disambiguation_test = true;
   }
 
@@ -1446,15 +1494,10 @@ void HLoopOptimization::VectorizeTraditional(LoopNode* node,
   }
   vector_index_ = graph_->GetConstant(induc_type, 0);
 
-  // Generate runtime disambiguation test:
+  // Generate runtime disambiguation tests:
   // vtc = a != b ? vtc : 0;
   if (NeedsArrayRefsDisambiguationTest()) {
-    HInstruction* rt = Insert(
-        preheader,
-        new (global_allocator_) HNotEqual(vector_runtime_test_a_, vector_runtime_test_b_));
-    vtc = Insert(preheader,
-                 new (global_allocator_)
-                 HSelect(rt, vtc, graph_->GetConstant(induc_type, 0), kNoDexPc));
+    vtc = GenerateArrayRefsDisambiguationTests(preheader, induc_type, vtc);
     needs_cleanup = true;
   }
 
@@ -1508,6 +1551,33 @@ void HLoopOptimization::VectorizeTraditional(LoopNode* node,
   FinalizeVectorization(node);
 }
 
+bool HLoopOptimization::AddArrayRefsDisambiguationTest(HInstruction* a, HInstruction* b) {
+  for (const std::pair<HInstruction*, HInstruction*>& test : *vector_runtime_tests_) {
+    if ((test.first == a && test.second == b) || (test.first == b && test.second == a)) {
+      return true;  // already tested
+    }
+  }
+  // To avoid excessive overhead, only accept a small number of a != b tests.
+  if (vector_runtime_tests_->size() >= kMaxNumberOfRuntimeDisambiguationTests) {
+    return false;
+  }
+  vector_runtime_tests_->emplace_back(a, b);
+  return true;
+}
+
+HInstruction* HLoopOptimization::GenerateArrayRefsDisambiguationTests(HBasicBlock* preheader,
+                                                                      DataType::Type induc_type,
+                                                                      HInstruction* vtc) {
+  DCHECK(NeedsArrayRefsDisambiguationTest());
+  HInstruction* zero = graph_->GetConstant(induc_type, 0);
+  for (const std::pair<HInstruction*, HInstruction*>& test : *vector_runtime_tests_) {
+    HInstruction* rt =
+        Insert(preheader, new (global_allocator_) HNotEqual(test.first, test.second));
+    vtc = Insert(preheader, new (global_allocator_) HSelect(rt, vtc, zero, kNoDexPc));
+  }
+  return vtc;
+}
+
 void HLoopOptimization::FinalizeVectorization(LoopNode* node) {
   HBasicBlock* header = node->loop_info->GetHeader();
   HBasicBlock* preheader = node->loop_info->GetPreHeader();
@@ -53,6 +53,10 @@ class HLoopOptimization : public HOptimization {
   // be performed.
   static constexpr int64_t kMaxTotalInstRemoveSuspendCheck = 128;
 
+  // The maximum number of runtime a != b disambiguation tests guarding a vector loop. Each
+  // test costs a compare and a select in the preheader.
+  static constexpr size_t kMaxNumberOfRuntimeDisambiguationTests = 3;
+
  private:
   /**
    * A single loop inside the loop hierarchy representation.
@@ -275,6 +279,13 @@ class HLoopOptimization : public HOptimization {
   // should be actually applied.
   bool TryFullUnrolling(LoopAnalysisInfo* analysis_info, bool generate_code = true);
 
+  // Tries to apply loop unswitching: a loop containing a conditional branch on a loop-invariant
+  // condition is versioned, the condition is evaluated once in the preheader to select a version,
+  // and each version has the branch statically resolved. Returns whether transformation
+  // happened. 'generate_code' determines whether the optimization should be actually applied.
+  bool TryUnswitchingForLoopInvariantCondition(LoopAnalysisInfo* analysis_info,
+                                               bool generate_code = true);
+
   // Tries to remove SuspendCheck for plain loops with a low trip count. The
   // SuspendCheck in the codegen makes sure that the thread can be interrupted
   // during execution for GC. Not being able to do so might decrease the
@@ -380,7 +391,17 @@ class HLoopOptimization : public HOptimization {
                                HInstruction* step);
 
   // Returns whether the vector loop needs runtime disambiguation test for array refs.
-  bool NeedsArrayRefsDisambiguationTest() const { return vector_runtime_test_a_ != nullptr; }
+  bool NeedsArrayRefsDisambiguationTest() const { return !vector_runtime_tests_->empty(); }
+
+  // Records that the vector loop needs a runtime a != b test. Returns false if this would
+  // exceed the maximum number of such tests.
+  bool AddArrayRefsDisambiguationTest(HInstruction* a, HInstruction* b);
+
+  // Generates the runtime disambiguation tests in the preheader, selecting a zero vector
+  // trip count when any tested pair of array references may alias.
+  HInstruction* GenerateArrayRefsDisambiguationTests(HBasicBlock* preheader,
+                                                     DataType::Type induc_type,
+                                                     HInstruction* vtc);
 
   bool VectorizeDef(LoopNode* node, HInstruction* instruction, bool generate_code);
   bool VectorizeUse(LoopNode* node,
@@ -529,9 +550,9 @@ class HLoopOptimization : public HOptimization {
   uint32_t vector_static_peeling_factor_;
   const ArrayReference* vector_dynamic_peeling_candidate_;
 
-  // Dynamic data dependence test of the form a != b.
-  HInstruction* vector_runtime_test_a_;
-  HInstruction* vector_runtime_test_b_;
+  // Dynamic data dependence tests of the form a != b, one per pair of array references.
+  // Contents reside in phase-local heap memory.
+  ScopedArenaVector<std::pair<HInstruction*, HInstruction*>>* vector_runtime_tests_;
 
   // Mapping used during vectorization synthesis for both the scalar peeling/cleanup
   // loop (mode is kSequential) and the actual vector loop (mode is kVector). The data
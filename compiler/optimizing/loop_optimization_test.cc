@@ -344,4 +344,85 @@ TEST_F(LoopOptimizationTest, SimplifyLoopSinglePreheader) {
   EXPECT_EQ(header_phi->InputAt(1), body_add);
 }
 
+// Checks that a loop with a branch on a loop-invariant condition is unswitched: the loop is
+// versioned on that condition in the preheader and the branch is resolved in each version.
+//
+//   for (int i = 0; i < parameter; i += flag ? 1 : 2) {}
+TEST_F(LoopOptimizationTest, UnswitchLoopInvariantIf) {
+  TEST_DISABLED_FOR_RISCV64();
+  HInstruction* flag = new (GetAllocator()) HParameterValue(graph_->GetDexFile(),
+                                                            dex::TypeIndex(1),
+                                                            1,
+                                                            DataType::Type::kBool);
+  entry_block_->AddInstruction(flag);
+  entry_block_->AddInstruction(new (GetAllocator()) HGoto());
+
+  HBasicBlock* header = new (GetAllocator()) HBasicBlock(graph_);
+  HBasicBlock* if_block = new (GetAllocator()) HBasicBlock(graph_);
+  HBasicBlock* then_block = new (GetAllocator()) HBasicBlock(graph_);
+  HBasicBlock* else_block = new (GetAllocator()) HBasicBlock(graph_);
+  HBasicBlock* latch = new (GetAllocator()) HBasicBlock(graph_);
+  graph_->AddBlock(header);
+  graph_->AddBlock(if_block);
+  graph_->AddBlock(then_block);
+  graph_->AddBlock(else_block);
+  graph_->AddBlock(latch);
+
+  // Control flow.
+  entry_block_->ReplaceSuccessor(return_block_, header);
+  header->AddSuccessor(if_block);
+  header->AddSuccessor(return_block_);
+  if_block->AddSuccessor(then_block);
+  if_block->AddSuccessor(else_block);
+  then_block->AddSuccessor(latch);
+  else_block->AddSuccessor(latch);
+  latch->AddSuccessor(header);
+
+  // Data flow.
+  HPhi* phi = new (GetAllocator()) HPhi(GetAllocator(), 0, 0, DataType::Type::kInt32);
+  header->AddPhi(phi);
+  HInstruction* cmp = new (GetAllocator()) HLessThan(phi, parameter_);
+  header->AddInstruction(cmp);
+  header->AddInstruction(new (GetAllocator()) HIf(cmp));
+  HIf* hif = new (GetAllocator()) HIf(flag);
+  if_block->AddInstruction(hif);
+  then_block->AddInstruction(new (GetAllocator()) HGoto());
+  else_block->AddInstruction(new (GetAllocator()) HGoto());
+  HPhi* step = new (GetAllocator()) HPhi(GetAllocator(), 0, 0, DataType::Type::kInt32);
+  latch->AddPhi(step);
+  step->AddInput(graph_->GetIntConstant(1));
+  step->AddInput(graph_->GetIntConstant(2));
+  HInstruction* add = new (GetAllocator()) HAdd(DataType::Type::kInt32, phi, step);
+  latch->AddInstruction(add);
+  latch->AddInstruction(new (GetAllocator()) HGoto());
+  phi->AddInput(graph_->GetIntConstant(0));
+  phi->AddInput(add);
+
+  PerformAnalysis();
+
+  // The guard selects the original loop when the condition holds.
+  HBasicBlock* preheader = header->GetLoopInformation()->GetPreHeader();
+  HBasicBlock* guard_block = preheader->GetSinglePredecessor();
+  ASSERT_NE(guard_block, nullptr);
+  HIf* guard = guard_block->GetLastInstruction()->AsIfOrNull();
+  ASSERT_NE(guard, nullptr);
+  EXPECT_EQ(guard->InputAt(0), flag);
+  EXPECT_EQ(guard->IfTrueSuccessor(), preheader);
+  EXPECT_EQ(hif->InputAt(0), graph_->GetIntConstant(1));
+
+  // The copy of the loop has the branch resolved the other way.
+  HBasicBlock* copy_header = guard->IfFalseSuccessor()->GetSingleSuccessor();
+  ASSERT_NE(copy_header, nullptr);
+  ASSERT_TRUE(copy_header->IsLoopHeader());
+  EXPECT_NE(copy_header, header);
+  size_t resolved_copies = 0;
+  for (HBlocksInLoopIterator it(*copy_header->GetLoopInformation()); !it.Done(); it.Advance()) {
+    HIf* copy_if = it.Current()->GetLastInstruction()->AsIfOrNull();
+    if (copy_if != nullptr && copy_if->InputAt(0) == graph_->GetIntConstant(0)) {
+      ++resolved_copies;
+    }
+  }
+  EXPECT_EQ(resolved_copies, 1u);
+}
+
 }  // namespace art
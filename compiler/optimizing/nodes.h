@@ -681,7 +681,16 @@ class HGraph : public ArenaObject<kArenaAllocGraph> {
 
   bool IsCompilingOsr() const { return compilation_kind_ == CompilationKind::kOsr; }
 
-  bool IsCompilingBaseline() const { return compilation_kind_ == CompilationKind::kBaseline; }
+  // Baseline-plus code is baseline code (with profiling) on which a few cheap
+  // optimizations have been run.
+  bool IsCompilingBaseline() const {
+    return compilation_kind_ == CompilationKind::kBaseline ||
+           compilation_kind_ == CompilationKind::kBaselinePlus;
+  }
+
+  bool IsCompilingBaselinePlus() const {
+    return compilation_kind_ == CompilationKind::kBaselinePlus;
+  }
 
   CompilationKind GetCompilationKind() const { return compilation_kind_; }
 
@@ -5369,6 +5378,7 @@ class HNewArray final : public HExpression<2> {
     SetRawInputAt(0, cls);
     SetRawInputAt(1, length);
     SetPackedField<ComponentSizeShiftField>(component_size_shift);
+    SetPackedFlag<kFlagPretenured>(false);
   }
 
   bool IsClonable() const override { return true; }
@@ -5394,6 +5404,11 @@ class HNewArray final : public HExpression<2> {
     return GetPackedField<ComponentSizeShiftField>();
   }
 
+  // Whether the array should be allocated directly in the non-moving space, because
+  // the runtime found the objects allocated by this instruction to be long-lived.
+  bool IsPretenured() const { return GetPackedFlag<kFlagPretenured>(); }
+  void SetPretenured() { SetPackedFlag<kFlagPretenured>(true); }
+
   DECLARE_INSTRUCTION(NewArray);
 
  protected:
@@ -5402,8 +5417,8 @@ class HNewArray final : public HExpression<2> {
  private:
   static constexpr size_t kFieldComponentSizeShift = kNumberOfGenericPackedBits;
   static constexpr size_t kFieldComponentSizeShiftSize = MinimumBitsToStore(3u);
-  static constexpr size_t kNumberOfNewArrayPackedBits =
-      kFieldComponentSizeShift + kFieldComponentSizeShiftSize;
+  static constexpr size_t kFlagPretenured = kFieldComponentSizeShift + kFieldComponentSizeShiftSize;
+  static constexpr size_t kNumberOfNewArrayPackedBits = kFlagPretenured + 1;
   static_assert(kNumberOfNewArrayPackedBits <= kMaxNumberOfPackedBits, "Too many packed fields.");
   using ComponentSizeShiftField =
       BitField<size_t, kFieldComponentSizeShift, kFieldComponentSizeShiftSize>;
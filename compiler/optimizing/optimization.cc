@@ -54,6 +54,8 @@
 #include "licm.h"
 #include "load_store_elimination.h"
 #include "loop_optimization.h"
+#include "partial_escape_analysis.h"
+#include "partial_redundancy_elimination.h"
 #include "scheduler.h"
 #include "select_generator.h"
 #include "sharpening.h"
@@ -76,6 +78,10 @@ const char* OptimizationPassName(OptimizationPass pass) {
       return LICM::kLoopInvariantCodeMotionPassName;
     case OptimizationPass::kLoopOptimization:
       return HLoopOptimization::kLoopOptimizationPassName;
+    case OptimizationPass::kPartialEscapeAnalysis:
+      return PartialEscapeAnalysis::kPartialEscapeAnalysisPassName;
+    case OptimizationPass::kPartialRedundancyElimination:
+      return PartialRedundancyElimination::kPartialRedundancyEliminationPassName;
     case OptimizationPass::kBoundsCheckElimination:
       return BoundsCheckElimination::kBoundsCheckEliminationPassName;
     case OptimizationPass::kLoadStoreElimination:
@@ -136,6 +142,28 @@ const char* OptimizationPassName(OptimizationPass pass) {
   }
 }
 
+bool IsOptionalOptimization(OptimizationPass pass) {
+  switch (pass) {
+    case OptimizationPass::kBoundsCheckElimination:
+    case OptimizationPass::kCHAGuardOptimization:
+    case OptimizationPass::kCodeSinking:
+    case OptimizationPass::kGlobalValueNumbering:
+    case OptimizationPass::kInductionVarAnalysis:
+    case OptimizationPass::kInliner:
+    case OptimizationPass::kInvariantCodeMotion:
+    case OptimizationPass::kLoadStoreElimination:
+    case OptimizationPass::kLoopOptimization:
+    case OptimizationPass::kPartialEscapeAnalysis:
+    case OptimizationPass::kPartialRedundancyElimination:
+    case OptimizationPass::kScheduling:
+    case OptimizationPass::kSelectGenerator:
+    case OptimizationPass::kSideEffectsAnalysis:
+      return true;
+    default:
+      return false;
+  }
+}
+
 #define X(x) if (pass_name == OptimizationPassName((x))) return (x)
 
 OptimizationPass OptimizationPassByName(const std::string& pass_name) {
@@ -152,6 +180,8 @@ OptimizationPass OptimizationPassByName(const std::string& pass_name) {
   X(OptimizationPass::kInvariantCodeMotion);
   X(OptimizationPass::kLoadStoreElimination);
   X(OptimizationPass::kLoopOptimization);
+  X(OptimizationPass::kPartialEscapeAnalysis);
+  X(OptimizationPass::kPartialRedundancyElimination);
   X(OptimizationPass::kScheduling);
   X(OptimizationPass::kSelectGenerator);
   X(OptimizationPass::kSideEffectsAnalysis);
@@ -222,6 +252,11 @@ ArenaVector<HOptimization*> ConstructOptimizations(
         CHECK(most_recent_side_effects != nullptr);
         opt = new (allocator) LICM(graph, *most_recent_side_effects, stats, pass_name);
         break;
+      case OptimizationPass::kPartialRedundancyElimination:
+        CHECK(most_recent_side_effects != nullptr);
+        opt = new (allocator) PartialRedundancyElimination(
+            graph, *most_recent_side_effects, stats, pass_name);
+        break;
       case OptimizationPass::kLoopOptimization:
         CHECK(most_recent_induction != nullptr);
         opt = new (allocator) HLoopOptimization(
@@ -287,6 +322,9 @@ ArenaVector<HOptimization*> ConstructOptimizations(
       case OptimizationPass::kLoadStoreElimination:
         opt = new (allocator) LoadStoreElimination(graph, stats, pass_name);
         break;
+      case OptimizationPass::kPartialEscapeAnalysis:
+        opt = new (allocator) PartialEscapeAnalysis(graph, stats, pass_name);
+        break;
       case OptimizationPass::kWriteBarrierElimination:
         opt = new (allocator) WriteBarrierElimination(graph, stats, pass_name);
         break;
@@ -82,6 +82,8 @@ enum class OptimizationPass {
   kInvariantCodeMotion,
   kLoadStoreElimination,
   kLoopOptimization,
+  kPartialEscapeAnalysis,
+  kPartialRedundancyElimination,
   kScheduling,
   kSelectGenerator,
   kSideEffectsAnalysis,
@@ -116,6 +118,10 @@ const char* OptimizationPassName(OptimizationPass pass);
 // Lookup optimization pass by name.
 OptimizationPass OptimizationPassByName(const std::string& pass_name);
 
+// Whether the pass only improves the generated code and can be skipped without
+// breaking the assumptions of later passes or of the code generator.
+bool IsOptionalOptimization(OptimizationPass pass);
+
 // Optimization definition consisting of an optimization pass
 // an optional alternative name (nullptr denotes default), and
 // an optional pass dependence (kNone denotes no dependence).
@@ -30,7 +30,9 @@
 #include "base/macros.h"
 #include "base/mutex.h"
 #include "base/scoped_arena_allocator.h"
+#include "base/time_utils.h"
 #include "base/timing_logger.h"
+#include "base/utils.h"
 #include "builder.h"
 #include "code_generator.h"
 #include "compiler.h"
@@ -54,6 +56,7 @@
 #include "optimizing/write_barrier_elimination.h"
 #include "prepare_for_register_allocation.h"
 #include "reference_type_propagation.h"
+#include "runtime.h"
 #include "register_allocator_linear_scan.h"
 #include "select_generator.h"
 #include "ssa_builder.h"
@@ -66,6 +69,11 @@ namespace art HIDDEN {
 
 static constexpr size_t kArenaAllocatorMemoryReportThreshold = 8 * MB;
 
+// Arena memory a single JIT compilation may use before we start skipping the optional
+// optimization passes. The time budget is `CompilerOptions::GetJitCompilationTimeBudgetMs()`.
+// AOT compilations are not budgeted so that their output stays deterministic.
+static constexpr size_t kJitCompilationMemoryBudget = 64 * MB;
+
 static constexpr const char* kPassNameSeparator = "$";
 
 /**
@@ -93,7 +101,11 @@ class PassObserver : public ValueObject {
         visualizer_enabled_(!compiler_options.GetDumpCfgFileName().empty()),
         visualizer_(&visualizer_oss_, graph, codegen),
         codegen_(codegen),
-        graph_in_bad_state_(false) {
+        graph_in_bad_state_(false),
+        is_budgeted_(compiler_options.IsJitCompiler()),
+        over_budget_(false),
+        time_budget_ns_(MsToNs(compiler_options.GetJitCompilationTimeBudgetMs())),
+        start_ns_(is_budgeted_ ? ThreadCpuNanoTime() : 0u) {
     if (timing_logger_enabled_ || visualizer_enabled_) {
       if (!IsVerboseMethod(compiler_options, GetMethodName())) {
         timing_logger_enabled_ = visualizer_enabled_ = false;
@@ -125,6 +137,28 @@ class PassObserver : public ValueObject {
 
   void SetGraphInBadState() { graph_in_bad_state_ = true; }
 
+  // Returns whether the compilation used up its time or memory budget. Once over
+  // budget, the compilation stays over budget. The first time this returns true,
+  // the event is recorded in `stats` and in the runtime metrics.
+  bool IsOverBudget(OptimizingCompilerStats* stats) {
+    if (!is_budgeted_ || over_budget_) {
+      return over_budget_;
+    }
+    uint64_t time_ns = ThreadCpuNanoTime() - start_ns_;
+    size_t memory = graph_->GetAllocator()->BytesUsed() +
+                    graph_->GetArenaStack()->ApproximatePeakBytes();
+    if (time_ns < time_budget_ns_ && memory < kJitCompilationMemoryBudget) {
+      return false;
+    }
+    over_budget_ = true;
+    VLOG(jit) << "Compilation of " << GetMethodName() << " over budget after "
+              << PrettyDuration(time_ns) << " and " << PrettySize(memory)
+              << ", skipping optional passes";
+    MaybeRecordStat(stats, MethodCompilationStat::kCompilationOverBudget);
+    Runtime::Current()->GetMetrics()->JitMethodCompileOverBudgetCount()->AddOne();
+    return true;
+  }
+
   const char* GetMethodName() {
     // PrettyMethod() is expensive, so we delay calling it until we actually have to.
     if (cached_method_name_.empty()) {
@@ -216,6 +250,12 @@ class PassObserver : public ValueObject {
   // expected to validate.
   bool graph_in_bad_state_;
 
+  // Budget tracking, only enabled for JIT compilations.
+  const bool is_budgeted_;
+  bool over_budget_;
+  const uint64_t time_budget_ns_;
+  const uint64_t start_ns_;
+
   friend PassScope;
 
   DISALLOW_COPY_AND_ASSIGN(PassObserver);
@@ -304,7 +344,11 @@ class OptimizingCompiler final : public Compiler {
     pass_changes[static_cast<size_t>(OptimizationPass::kNone)] = true;
     bool change = false;
     for (size_t i = 0; i < length; ++i) {
-      if (pass_changes[static_cast<size_t>(definitions[i].depends_on)]) {
+      if (IsOptionalOptimization(definitions[i].pass) &&
+          pass_observer->IsOverBudget(compilation_stats_.get())) {
+        // Skip the pass to bound the cost of this compilation.
+        pass_changes[static_cast<size_t>(definitions[i].pass)] = false;
+      } else if (pass_changes[static_cast<size_t>(definitions[i].depends_on)]) {
         // Execute the pass and record whether it changed anything.
         PassScope scope(optimizations[i]->GetPassName(), pass_observer);
         bool pass_change = optimizations[i]->Run();
@@ -372,6 +416,11 @@ class OptimizingCompiler final : public Compiler {
                                 const DexCompilationUnit& dex_compilation_unit,
                                 PassObserver* pass_observer) const;
 
+  bool RunBaselinePlusOptimizations(HGraph* graph,
+                                    CodeGenerator* codegen,
+                                    const DexCompilationUnit& dex_compilation_unit,
+                                    PassObserver* pass_observer) const;
+
   std::vector<uint8_t> GenerateJitDebugInfo(const debug::MethodDebugInfo& method_debug_info);
 
   // This must be called before any other function that dumps data to the cfg
@@ -494,6 +543,29 @@ bool OptimizingCompiler::RunBaselineOptimizations(HGraph* graph,
   }
 }
 
+bool OptimizingCompiler::RunBaselinePlusOptimizations(
+    HGraph* graph,
+    CodeGenerator* codegen,
+    const DexCompilationUnit& dex_compilation_unit,
+    PassObserver* pass_observer) const {
+  // A cheap subset of the optimized pipeline. The inliner only replaces calls to trivial
+  // methods, like getters and setters, so that the code keeps profiling the other calls.
+  OptimizationDef baseline_plus_optimizations[] = {
+      OptDef(OptimizationPass::kInliner),
+      OptDef(OptimizationPass::kSideEffectsAnalysis),
+      OptDef(OptimizationPass::kGlobalValueNumbering),
+      OptDef(OptimizationPass::kInductionVarAnalysis),
+      OptDef(OptimizationPass::kBoundsCheckElimination),
+      OptDef(OptimizationPass::kDeadCodeElimination,
+             "dead_code_elimination$baseline_plus"),
+  };
+  return RunOptimizations(graph,
+                          codegen,
+                          dex_compilation_unit,
+                          pass_observer,
+                          baseline_plus_optimizations);
+}
+
 bool OptimizingCompiler::RunArchOptimizations(HGraph* graph,
                                               CodeGenerator* codegen,
                                               const DexCompilationUnit& dex_compilation_unit,
@@ -663,6 +735,7 @@ void OptimizingCompiler::RunOptimizations(HGraph* graph,
       OptDef(OptimizationPass::kSideEffectsAnalysis,
              "side_effects$before_gvn"),
       OptDef(OptimizationPass::kGlobalValueNumbering),
+      OptDef(OptimizationPass::kPartialRedundancyElimination),
       // Simplification (TODO: only if GVN occurred).
       OptDef(OptimizationPass::kSelectGenerator),
       OptDef(OptimizationPass::kAggressiveConstantFolding,
@@ -687,6 +760,7 @@ void OptimizingCompiler::RunOptimizations(HGraph* graph,
              "dead_code_elimination$after_loop_opt"),
       // Other high-level optimizations.
       OptDef(OptimizationPass::kLoadStoreElimination),
+      OptDef(OptimizationPass::kPartialEscapeAnalysis),
       OptDef(OptimizationPass::kCHAGuardOptimization),
       OptDef(OptimizationPass::kCodeSinking),
       // Simplification.
@@ -835,7 +909,7 @@ CodeGenerator* OptimizingCompiler::TryCompile(ArenaAllocator* allocator,
   jit::Jit* jit = Runtime::Current()->GetJit();
   if (jit != nullptr) {
     ProfilingInfo* info = jit->GetCodeCache()->GetProfilingInfo(method, Thread::Current());
-    DCHECK_IMPLIES(compilation_kind == CompilationKind::kBaseline, info != nullptr)
+    DCHECK_IMPLIES(graph->IsCompilingBaseline(), info != nullptr)
         << "Compiling a method baseline should always have a ProfilingInfo";
     graph->SetProfilingInfo(info);
   }
@@ -905,7 +979,10 @@ CodeGenerator* OptimizingCompiler::TryCompile(ArenaAllocator* allocator,
     }
   }
 
-  if (compilation_kind == CompilationKind::kBaseline) {
+  if (graph->IsCompilingBaseline()) {
+    if (graph->IsCompilingBaselinePlus()) {
+      RunBaselinePlusOptimizations(graph, codegen.get(), dex_compilation_unit, &pass_observer);
+    }
     RunBaselineOptimizations(graph, codegen.get(), dex_compilation_unit, &pass_observer);
   } else {
     RunOptimizations(graph, codegen.get(), dex_compilation_unit, &pass_observer);
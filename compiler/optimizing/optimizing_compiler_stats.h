@@ -65,16 +65,21 @@ enum class MethodCompilationStat {
   kNotCompiledInliningIrreducibleLoop,
   kNotCompiledIrreducibleLoopAndStringInit,
   kNotCompiledPhiEquivalentInOsr,
+  kCompilationOverBudget,
   kInlinedMonomorphicCall,
   kInlinedPolymorphicCall,
+  kInlinedMegamorphicCall,
   kMonomorphicCall,
   kPolymorphicCall,
   kMegamorphicCall,
+  kColdCallSite,
   kBooleanSimplified,
   kIntrinsicRecognized,
   kLoopInvariantMoved,
+  kPartialRedundancyEliminated,
   kLoopVectorized,
   kLoopVectorizedIdiom,
+  kLoopUnswitched,
   kSelectGenerated,
   kRemovedInstanceOf,
   kPropagatedIfValue,
@@ -129,6 +134,7 @@ enum class MethodCompilationStat {
   kFullLSEPossible,
   kNonPartialLoadRemoved,
   kPartialLSEPossible,
+  kPartialLoadRemoved,
   kPartialStoreRemoved,
   kPartialAllocationMoved,
   kDevirtualized,
@@ -0,0 +1,384 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "partial_escape_analysis.h"
+
+#include <algorithm>
+#include <functional>
+#include <utility>
+
+#include "base/arena_bit_vector.h"
+#include "base/bit_vector-inl.h"
+#include "base/scoped_arena_allocator.h"
+#include "base/scoped_arena_containers.h"
+#include "common_dominator.h"
+#include "nodes.h"
+#include "optimizing_compiler_stats.h"
+
+namespace art HIDDEN {
+
+// Returns whether `user` is a field access of `new_instance` that can be replaced by the value
+// last stored to the field.
+static bool IsScalarReplaceableAccess(HInstruction* new_instance, HInstruction* user) {
+  if (user->IsInstanceFieldGet()) {
+    return user->InputAt(0) == new_instance && !user->AsInstanceFieldGet()->IsVolatile();
+  } else if (user->IsInstanceFieldSet()) {
+    return user->InputAt(0) == new_instance &&
+           user->InputAt(1) != new_instance &&
+           !user->AsInstanceFieldSet()->IsVolatile();
+  }
+  return false;
+}
+
+static HInstruction* GetDefaultValue(HGraph* graph, DataType::Type type) {
+  switch (type) {
+    case DataType::Type::kReference:
+      return graph->GetNullConstant();
+    case DataType::Type::kBool:
+    case DataType::Type::kUint8:
+    case DataType::Type::kInt8:
+    case DataType::Type::kUint16:
+    case DataType::Type::kInt16:
+    case DataType::Type::kInt32:
+      return graph->GetIntConstant(0);
+    case DataType::Type::kInt64:
+      return graph->GetLongConstant(0);
+    case DataType::Type::kFloat32:
+      return graph->GetFloatConstant(0);
+    case DataType::Type::kFloat64:
+      return graph->GetDoubleConstant(0);
+    default:
+      LOG(FATAL) << "Unexpected field type " << type;
+      UNREACHABLE();
+  }
+}
+
+bool PartialEscapeAnalysis::Run() {
+  // On the paths where the allocation is removed, its environment uses are dropped. That is not
+  // possible when debugging, and with try/catch or OSR the environments are used to transfer
+  // control to other code that may need the object.
+  if (graph_->IsDebuggable() ||
+      graph_->IsCompilingOsr() ||
+      graph_->HasTryCatch() ||
+      graph_->HasIrreducibleLoops()) {
+    return false;
+  }
+
+  ScopedArenaAllocator allocator(graph_->GetArenaStack());
+  ScopedArenaVector<HNewInstance*> candidates(allocator.Adapter(kArenaAllocMisc));
+  for (HBasicBlock* block : graph_->GetReversePostOrder()) {
+    for (HInstructionIterator it(block->GetInstructions()); !it.Done(); it.Advance()) {
+      HInstruction* instruction = it.Current();
+      // Finalizable objects always escape to the finalizer queue. Allocations that need access
+      // or initialization checks cannot be moved past other instructions that may throw.
+      if (instruction->IsNewInstance() &&
+          !instruction->AsNewInstance()->IsFinalizable() &&
+          !instruction->AsNewInstance()->NeedsChecks()) {
+        candidates.push_back(instruction->AsNewInstance());
+      }
+    }
+  }
+
+  bool changed = false;
+  for (HNewInstance* new_instance : candidates) {
+    if (TryMaterializeInEscapingBranch(new_instance)) {
+      changed = true;
+    }
+  }
+  return changed;
+}
+
+bool PartialEscapeAnalysis::TryMaterializeInEscapingBranch(HNewInstance* new_instance) {
+  HBasicBlock* allocation_block = new_instance->GetBlock();
+  ScopedArenaAllocator allocator(graph_->GetArenaStack());
+
+  // Split the uses into field accesses that we can scalar replace, constructor fences, and all
+  // other uses, which need the object and must end up after the materialization point.
+  ScopedArenaVector<HInstruction*> accesses(allocator.Adapter(kArenaAllocMisc));
+  ScopedArenaVector<HInstruction*> fences(allocator.Adapter(kArenaAllocMisc));
+  CommonDominator escapes(/* block= */ nullptr);
+  bool has_escapes = false;
+  for (const HUseListNode<HInstruction*>& use : new_instance->GetUses()) {
+    HInstruction* user = use.GetUser();
+    if (IsScalarReplaceableAccess(new_instance, user)) {
+      accesses.push_back(user);
+    } else if (user->IsConstructorFence()) {
+      fences.push_back(user);
+    } else {
+      has_escapes = true;
+      escapes.Update(user->IsPhi() ? user->GetBlock()->GetPredecessors()[use.GetIndex()]
+                                   : user->GetBlock());
+    }
+  }
+  ScopedArenaVector<std::pair<HEnvironment*, size_t>> env_uses(
+      allocator.Adapter(kArenaAllocMisc));
+  for (const HUseListNode<HEnvironment*>& use : new_instance->GetEnvUses()) {
+    HInstruction* holder = use.GetUser()->GetHolder();
+    if (holder->IsDeoptimize()) {
+      // Deoptimization needs the object to rebuild the interpreter frame.
+      has_escapes = true;
+      escapes.Update(holder->GetBlock());
+    } else {
+      env_uses.emplace_back(use.GetUser(), use.GetIndex());
+    }
+  }
+  if (!has_escapes || accesses.empty()) {
+    // Allocations that do not escape at all are handled by LoadStoreElimination, and without
+    // field accesses there is nothing to scalar replace (code sinking may still move them).
+    return false;
+  }
+
+  // Give each accessed field an index, with one of its accesses as a template for the stores
+  // that initialize the materialized object.
+  ScopedArenaVector<HInstruction*> fields(allocator.Adapter(kArenaAllocMisc));
+  auto field_index = [&](HInstruction* access) {
+    const FieldInfo& info = access->GetFieldInfo();
+    for (size_t i = 0; i != fields.size(); ++i) {
+      if (fields[i]->GetFieldInfo().GetFieldOffset().Uint32Value() ==
+          info.GetFieldOffset().Uint32Value()) {
+        return i;
+      }
+    }
+    return fields.size();
+  };
+  const size_t num_blocks = graph_->GetBlocks().size();
+  ArenaBitVector has_accesses(&allocator, num_blocks, /* expandable= */ false);
+  has_accesses.ClearAllBits();
+  for (HInstruction* access : accesses) {
+    size_t index = field_index(access);
+    if (index == fields.size()) {
+      fields.push_back(access);
+    } else if (fields[index]->GetFieldInfo().GetFieldType() !=
+               access->GetFieldInfo().GetFieldType()) {
+      return false;
+    }
+    has_accesses.SetBit(access->GetBlock()->GetBlockId());
+  }
+  const size_t num_fields = fields.size();
+
+  ArenaBitVector reachable(&allocator, num_blocks, /* expandable= */ false);
+  ArenaBitVector processed(&allocator, num_blocks, /* expandable= */ false);
+  ScopedArenaVector<HBasicBlock*> worklist(allocator.Adapter(kArenaAllocMisc));
+  ScopedArenaVector<HInstruction*> states(num_blocks * num_fields,
+                                          nullptr,
+                                          allocator.Adapter(kArenaAllocMisc));
+  ScopedArenaSafeMap<HInstruction*, HInstruction*> replacements(
+      std::less<HInstruction*>(), allocator.Adapter(kArenaAllocMisc));
+
+  // Checks whether the object can be materialized at the start of `materialization_block`,
+  // a successor of an HIf. On success, `replacements` holds the value of every field load that
+  // is not dominated by `materialization_block`, and the state of the branch block holds the
+  // field values to materialize.
+  auto analyze = [&](HBasicBlock* materialization_block) {
+    // Find the blocks that can execute after the materialization, until the allocation is
+    // executed again. Uses in these blocks need the materialized object.
+    reachable.ClearAllBits();
+    reachable.SetBit(materialization_block->GetBlockId());
+    worklist.push_back(materialization_block);
+    while (!worklist.empty()) {
+      HBasicBlock* block = worklist.back();
+      worklist.pop_back();
+      for (HBasicBlock* successor : block->GetSuccessors()) {
+        if (successor != allocation_block && !reachable.IsBitSet(successor->GetBlockId())) {
+          reachable.SetBit(successor->GetBlockId());
+          worklist.push_back(successor);
+        }
+      }
+    }
+    HBasicBlock* branch_block = materialization_block->GetSinglePredecessor();
+    if (reachable.IsBitSet(branch_block->GetBlockId())) {
+      return false;
+    }
+    // Paths that leave the materialization region and merge back into code using the object
+    // would need a phi of the object and its scalar replacement. Give up on those.
+    for (HInstruction* user : accesses) {
+      if (!materialization_block->Dominates(user->GetBlock()) &&
+          reachable.IsBitSet(user->GetBlock()->GetBlockId())) {
+        return false;
+      }
+    }
+
+    // Track the value of each field along the paths that do not go through the materialization
+    // block. A null state means the value is not known, for example because it differs between
+    // the predecessors of a merge.
+    processed.ClearAllBits();
+    std::fill(states.begin(), states.end(), nullptr);
+    replacements.clear();
+    for (HBasicBlock* block : graph_->GetReversePostOrder()) {
+      if (!allocation_block->Dominates(block) || reachable.IsBitSet(block->GetBlockId())) {
+        continue;
+      }
+      HInstruction** state = &states[block->GetBlockId() * num_fields];
+      if (block == allocation_block) {
+        for (size_t i = 0; i != num_fields; ++i) {
+          state[i] = GetDefaultValue(graph_, fields[i]->GetFieldInfo().GetFieldType());
+        }
+      } else {
+        bool first = true;
+        for (HBasicBlock* predecessor : block->GetPredecessors()) {
+          if (block->IsLoopHeader() && block->GetLoopInformation()->IsBackEdge(*predecessor)) {
+            continue;
+          }
+          DCHECK(processed.IsBitSet(predecessor->GetBlockId()));
+          HInstruction** predecessor_state = &states[predecessor->GetBlockId() * num_fields];
+          for (size_t i = 0; i != num_fields; ++i) {
+            if (first) {
+              state[i] = predecessor_state[i];
+            } else if (state[i] != predecessor_state[i]) {
+              state[i] = nullptr;
+            }
+          }
+          first = false;
+        }
+        if (block->IsLoopHeader()) {
+          // The back edges have not been visited yet. Forget the fields stored in the loop.
+          for (HInstruction* access : accesses) {
+            if (access->IsInstanceFieldSet() &&
+                block->GetLoopInformation()->Contains(*access->GetBlock())) {
+              state[field_index(access)] = nullptr;
+            }
+          }
+        }
+      }
+      if (has_accesses.IsBitSet(block->GetBlockId())) {
+        for (HInstructionIterator it(block->GetInstructions()); !it.Done(); it.Advance()) {
+          HInstruction* instruction = it.Current();
+          if (!IsScalarReplaceableAccess(new_instance, instruction)) {
+            continue;
+          }
+          size_t index = field_index(instruction);
+          if (instruction->IsInstanceFieldSet()) {
+            HInstruction* value = instruction->InputAt(1);
+            auto it_replacement = replacements.find(value);
+            state[index] =
+                (it_replacement != replacements.end()) ? it_replacement->second : value;
+          } else if (state[index] == nullptr) {
+            return false;
+          } else {
+            replacements.Put(instruction, state[index]);
+          }
+        }
+      }
+      processed.SetBit(block->GetBlockId());
+    }
+
+    DCHECK(processed.IsBitSet(branch_block->GetBlockId()));
+    HInstruction** branch_state = &states[branch_block->GetBlockId() * num_fields];
+    return std::none_of(branch_state,
+                        branch_state + num_fields,
+                        [](HInstruction* value) { return value == nullptr; });
+  };
+
+  // Look for the materialization point, starting from the closest branch dominating all escapes.
+  // It must be in the same loop as the allocation so that it does not allocate more often.
+  HBasicBlock* materialization_block = nullptr;
+  for (HBasicBlock* block = escapes.Get(); block != allocation_block; block = block->GetDominator()) {
+    DCHECK(block != nullptr);
+    if (block->GetPredecessors().size() == 1u &&
+        block->GetSinglePredecessor()->GetLastInstruction()->IsIf() &&
+        block->GetLoopInformation() == allocation_block->GetLoopInformation() &&
+        analyze(block)) {
+      materialization_block = block;
+      break;
+    }
+  }
+  if (materialization_block == nullptr) {
+    return false;
+  }
+  MaybeRecordStat(stats_, MethodCompilationStat::kPartialLSEPossible);
+
+  // Replace the loads outside the materialization region with the tracked values.
+  for (auto [load, value] : replacements) {
+    DCHECK(!materialization_block->Dominates(load->GetBlock()));
+    DataType::Type type = load->GetType();
+    if (type != DataType::Type::kBool &&
+        !DataType::IsTypeConversionImplicit(value->GetType(), type) &&
+        !IsZeroBitPattern(value)) {
+      HTypeConversion* type_conversion =
+          new (graph_->GetAllocator()) HTypeConversion(type, value, load->GetDexPc());
+      load->GetBlock()->InsertInstructionBefore(type_conversion, load);
+      value = type_conversion;
+    }
+    load->ReplaceWith(value);
+    load->GetBlock()->RemoveInstruction(load);
+    MaybeRecordStat(stats_, MethodCompilationStat::kPartialLoadRemoved);
+  }
+
+  // Remove the stores, constructor fences and environment uses outside the region.
+  for (HInstruction* access : accesses) {
+    if (access->IsInstanceFieldSet() && !materialization_block->Dominates(access->GetBlock())) {
+      access->GetBlock()->RemoveInstruction(access);
+      MaybeRecordStat(stats_, MethodCompilationStat::kPartialStoreRemoved);
+    }
+  }
+  bool removed_fence = false;
+  for (HInstruction* fence : fences) {
+    if (!materialization_block->Dominates(fence->GetBlock())) {
+      for (size_t i = fence->InputCount(); i != 0u; --i) {
+        if (fence->InputAt(i - 1u) == new_instance) {
+          fence->AsConstructorFence()->RemoveInputAt(i - 1u);
+        }
+      }
+      if (fence->InputCount() == 0u) {
+        fence->GetBlock()->RemoveInstruction(fence);
+      }
+      removed_fence = true;
+    }
+  }
+  for (auto [environment, index] : env_uses) {
+    if (!materialization_block->Dominates(environment->GetHolder()->GetBlock())) {
+      environment->RemoveAsUserOfInput(index);
+      environment->SetRawEnvAt(index, nullptr);
+    }
+  }
+
+  // Materialize the object with the field values it had when entering the region. Its inputs
+  // and environment dominated its old position, which dominates the new one.
+  HBasicBlock* branch_block = materialization_block->GetSinglePredecessor();
+  HInstruction** branch_state = &states[branch_block->GetBlockId() * num_fields];
+  new_instance->MoveBefore(materialization_block->GetFirstInstruction(), /* do_checks= */ false);
+  HInstruction* cursor = new_instance;
+  for (size_t i = 0; i != num_fields; ++i) {
+    HInstruction* value = branch_state[i];
+    if (IsZeroBitPattern(value)) {
+      // The allocation already zeroes the field.
+      continue;
+    }
+    const FieldInfo& info = fields[i]->GetFieldInfo();
+    HInstanceFieldSet* store = new (graph_->GetAllocator()) HInstanceFieldSet(
+        new_instance,
+        value,
+        info.GetField(),
+        info.GetFieldType(),
+        info.GetFieldOffset(),
+        info.IsVolatile(),
+        info.GetFieldIndex(),
+        info.GetDeclaringClassDefIndex(),
+        info.GetDexFile(),
+        new_instance->GetDexPc());
+    materialization_block->InsertInstructionAfter(store, cursor);
+    cursor = store;
+  }
+  if (removed_fence) {
+    HConstructorFence* fence = new (graph_->GetAllocator()) HConstructorFence(
+        new_instance, new_instance->GetDexPc(), graph_->GetAllocator());
+    materialization_block->InsertInstructionAfter(fence, cursor);
+  }
+  MaybeRecordStat(stats_, MethodCompilationStat::kPartialAllocationMoved);
+  return true;
+}
+
+}  // namespace art
@@ -0,0 +1,62 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_COMPILER_OPTIMIZING_PARTIAL_ESCAPE_ANALYSIS_H_
+#define ART_COMPILER_OPTIMIZING_PARTIAL_ESCAPE_ANALYSIS_H_
+
+#include "base/macros.h"
+#include "optimization.h"
+
+namespace art HIDDEN {
+
+class HNewInstance;
+
+// Scalar-replaces allocations that only escape on some paths of the method.
+//
+// LoadStoreElimination removes an allocation only when it does not escape at all. This pass
+// handles objects that escape only in a region of the graph entered through a single branch,
+// for example:
+//
+//   Builder b = new Builder();          if (rare) {
+//   b.x = x;                              Builder b = new Builder();
+//   if (rare) {                  ==>      b.x = x;
+//     log(b);                             log(b);
+//   }                                   }
+//   return b.x;                         return x;
+//
+// The allocation is moved to the start of the branch and the field values it has at that point
+// are stored into it there. On all other paths, the field accesses of the object are replaced
+// with the values that were stored, and the object is never allocated.
+class PartialEscapeAnalysis : public HOptimization {
+ public:
+  PartialEscapeAnalysis(HGraph* graph,
+                        OptimizingCompilerStats* stats,
+                        const char* name = kPartialEscapeAnalysisPassName)
+      : HOptimization(graph, name, stats) {}
+
+  bool Run() override;
+
+  static constexpr const char* kPartialEscapeAnalysisPassName = "partial_escape_analysis";
+
+ private:
+  bool TryMaterializeInEscapingBranch(HNewInstance* new_instance);
+
+  DISALLOW_COPY_AND_ASSIGN(PartialEscapeAnalysis);
+};
+
+}  // namespace art
+
+#endif  // ART_COMPILER_OPTIMIZING_PARTIAL_ESCAPE_ANALYSIS_H_
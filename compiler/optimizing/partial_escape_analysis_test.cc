@@ -0,0 +1,189 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "partial_escape_analysis.h"
+
+#include "gtest/gtest.h"
+#include "nodes.h"
+#include "optimizing_unit_test.h"
+
+namespace art HIDDEN {
+
+class PartialEscapeAnalysisTest : public OptimizingUnitTest {
+ protected:
+  // Builds
+  //
+  //   obj = new Obj();
+  //   if (param) {
+  //     // LEFT
+  //     call_func(obj);
+  //   } else {
+  //     // RIGHT
+  //   }
+  //   // BRETURN
+  //
+  // and returns the blocks.
+  AdjacencyListGraph CreateDiamond() {
+    CreateGraph();
+    AdjacencyListGraph blks(SetupFromAdjacencyList("entry",
+                                                   "exit",
+                                                   { { "entry", "left" },
+                                                     { "entry", "right" },
+                                                     { "left", "breturn" },
+                                                     { "right", "breturn" },
+                                                     { "breturn", "exit" } }));
+    HBasicBlock* entry = blks.Get("entry");
+    HBasicBlock* left = blks.Get("left");
+    HBasicBlock* right = blks.Get("right");
+    HBasicBlock* breturn = blks.Get("breturn");
+    HInstruction* bool_value = MakeParam(DataType::Type::kBool);
+
+    cls_ = MakeClassLoad();
+    new_inst_ = MakeNewInstance(cls_);
+    entry->AddInstruction(cls_);
+    entry->AddInstruction(new_inst_);
+    entry->AddInstruction(new (GetAllocator()) HIf(bool_value));
+    ManuallyBuildEnvFor(cls_, {});
+    new_inst_->CopyEnvironmentFrom(cls_->GetEnvironment());
+
+    call_left_ = MakeInvoke(DataType::Type::kVoid, { new_inst_ });
+    left->AddInstruction(call_left_);
+    left->AddInstruction(new (GetAllocator()) HGoto());
+    call_left_->CopyEnvironmentFrom(cls_->GetEnvironment());
+
+    right->AddInstruction(new (GetAllocator()) HGoto());
+    breturn->AddInstruction(new (GetAllocator()) HReturnVoid());
+    SetupExit(blks.Get("exit"));
+    return blks;
+  }
+
+  bool PerformPartialEscapeAnalysis() {
+    graph_->ClearDominanceInformation();
+    graph_->BuildDominatorTree();
+    PartialEscapeAnalysis pea(graph_, /* stats= */ nullptr);
+    bool changed = pea.Run();
+    std::ostringstream oss;
+    EXPECT_TRUE(CheckGraph(oss)) << oss.str();
+    return changed;
+  }
+
+  HInstruction* cls_ = nullptr;
+  HNewInstance* new_inst_ = nullptr;
+  HInstruction* call_left_ = nullptr;
+};
+
+// // ENTRY
+// obj = new Obj();
+// obj.field = 1;
+// if (param) {
+//   // LEFT
+//   call_func(obj);
+// } else {
+//   // RIGHT
+//   use(obj.field);
+// }
+TEST_F(PartialEscapeAnalysisTest, MaterializeInEscapingBranch) {
+  AdjacencyListGraph blks(CreateDiamond());
+  HBasicBlock* entry = blks.Get("entry");
+  HBasicBlock* left = blks.Get("left");
+  HBasicBlock* right = blks.Get("right");
+  HInstruction* c1 = graph_->GetIntConstant(1);
+
+  HInstruction* write_entry = MakeIFieldSet(new_inst_, c1, MemberOffset(32));
+  entry->InsertInstructionBefore(write_entry, entry->GetLastInstruction());
+
+  HInstruction* read_right = MakeIFieldGet(new_inst_, DataType::Type::kInt32, MemberOffset(32));
+  HInstruction* use_right = MakeInvoke(DataType::Type::kVoid, { read_right });
+  right->InsertInstructionBefore(read_right, right->GetLastInstruction());
+  right->InsertInstructionBefore(use_right, right->GetLastInstruction());
+  use_right->CopyEnvironmentFrom(cls_->GetEnvironment());
+
+  ASSERT_TRUE(PerformPartialEscapeAnalysis());
+
+  EXPECT_INS_REMOVED(read_right);
+  EXPECT_INS_REMOVED(write_entry);
+  EXPECT_INS_EQ(use_right->InputAt(0), c1);
+  ASSERT_EQ(new_inst_->GetBlock(), left);
+  EXPECT_EQ(left->GetFirstInstruction(), new_inst_);
+  HInstruction* materialized_write = new_inst_->GetNext();
+  ASSERT_TRUE(materialized_write->IsInstanceFieldSet()) << *materialized_write;
+  EXPECT_INS_EQ(materialized_write->InputAt(0), new_inst_);
+  EXPECT_INS_EQ(materialized_write->InputAt(1), c1);
+  EXPECT_EQ(materialized_write->GetNext(), call_left_);
+}
+
+// // ENTRY
+// obj = new Obj();
+// if (param) {
+//   // LEFT
+//   call_func(obj);
+// } else {
+//   // RIGHT
+//   use(obj.field);
+// }
+TEST_F(PartialEscapeAnalysisTest, DefaultValueIsNotStored) {
+  AdjacencyListGraph blks(CreateDiamond());
+  HBasicBlock* left = blks.Get("left");
+  HBasicBlock* right = blks.Get("right");
+
+  HInstruction* read_right = MakeIFieldGet(new_inst_, DataType::Type::kInt64, MemberOffset(32));
+  HInstruction* use_right = MakeInvoke(DataType::Type::kVoid, { read_right });
+  right->InsertInstructionBefore(read_right, right->GetLastInstruction());
+  right->InsertInstructionBefore(use_right, right->GetLastInstruction());
+  use_right->CopyEnvironmentFrom(cls_->GetEnvironment());
+
+  ASSERT_TRUE(PerformPartialEscapeAnalysis());
+
+  EXPECT_INS_REMOVED(read_right);
+  EXPECT_INS_EQ(use_right->InputAt(0), graph_->GetLongConstant(0));
+  ASSERT_EQ(new_inst_->GetBlock(), left);
+  EXPECT_EQ(new_inst_->GetNext(), call_left_);
+}
+
+// // ENTRY
+// obj = new Obj();
+// obj.field = 1;
+// if (param) {
+//   // LEFT
+//   call_func(obj);
+// } else {
+//   // RIGHT
+// }
+// // BRETURN
+// use(obj.field);  // The object may have escaped, nothing to do.
+TEST_F(PartialEscapeAnalysisTest, UseAfterMergeIsNotOptimized) {
+  AdjacencyListGraph blks(CreateDiamond());
+  HBasicBlock* entry = blks.Get("entry");
+  HBasicBlock* breturn = blks.Get("breturn");
+  HInstruction* c1 = graph_->GetIntConstant(1);
+
+  HInstruction* write_entry = MakeIFieldSet(new_inst_, c1, MemberOffset(32));
+  entry->InsertInstructionBefore(write_entry, entry->GetLastInstruction());
+
+  HInstruction* read_bottom = MakeIFieldGet(new_inst_, DataType::Type::kInt32, MemberOffset(32));
+  HInstruction* use_bottom = MakeInvoke(DataType::Type::kVoid, { read_bottom });
+  breturn->InsertInstructionBefore(read_bottom, breturn->GetLastInstruction());
+  breturn->InsertInstructionBefore(use_bottom, breturn->GetLastInstruction());
+  use_bottom->CopyEnvironmentFrom(cls_->GetEnvironment());
+
+  EXPECT_FALSE(PerformPartialEscapeAnalysis());
+
+  EXPECT_INS_RETAINED(read_bottom);
+  EXPECT_INS_RETAINED(write_entry);
+  EXPECT_EQ(new_inst_->GetBlock(), entry);
+}
+
+}  // namespace art
@@ -0,0 +1,167 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "partial_redundancy_elimination.h"
+
+#include "base/scoped_arena_allocator.h"
+#include "base/scoped_arena_containers.h"
+#include "reference_type_propagation.h"
+#include "side_effects_analysis.h"
+
+namespace art HIDDEN {
+
+// Returns whether replacing a recomputation of `instruction` with a phi is likely to pay off.
+// A phi is resolved with moves on the incoming edges, so cheap arithmetic is left alone.
+static bool IsProfitableToEliminate(HInstruction* instruction) {
+  switch (instruction->GetKind()) {
+    case HInstruction::kInstanceFieldGet:
+    case HInstruction::kStaticFieldGet:
+    case HInstruction::kArrayGet:
+    case HInstruction::kArrayLength:
+    case HInstruction::kMul:
+    case HInstruction::kDiv:
+    case HInstruction::kRem:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// Returns whether `instruction` in the merge block `block` can be computed at the end of the
+// predecessors of `block` instead.
+static bool IsCandidate(HInstruction* instruction, HBasicBlock* block) {
+  if (!instruction->CanBeMoved() ||
+      instruction->CanThrow() ||
+      instruction->NeedsEnvironment() ||
+      instruction->GetSideEffects().DoesAnyWrite() ||
+      !instruction->IsClonable() ||
+      !IsProfitableToEliminate(instruction)) {
+    return false;
+  }
+  // Inputs defined outside `block` dominate it, and hence are available in every predecessor.
+  for (HInstruction* input : instruction->GetInputs()) {
+    if (input->GetBlock() == block) {
+      return false;
+    }
+  }
+  return true;
+}
+
+HInstruction* PartialRedundancyElimination::FindAvailableAtEnd(HInstruction* instruction,
+                                                               HBasicBlock* predecessor) const {
+  // Walk up the chain of blocks with a single predecessor, so that every instruction visited
+  // dominates the end of `predecessor`, and stop once a side effect may change the value.
+  SideEffects killed = SideEffects::None();
+  for (HBasicBlock* current = predecessor; current != nullptr; ) {
+    SideEffects killed_in_block = SideEffects::None();
+    for (HBackwardInstructionIterator it(current->GetInstructions()); !it.Done(); it.Advance()) {
+      HInstruction* other = it.Current();
+      if (other->Equals(instruction)) {
+        return other;
+      }
+      killed_in_block = killed_in_block.Union(other->GetSideEffects());
+      if (instruction->GetSideEffects().MayDependOn(killed_in_block)) {
+        return nullptr;
+      }
+    }
+    killed = killed.Union(side_effects_.GetBlockEffects(current));
+    if (instruction->GetSideEffects().MayDependOn(killed) ||
+        current->GetPredecessors().size() != 1u) {
+      break;
+    }
+    current = current->GetSinglePredecessor();
+  }
+  return nullptr;
+}
+
+bool PartialRedundancyElimination::TryEliminateInMergeBlock(HBasicBlock* block) {
+  const ArenaVector<HBasicBlock*>& predecessors = block->GetPredecessors();
+  if (predecessors.size() < 2u || block->IsLoopHeader() || block->IsCatchBlock()) {
+    return false;
+  }
+  // Copies are inserted before the goto at the end of a predecessor.
+  for (HBasicBlock* predecessor : predecessors) {
+    if (!predecessor->GetLastInstruction()->IsGoto()) {
+      return false;
+    }
+  }
+
+  ScopedArenaAllocator allocator(graph_->GetArenaStack());
+  ScopedArenaVector<HInstruction*> values(predecessors.size(),
+                                          nullptr,
+                                          allocator.Adapter(kArenaAllocOptimization));
+  size_t number_of_phis = block->GetPhis().CountSize();
+  // Side effects of the instructions of `block` before the current one.
+  SideEffects preceding = SideEffects::None();
+  bool changed = false;
+  for (HInstructionIterator it(block->GetInstructions()); !it.Done(); it.Advance()) {
+    HInstruction* instruction = it.Current();
+    SideEffects side_effects = instruction->GetSideEffects();
+    if (number_of_phis < kMaxPhisInMergeBlock &&
+        IsCandidate(instruction, block) &&
+        !side_effects.MayDependOn(preceding)) {
+      size_t number_of_missing = 0u;
+      for (size_t i = 0; i != predecessors.size(); ++i) {
+        values[i] = FindAvailableAtEnd(instruction, predecessors[i]);
+        if (values[i] == nullptr) {
+          ++number_of_missing;
+        }
+      }
+      // Insert copies only if that makes the computation redundant on some path.
+      if (number_of_missing != predecessors.size() &&
+          number_of_missing <= kMaxInsertionsPerInstruction) {
+        ArenaAllocator* graph_allocator = graph_->GetAllocator();
+        HPhi* phi = new (graph_allocator) HPhi(
+            graph_allocator, kNoRegNumber, predecessors.size(), instruction->GetType());
+        for (size_t i = 0; i != predecessors.size(); ++i) {
+          if (values[i] == nullptr) {
+            values[i] = instruction->Clone(graph_allocator);
+            predecessors[i]->InsertInstructionBefore(values[i],
+                                                     predecessors[i]->GetLastInstruction());
+          }
+          phi->SetRawInputAt(i, values[i]);
+        }
+        block->AddPhi(phi);
+        if (phi->GetType() == DataType::Type::kReference) {
+          // Update reference type information. Pass invalid handles, these are not used for Phis.
+          ReferenceTypePropagation rtp_fixup(graph_,
+                                             Handle<mirror::DexCache>(),
+                                             /* is_first_run= */ false);
+          rtp_fixup.Visit(phi);
+        }
+        instruction->ReplaceWith(phi);
+        block->RemoveInstruction(instruction);
+        ++number_of_phis;
+        changed = true;
+        MaybeRecordStat(stats_, MethodCompilationStat::kPartialRedundancyEliminated);
+        continue;
+      }
+    }
+    preceding = preceding.Union(side_effects);
+  }
+  return changed;
+}
+
+bool PartialRedundancyElimination::Run() {
+  DCHECK(side_effects_.HasRun());
+  bool changed = false;
+  for (HBasicBlock* block : graph_->GetReversePostOrder()) {
+    changed |= TryEliminateInMergeBlock(block);
+  }
+  return changed;
+}
+
+}  // namespace art
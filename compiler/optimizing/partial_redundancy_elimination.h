@@ -0,0 +1,78 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_COMPILER_OPTIMIZING_PARTIAL_REDUNDANCY_ELIMINATION_H_
+#define ART_COMPILER_OPTIMIZING_PARTIAL_REDUNDANCY_ELIMINATION_H_
+
+#include "base/macros.h"
+#include "nodes.h"
+#include "optimization.h"
+
+namespace art HIDDEN {
+
+class SideEffectsAnalysis;
+
+// Removes computations that are redundant on some, but not all, incoming paths of a merge block.
+//
+// GVN only removes computations that are available on every path. For a computation in a merge
+// block whose value is already available at the end of some predecessors, this pass inserts a
+// copy at the end of the predecessors where it is not available (the latest placement, as in
+// lazy code motion) and replaces the computation with a phi:
+//
+//   if (c) {                            if (c) {
+//     x = o.f;                            x = o.f;
+//   }                         ==>       } else {
+//   y = o.f;                              t = o.f;
+//                                       }
+//                                       y = Phi(x, t);
+//
+// No path computes the value more often than before. Only computations that are expensive
+// compared to a phi move are considered, and the number of phis in a merge block is bounded so
+// that the pass does not raise register pressure for the register allocator.
+class PartialRedundancyElimination : public HOptimization {
+ public:
+  PartialRedundancyElimination(HGraph* graph,
+                               const SideEffectsAnalysis& side_effects,
+                               OptimizingCompilerStats* stats,
+                               const char* name = kPartialRedundancyEliminationPassName)
+      : HOptimization(graph, name, stats), side_effects_(side_effects) {}
+
+  bool Run() override;
+
+  static constexpr const char* kPartialRedundancyEliminationPassName =
+      "partial_redundancy_elimination";
+
+  // Maximum number of phis in a merge block after the transformation.
+  static constexpr size_t kMaxPhisInMergeBlock = 6;
+
+  // Maximum number of copies inserted for a single computation.
+  static constexpr size_t kMaxInsertionsPerInstruction = 1;
+
+ private:
+  bool TryEliminateInMergeBlock(HBasicBlock* block);
+
+  // Returns an instruction equivalent to `instruction` that is available at the end of
+  // `predecessor`, or nullptr if there is none.
+  HInstruction* FindAvailableAtEnd(HInstruction* instruction, HBasicBlock* predecessor) const;
+
+  const SideEffectsAnalysis& side_effects_;
+
+  DISALLOW_COPY_AND_ASSIGN(PartialRedundancyElimination);
+};
+
+}  // namespace art
+
+#endif  // ART_COMPILER_OPTIMIZING_PARTIAL_REDUNDANCY_ELIMINATION_H_
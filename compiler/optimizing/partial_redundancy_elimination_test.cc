@@ -0,0 +1,165 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "partial_redundancy_elimination.h"
+
+#include "gtest/gtest.h"
+#include "nodes.h"
+#include "optimizing_unit_test.h"
+#include "side_effects_analysis.h"
+
+namespace art HIDDEN {
+
+class PartialRedundancyEliminationTest : public OptimizingUnitTest {
+ protected:
+  // Builds
+  //
+  //   if (param) {
+  //     // LEFT
+  //   } else {
+  //     // RIGHT
+  //   }
+  //   // BRETURN
+  //
+  // and returns the blocks.
+  AdjacencyListGraph CreateDiamond() {
+    CreateGraph();
+    AdjacencyListGraph blks(SetupFromAdjacencyList("entry",
+                                                   "exit",
+                                                   { { "entry", "left" },
+                                                     { "entry", "right" },
+                                                     { "left", "breturn" },
+                                                     { "right", "breturn" },
+                                                     { "breturn", "exit" } }));
+    obj_ = MakeParam(DataType::Type::kReference);
+    int_param1_ = MakeParam(DataType::Type::kInt32);
+    int_param2_ = MakeParam(DataType::Type::kInt32);
+    HInstruction* bool_value = MakeParam(DataType::Type::kBool);
+    blks.Get("entry")->AddInstruction(new (GetAllocator()) HIf(bool_value));
+    blks.Get("left")->AddInstruction(new (GetAllocator()) HGoto());
+    blks.Get("right")->AddInstruction(new (GetAllocator()) HGoto());
+    SetupExit(blks.Get("exit"));
+    return blks;
+  }
+
+  bool PerformPartialRedundancyElimination() {
+    graph_->ClearDominanceInformation();
+    graph_->BuildDominatorTree();
+    SideEffectsAnalysis side_effects(graph_);
+    side_effects.Run();
+    PartialRedundancyElimination pre(graph_, side_effects, /* stats= */ nullptr);
+    bool changed = pre.Run();
+    std::ostringstream oss;
+    EXPECT_TRUE(CheckGraph(oss)) << oss.str();
+    return changed;
+  }
+
+  HInstruction* obj_ = nullptr;
+  HInstruction* int_param1_ = nullptr;
+  HInstruction* int_param2_ = nullptr;
+};
+
+// if (param) {
+//   // LEFT
+//   x = obj.field;
+// } else {
+//   // RIGHT
+// }
+// // BRETURN
+// return obj.field;  // Redundant on the left path.
+TEST_F(PartialRedundancyEliminationTest, LoadRedundantOnOnePath) {
+  AdjacencyListGraph blks(CreateDiamond());
+  HBasicBlock* left = blks.Get("left");
+  HBasicBlock* right = blks.Get("right");
+  HBasicBlock* breturn = blks.Get("breturn");
+
+  HInstruction* read_left = MakeIFieldGet(obj_, DataType::Type::kInt32, MemberOffset(32));
+  left->InsertInstructionBefore(read_left, left->GetLastInstruction());
+  HInstruction* read_bottom = MakeIFieldGet(obj_, DataType::Type::kInt32, MemberOffset(32));
+  HInstruction* return_bottom = new (GetAllocator()) HReturn(read_bottom);
+  breturn->AddInstruction(read_bottom);
+  breturn->AddInstruction(return_bottom);
+
+  ASSERT_TRUE(PerformPartialRedundancyElimination());
+
+  EXPECT_INS_REMOVED(read_bottom);
+  EXPECT_INS_RETAINED(read_left);
+  HInstruction* read_right = right->GetFirstInstruction();
+  ASSERT_TRUE(read_right->IsInstanceFieldGet()) << *read_right;
+  EXPECT_TRUE(read_right->Equals(read_left));
+  HPhi* phi = return_bottom->InputAt(0)->AsPhiOrNull();
+  ASSERT_NE(phi, nullptr);
+  EXPECT_EQ(phi->GetBlock(), breturn);
+  EXPECT_INS_EQ(phi->InputAt(breturn->GetPredecessorIndexOf(left)), read_left);
+  EXPECT_INS_EQ(phi->InputAt(breturn->GetPredecessorIndexOf(right)), read_right);
+}
+
+// if (param) {
+//   // LEFT
+//   x = obj.field;
+//   obj.field = 1;
+// } else {
+//   // RIGHT
+// }
+// // BRETURN
+// return obj.field;  // Not available on any path.
+TEST_F(PartialRedundancyEliminationTest, LoadKilledByStore) {
+  AdjacencyListGraph blks(CreateDiamond());
+  HBasicBlock* left = blks.Get("left");
+  HBasicBlock* right = blks.Get("right");
+  HBasicBlock* breturn = blks.Get("breturn");
+
+  HInstruction* read_left = MakeIFieldGet(obj_, DataType::Type::kInt32, MemberOffset(32));
+  HInstruction* write_left = MakeIFieldSet(obj_, graph_->GetIntConstant(1), MemberOffset(32));
+  left->InsertInstructionBefore(read_left, left->GetLastInstruction());
+  left->InsertInstructionBefore(write_left, left->GetLastInstruction());
+  HInstruction* read_bottom = MakeIFieldGet(obj_, DataType::Type::kInt32, MemberOffset(32));
+  breturn->AddInstruction(read_bottom);
+  breturn->AddInstruction(new (GetAllocator()) HReturn(read_bottom));
+
+  EXPECT_FALSE(PerformPartialRedundancyElimination());
+
+  EXPECT_INS_RETAINED(read_bottom);
+  EXPECT_EQ(right->GetFirstInstruction(), right->GetLastInstruction());
+}
+
+// if (param) {
+//   // LEFT
+//   x = int1 + int2;
+// } else {
+//   // RIGHT
+// }
+// // BRETURN
+// return int1 + int2;  // Cheaper to recompute than to merge.
+TEST_F(PartialRedundancyEliminationTest, CheapArithmeticIsNotMoved) {
+  AdjacencyListGraph blks(CreateDiamond());
+  HBasicBlock* left = blks.Get("left");
+  HBasicBlock* breturn = blks.Get("breturn");
+
+  HInstruction* add_left =
+      new (GetAllocator()) HAdd(DataType::Type::kInt32, int_param1_, int_param2_);
+  left->InsertInstructionBefore(add_left, left->GetLastInstruction());
+  HInstruction* add_bottom =
+      new (GetAllocator()) HAdd(DataType::Type::kInt32, int_param1_, int_param2_);
+  breturn->AddInstruction(add_bottom);
+  breturn->AddInstruction(new (GetAllocator()) HReturn(add_bottom));
+
+  EXPECT_FALSE(PerformPartialRedundancyElimination());
+
+  EXPECT_INS_RETAINED(add_bottom);
+}
+
+}  // namespace art
@@ -129,6 +129,7 @@ void PrepareForRegisterAllocation::VisitClinitCheck(HClinitCheck* check) {
       } else {
         DCHECK(user->IsNewInstance());
         // We delegate the initialization duty to the allocation.
+        DCHECK_NE(user->AsNewInstance()->GetEntrypoint(), kQuickAllocObjectNonMoving);
         if (user->AsNewInstance()->GetEntrypoint() == kQuickAllocObjectInitialized) {
           user->AsNewInstance()->SetEntrypoint(kQuickAllocObjectResolved);
         }
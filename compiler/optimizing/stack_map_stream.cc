@@ -52,7 +52,8 @@ void StackMapStream::BeginMethod(size_t frame_size_in_bytes,
                                  uint32_t num_dex_registers,
                                  bool baseline,
                                  bool debuggable,
-                                 bool has_should_deoptimize_flag) {
+                                 bool has_should_deoptimize_flag,
+                                 bool baseline_plus) {
   DCHECK(!in_method_) << "Mismatched Begin/End calls";
   in_method_ = true;
   DCHECK_EQ(packed_frame_size_, 0u) << "BeginMethod was already called";
@@ -63,6 +64,8 @@ void StackMapStream::BeginMethod(size_t frame_size_in_bytes,
   fp_spill_mask_ = fp_spill_mask;
   num_dex_registers_ = num_dex_registers;
   baseline_ = baseline;
+  DCHECK_IMPLIES(baseline_plus, baseline);
+  baseline_plus_ = baseline_plus;
   debuggable_ = debuggable;
   has_should_deoptimize_flag_ = has_should_deoptimize_flag;
 
@@ -374,6 +377,38 @@ void StackMapStream::CreateDexRegisterMap() {
   }
 }
 
+void StackMapStream::AddCHADependencies(const ArenaSet<ArtMethod*>& methods,
+                                        const DexFile* outer_dex_file,
+                                        const CodeGenerator* codegen) {
+  DCHECK(in_method_) << "Call BeginMethod first";
+  ScopedArenaVector<BitTableBuilder<MethodInfo>::Entry> entries(
+      allocator_->Adapter(kArenaAllocStackMapStream));
+  ScopedObjectAccess soa(Thread::Current());
+  for (ArtMethod* method : methods) {
+    DCHECK(!method->GetDeclaringClass()->IsBootStrapClassLoaded());
+    const DexFile* dex_file = method->GetDexFile();
+    uint32_t dexfile_index = MethodInfo::kSameDexFile;
+    if (!IsSameDexFile(*outer_dex_file, *dex_file)) {
+      const std::vector<const DexFile*>& dex_files =
+          codegen->GetCompilerOptions().GetDexFilesForOatFile();
+      auto it = std::find_if(dex_files.begin(), dex_files.end(), [dex_file](const DexFile* df) {
+        return IsSameDexFile(*df, *dex_file);
+      });
+      DCHECK(it != dex_files.end());
+      dexfile_index = std::distance(dex_files.begin(), it);
+    }
+    entries.push_back({method->GetDexMethodIndex(), MethodInfo::kKindNonBCP, dexfile_index});
+  }
+  // Do not let the ArtMethod addresses determine the order of the table.
+  std::sort(entries.begin(), entries.end(), [](const auto& lhs, const auto& rhs) {
+    return std::make_pair(lhs[MethodInfo::kDexFileIndex], lhs[MethodInfo::kMethodIndex]) <
+           std::make_pair(rhs[MethodInfo::kDexFileIndex], rhs[MethodInfo::kMethodIndex]);
+  });
+  for (const BitTableBuilder<MethodInfo>::Entry& entry : entries) {
+    cha_dependencies_.Dedup(entry);
+  }
+}
+
 ScopedArenaVector<uint8_t> StackMapStream::Encode() {
   DCHECK(in_stack_map_ == false) << "Mismatched Begin/End calls";
   DCHECK(in_inline_info_ == false) << "Mismatched Begin/End calls";
@@ -381,6 +416,7 @@ ScopedArenaVector<uint8_t> StackMapStream::Encode() {
   uint32_t flags = 0;
   flags |= (inline_infos_.size() > 0) ? CodeInfo::kHasInlineInfo : 0;
   flags |= baseline_ ? CodeInfo::kIsBaseline : 0;
+  flags |= baseline_plus_ ? CodeInfo::kIsBaselinePlus : 0;
   flags |= debuggable_ ? CodeInfo::kIsDebuggable : 0;
   flags |= has_should_deoptimize_flag_ ? CodeInfo::kHasShouldDeoptimizeFlag : 0;
 
@@ -415,6 +451,7 @@ ScopedArenaVector<uint8_t> StackMapStream::Encode() {
   CHECK_EQ(code_info.GetNumberOfStackMaps(), stack_maps_.size());
   CHECK_EQ(CodeInfo::HasInlineInfo(buffer.data()), inline_infos_.size() > 0);
   CHECK_EQ(CodeInfo::IsBaseline(buffer.data()), baseline_);
+  CHECK_EQ(CodeInfo::IsBaselinePlus(buffer.data()), baseline_plus_);
   CHECK_EQ(CodeInfo::IsDebuggable(buffer.data()), debuggable_);
   CHECK_EQ(CodeInfo::HasShouldDeoptimizeFlag(buffer.data()), has_should_deoptimize_flag_);
 
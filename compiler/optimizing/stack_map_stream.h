@@ -50,6 +50,7 @@ class StackMapStream : public DeletableArenaObject<kArenaAllocStackMapStream> {
         dex_register_masks_(allocator),
         dex_register_maps_(allocator),
         dex_register_catalog_(allocator),
+        cha_dependencies_(allocator),
         lazy_stack_masks_(allocator->Adapter(kArenaAllocStackMapStream)),
         current_stack_map_(),
         current_inline_infos_(allocator->Adapter(kArenaAllocStackMapStream)),
@@ -67,7 +68,8 @@ class StackMapStream : public DeletableArenaObject<kArenaAllocStackMapStream> {
                    uint32_t num_dex_registers,
                    bool baseline,
                    bool debuggable,
-                   bool has_should_deoptimize_flag = false);
+                   bool has_should_deoptimize_flag = false,
+                   bool baseline_plus = false);
   void EndMethod(size_t code_size);
 
   void BeginStackMapEntry(
@@ -92,6 +94,12 @@ class StackMapStream : public DeletableArenaObject<kArenaAllocStackMapStream> {
                             const CodeGenerator* codegen = nullptr);
   void EndInlineInfoEntry();
 
+  // Record that AOT compiled code relies on `methods` of the oat file's dex files having
+  // a single implementation.
+  void AddCHADependencies(const ArenaSet<ArtMethod*>& methods,
+                          const DexFile* outer_dex_file,
+                          const CodeGenerator* codegen);
+
   size_t GetNumberOfStackMaps() const {
     return stack_maps_.size();
   }
@@ -120,6 +128,7 @@ class StackMapStream : public DeletableArenaObject<kArenaAllocStackMapStream> {
     callback(index++, &dex_register_masks_);
     callback(index++, &dex_register_maps_);
     callback(index++, &dex_register_catalog_);
+    callback(index++, &cha_dependencies_);
     CHECK_EQ(index, CodeInfo::kNumBitTables);
   }
 
@@ -131,6 +140,7 @@ class StackMapStream : public DeletableArenaObject<kArenaAllocStackMapStream> {
   uint32_t fp_spill_mask_ = 0;
   uint32_t num_dex_registers_ = 0;
   bool baseline_ = false;
+  bool baseline_plus_ = false;
   bool debuggable_ = false;
   bool has_should_deoptimize_flag_ = false;
   BitTableBuilder<StackMap> stack_maps_;
@@ -141,6 +151,7 @@ class StackMapStream : public DeletableArenaObject<kArenaAllocStackMapStream> {
   BitmapTableBuilder dex_register_masks_;
   BitTableBuilder<DexRegisterMapInfo> dex_register_maps_;
   BitTableBuilder<DexRegisterInfo> dex_register_catalog_;
+  BitTableBuilder<MethodInfo> cha_dependencies_;
 
   ScopedArenaVector<BitVector*> lazy_stack_masks_;
 
@@ -765,4 +765,37 @@ TEST(StackMapTest, TestDeduplicateStackMask) {
             stack_map2.GetStackMaskIndex());
 }
 
+TEST(StackMapTest, TestBaselineFlags) {
+  MallocArenaPool pool;
+  ArenaStack arena_stack(&pool);
+  ScopedArenaAllocator allocator(&arena_stack);
+  // Optimized, baseline and baseline-plus code, which is also baseline code.
+  const bool kBaselineFlags[][2] = {{false, false}, {true, false}, {true, true}};
+  for (const bool* flags : kBaselineFlags) {
+    const bool baseline = flags[0];
+    const bool baseline_plus = flags[1];
+    StackMapStream stream(&allocator, kRuntimeISA);
+    stream.BeginMethod(/* frame_size_in_bytes= */ 32,
+                       /* core_spill_mask= */ 0,
+                       /* fp_spill_mask= */ 0,
+                       /* num_dex_registers= */ 0,
+                       baseline,
+                       /* debuggable= */ false,
+                       /* has_should_deoptimize_flag= */ false,
+                       baseline_plus);
+    ArenaBitVector sp_mask(&allocator, 0, false);
+    stream.BeginStackMapEntry(0, 4 * kPcAlign, 0x3, &sp_mask);
+    stream.EndStackMapEntry();
+    stream.EndMethod(4 * kPcAlign);
+    ScopedArenaVector<uint8_t> memory = stream.Encode();
+
+    EXPECT_EQ(baseline, CodeInfo::IsBaseline(memory.data()));
+    EXPECT_EQ(baseline_plus, CodeInfo::IsBaselinePlus(memory.data()));
+    EXPECT_FALSE(CodeInfo::IsDebuggable(memory.data()));
+    EXPECT_FALSE(CodeInfo::HasShouldDeoptimizeFlag(memory.data()));
+    CodeInfo code_info(memory.data());
+    EXPECT_EQ(1u, code_info.GetNumberOfStackMaps());
+  }
+}
+
 }  // namespace art
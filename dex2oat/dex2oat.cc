@@ -515,7 +515,7 @@ class Dex2Oat final {
         key_value_store_(nullptr),
         verification_results_(nullptr),
         runtime_(nullptr),
-        thread_count_(sysconf(_SC_NPROCESSORS_CONF)),
+        thread_count_(GetEffectiveCpuCount()),
         start_ns_(NanoTime()),
         start_cputime_ns_(ProcessCpuNanoTime()),
         strip_(false),
@@ -977,6 +977,8 @@ class Dex2Oat final {
     key_value_store_->Put(OatHeader::kCompilerFilter,
                           CompilerFilter::NameOfFilter(compiler_options_->GetCompilerFilter()));
     key_value_store_->Put(OatHeader::kConcurrentCopying, compiler_options_->EmitReadBarrier());
+    key_value_store_->Put(OatHeader::kAssumeClosedClassHierarchyKey,
+                          compiler_options_->AssumeClosedClassHierarchy());
     if (invocation_file_.get() != -1) {
       std::ostringstream oss;
       for (int i = 0; i < argc; ++i) {
@@ -2762,6 +2764,12 @@ class Dex2Oat final {
     InitializeIntrinsics();
     runtime_->RunRootClinits(self);
 
+    if (compiler_options_->AssumeClosedClassHierarchy()) {
+      // Record single-implementation info of the app classes we are about to load, so that
+      // the compiler can devirtualize on it.
+      runtime_->GetClassLinker()->EnableClassHierarchyAnalysis();
+    }
+
     // Runtime::Create acquired the mutator_lock_ that is normally given away when we
     // Runtime::Start, give it away now so that we don't starve GC.
     self->TransitionFromRunnableToSuspended(ThreadState::kNative);
@@ -281,6 +281,22 @@ class HashSet {
     other.data_ = nullptr;
   }
 
+  // Create a read-only view of the data of `other`. The view does not own the data, so it must
+  // not outlive `other`'s storage and `other` must not be modified while the view is in use.
+  static HashSet CreateView(const HashSet& other) {
+    HashSet view(other.min_load_factor_,
+                 other.max_load_factor_,
+                 other.hashfn_,
+                 other.pred_,
+                 other.allocfn_);
+    view.num_elements_ = other.num_elements_;
+    view.num_buckets_ = other.num_buckets_;
+    view.elements_until_expand_ = other.elements_until_expand_;
+    view.data_ = other.data_;
+    DCHECK(!view.owns_data_);
+    return view;
+  }
+
   // Construct with pre-existing buffer, usually stack-allocated,
   // to avoid malloc/free overhead for small HashSet<>s.
   HashSet(value_type* buffer, size_t buffer_size)
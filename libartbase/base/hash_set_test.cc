@@ -394,6 +394,20 @@ TEST_F(HashSetTest, Preallocated) {
   ASSERT_TRUE(hash_set.owns_data_);
 }
 
+TEST_F(HashSetTest, View) {
+  HashSet<uint32_t> hash_set;
+  for (uint32_t i = 0; i != 100u; ++i) {
+    hash_set.insert(i);
+  }
+  HashSet<uint32_t> view = HashSet<uint32_t>::CreateView(hash_set);
+  ASSERT_FALSE(view.owns_data_);
+  ASSERT_EQ(hash_set.size(), view.size());
+  for (uint32_t i = 0; i != 100u; ++i) {
+    ASSERT_TRUE(view.find(i) != view.end());
+  }
+  ASSERT_TRUE(view.find(100u) == view.end());
+}
+
 class SmallIndexEmptyFn {
  public:
   void MakeEmpty(uint16_t& item) const {
@@ -873,6 +873,24 @@ int MemMap::MadviseDontFork() {
   return -1;
 }
 
+int MemMap::MadviseHugePages() {
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+  if (base_begin_ != nullptr || base_size_ != 0) {
+    return madvise(base_begin_, base_size_, MADV_HUGEPAGE);
+  }
+#endif
+  return -1;
+}
+
+int MemMap::MadviseFree() {
+#if defined(__linux__) && defined(MADV_FREE)
+  if (base_begin_ != nullptr || base_size_ != 0) {
+    return madvise(base_begin_, base_size_, MADV_FREE);
+  }
+#endif
+  return -1;
+}
+
 bool MemMap::Sync() {
 #ifdef _WIN32
   // TODO: add FlushViewOfFile support.
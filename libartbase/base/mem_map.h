@@ -267,6 +267,12 @@ class MemMap {
     FillWithZero(/* release_eagerly= */ true);
   }
   int MadviseDontFork();
+  // Ask the kernel to back the mapping with transparent huge pages where the mapping covers
+  // whole, suitably aligned huge pages. Returns -1 if not supported.
+  int MadviseHugePages();
+  // Let the kernel reclaim the pages of the mapping lazily, when under memory pressure. Until
+  // then, the pages keep their contents. Returns -1 if not supported.
+  int MadviseFree();
 
   int GetProtect() const {
     return prot_;
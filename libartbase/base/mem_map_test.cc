@@ -604,6 +604,63 @@ TEST_F(MemMapTest, MapAnonymousReuse) {
   ASSERT_TRUE(error_msg.empty());
 }
 
+TEST_F(MemMapTest, MadviseHugePages) {
+  CommonInit();
+  std::string error_msg;
+  MemMap map = MemMap::MapAnonymousAligned("MadviseHugePages",
+                                           /*byte_count=*/ 2 * gPMDSize,
+                                           PROT_READ | PROT_WRITE,
+                                           /*low_4gb=*/ false,
+                                           /*alignment=*/ gPMDSize,
+                                           &error_msg);
+  ASSERT_TRUE(map.IsValid()) << error_msg;
+  ASSERT_TRUE(IsAlignedParam(map.Begin(), gPMDSize));
+  // The kernel may be built without transparent huge page support, in which case
+  // madvise() fails with EINVAL.
+  int result = map.MadviseHugePages();
+#if defined(__linux__)
+  if (result != 0) {
+    ASSERT_EQ(EINVAL, errno);
+  }
+#else
+  UNUSED(result);
+#endif
+  // The mapping remains usable.
+  map.Begin()[0] = 1u;
+  map.End()[-1] = 1u;
+  EXPECT_EQ(1u, map.Begin()[0]);
+  EXPECT_EQ(1u, map.End()[-1]);
+}
+
+TEST_F(MemMapTest, MadviseFree) {
+  CommonInit();
+  std::string error_msg;
+  MemMap map = MemMap::MapAnonymous("MadviseFree",
+                                    /*byte_count=*/ 4 * gPageSize,
+                                    PROT_READ | PROT_WRITE,
+                                    /*low_4gb=*/ false,
+                                    &error_msg);
+  ASSERT_TRUE(map.IsValid()) << error_msg;
+  memset(map.Begin(), 0xff, map.Size());
+  // Kernels before 4.5 do not support MADV_FREE and fail with EINVAL.
+  int result = map.MadviseFree();
+#if defined(__linux__)
+  if (result != 0) {
+    ASSERT_EQ(EINVAL, errno);
+  }
+#else
+  UNUSED(result);
+#endif
+  // Until the kernel reclaims them, the pages keep their contents. Either way, they can be
+  // zeroed and reused.
+  uint8_t first = map.Begin()[0];
+  EXPECT_TRUE(first == 0u || first == 0xffu);
+  memset(map.Begin(), 0, map.Size());
+  for (size_t i = 0; i < map.Size(); ++i) {
+    ASSERT_EQ(0u, map.Begin()[i]);
+  }
+}
+
 TEST_F(MemMapTest, CheckNoGaps) {
   CommonInit();
   std::string error_msg;
@@ -67,7 +67,13 @@
   METRIC(YoungGcDuration, MetricsCounter)                           \
   METRIC(FullGcScannedBytes, MetricsCounter)                        \
   METRIC(FullGcFreedBytes, MetricsCounter)                          \
-  METRIC(FullGcDuration, MetricsCounter)
+  METRIC(FullGcDuration, MetricsCounter)                            \
+  METRIC(GcAdaptiveTargetUtilizationAvg, MetricsAverage)            \
+  METRIC(GcAdaptiveTargetFootprintAvg, MetricsAverage)              \
+  METRIC(GcAdaptiveConcurrentStartBytesAvg, MetricsAverage)         \
+  METRIC(FinalizerReferencesEnqueued, MetricsCounter)               \
+  METRIC(ReferenceQueueHandoffDelayUsAvg, MetricsAverage)           \
+  METRIC(JitMethodCompileOverBudgetCount, MetricsCounter)
 
 // Increasing counter metrics, reported as Value Metrics in delta increments.
 #define ART_VALUE_METRICS(METRIC)                              \
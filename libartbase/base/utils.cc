@@ -19,15 +19,19 @@
 #include <dirent.h>
 #include <inttypes.h>
 #include <pthread.h>
+#include <sched.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <fstream>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "android-base/file.h"
+#include "android-base/parseint.h"
 #include "android-base/stringprintf.h"
 #include "android-base/strings.h"
 
@@ -402,4 +406,114 @@ int GetTaskCount() {
   return count;
 }
 
+uint32_t CpuCountFromCfsQuota(int64_t quota_us, int64_t period_us, uint32_t max_cpus) {
+  if (quota_us < 0 || period_us <= 0) {
+    return max_cpus;
+  }
+  int64_t cpus = std::max<int64_t>((quota_us + period_us - 1) / period_us, 1);
+  return static_cast<uint32_t>(std::min<int64_t>(cpus, max_cpus));
+}
+
+std::string GetCgroupPath(const std::string& proc_self_cgroup, const std::string& controller) {
+  // Each line is "<hierarchy id>:<controller list>:<path>". The cgroup v2 hierarchy has id 0
+  // and an empty controller list.
+  for (const std::string& line : android::base::Split(proc_self_cgroup, "\n")) {
+    size_t first_colon = line.find(':');
+    size_t second_colon =
+        (first_colon != std::string::npos) ? line.find(':', first_colon + 1) : std::string::npos;
+    if (second_colon == std::string::npos) {
+      continue;
+    }
+    std::string controllers = line.substr(first_colon + 1, second_colon - first_colon - 1);
+    bool matches = controller.empty()
+        ? (controllers.empty() && line.compare(0, first_colon, "0") == 0)
+        : ContainsElement(android::base::Split(controllers, ","), controller);
+    if (matches) {
+      return line.substr(second_colon + 1);
+    }
+  }
+  return "";
+}
+
+#if defined(__linux__)
+// Reads the CPU bandwidth quota of the cgroup directory `dir`. A negative quota means no limit.
+static bool ReadCgroupCpuQuota(const std::string& dir,
+                               bool unified,
+                               /*out*/ int64_t* quota_us,
+                               /*out*/ int64_t* period_us) {
+  if (unified) {
+    // cgroup v2: "cpu.max" holds "<quota> <period>", where the quota may be "max".
+    std::string content;
+    if (!ReadFileToString(dir + "/cpu.max", &content)) {
+      return false;
+    }
+    std::vector<std::string> fields = android::base::Split(android::base::Trim(content), " ");
+    if (fields.size() != 2u || !android::base::ParseInt(fields[1], period_us)) {
+      return false;
+    }
+    if (fields[0] == "max") {
+      *quota_us = -1;
+      return true;
+    }
+    return android::base::ParseInt(fields[0], quota_us);
+  }
+  // cgroup v1: the quota is -1 when there is no limit.
+  std::string quota_content, period_content;
+  return ReadFileToString(dir + "/cpu.cfs_quota_us", &quota_content) &&
+         ReadFileToString(dir + "/cpu.cfs_period_us", &period_content) &&
+         android::base::ParseInt(android::base::Trim(quota_content), quota_us) &&
+         android::base::ParseInt(android::base::Trim(period_content), period_us);
+}
+
+// Limits `cpu_count` by the CPU bandwidth quotas of the cgroup at `path` in the hierarchy mounted
+// at `mount`, and of its ancestors, as the quota of every ancestor applies to the process too.
+// Without a cgroup namespace, `path` may not exist under `mount`, for example in a container
+// that only sees its own cgroup at the mount root. The mount root is then still checked.
+static uint32_t ApplyCgroupCpuQuotas(const std::string& mount,
+                                     std::string path,
+                                     bool unified,
+                                     uint32_t cpu_count) {
+  while (true) {
+    int64_t quota, period;
+    if (ReadCgroupCpuQuota(mount + path, unified, &quota, &period)) {
+      cpu_count = CpuCountFromCfsQuota(quota, period, cpu_count);
+    }
+    size_t last_slash = path.rfind('/');
+    if (last_slash == std::string::npos || path == "/") {
+      break;
+    }
+    path.resize(last_slash);
+  }
+  return cpu_count;
+}
+#endif
+
+uint32_t GetEffectiveCpuCount() {
+#if defined(__linux__)
+  uint32_t cpu_count = static_cast<uint32_t>(std::max(sysconf(_SC_NPROCESSORS_CONF), 1L));
+  cpu_set_t cpu_set;
+  if (sched_getaffinity(0, sizeof(cpu_set), &cpu_set) == 0) {
+    cpu_count = std::min(cpu_count, static_cast<uint32_t>(std::max(CPU_COUNT(&cpu_set), 1)));
+  }
+  // The quota files at the mount root only belong to this process inside a cgroup namespace,
+  // so look up the cgroups of this process. Both hierarchies are checked, as a file that does
+  // not exist is simply skipped.
+  std::string proc_self_cgroup;
+  ReadFileToString("/proc/self/cgroup", &proc_self_cgroup);
+  cpu_count = ApplyCgroupCpuQuotas("/sys/fs/cgroup",
+                                   GetCgroupPath(proc_self_cgroup, /*controller=*/ ""),
+                                   /*unified=*/ true,
+                                   cpu_count);
+  cpu_count = ApplyCgroupCpuQuotas("/sys/fs/cgroup/cpu",
+                                   GetCgroupPath(proc_self_cgroup, /*controller=*/ "cpu"),
+                                   /*unified=*/ false,
+                                   cpu_count);
+  return cpu_count;
+#elif defined(_WIN32)
+  return 1u;
+#else
+  return static_cast<uint32_t>(std::max(sysconf(_SC_NPROCESSORS_CONF), 1L));
+#endif
+}
+
 }  // namespace art
@@ -183,6 +183,21 @@ bool IsAddressKnownBackedByFileOrShared(const void* addr);
 // Returns the number of threads running.
 int GetTaskCount();
 
+// Returns the number of CPUs a CFS bandwidth quota of `quota_us` per `period_us` is worth, rounded
+// up and capped at `max_cpus`. A negative quota means no limit.
+uint32_t CpuCountFromCfsQuota(int64_t quota_us, int64_t period_us, uint32_t max_cpus);
+
+// Returns the path of the cgroup of this process in the cgroup v1 hierarchy of `controller`, or
+// in the cgroup v2 hierarchy if `controller` is empty, given the contents of /proc/self/cgroup.
+// Returns an empty string if there is no such hierarchy.
+std::string GetCgroupPath(const std::string& proc_self_cgroup, const std::string& controller);
+
+// Returns the number of CPUs this process can effectively use. This is the number of CPUs in the
+// process' affinity mask (which reflects cpusets), further limited by the cgroup v2 `cpu.max` or
+// cgroup v1 `cpu.cfs_quota_us` bandwidth quotas of the process' cgroup and its ancestors. Always
+// returns at least 1.
+uint32_t GetEffectiveCpuCount();
+
 }  // namespace art
 
 #endif  // ART_LIBARTBASE_BASE_UTILS_H_
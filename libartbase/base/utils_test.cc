@@ -17,6 +17,8 @@
 #include "utils.h"
 #include "stl_util.h"
 
+#include <unistd.h>
+
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
@@ -124,6 +126,42 @@ TEST_F(UtilsTest, GetProcessStatus) {
   EXPECT_EQ("<unknown>", GetProcessStatus("InvalidFieldName"));
 }
 
+TEST_F(UtilsTest, CpuCountFromCfsQuota) {
+  EXPECT_EQ(8u, CpuCountFromCfsQuota(-1, 100000, 8u));
+  EXPECT_EQ(8u, CpuCountFromCfsQuota(400000, 0, 8u));
+  EXPECT_EQ(4u, CpuCountFromCfsQuota(400000, 100000, 96u));
+  EXPECT_EQ(2u, CpuCountFromCfsQuota(150000, 100000, 96u));
+  EXPECT_EQ(1u, CpuCountFromCfsQuota(10000, 100000, 96u));
+  EXPECT_EQ(8u, CpuCountFromCfsQuota(1600000, 100000, 8u));
+}
+
+TEST_F(UtilsTest, GetCgroupPath) {
+  std::string v2 = "0::/system.slice/app.service\n";
+  EXPECT_EQ("/system.slice/app.service", GetCgroupPath(v2, ""));
+  EXPECT_EQ("", GetCgroupPath(v2, "cpu"));
+
+  std::string v1 =
+      "12:memory:/docker/abc\n"
+      "4:cpu,cpuacct:/docker/abc\n"
+      "3:cpuset:/docker/def\n"
+      "1:name=systemd:/docker/abc\n";
+  EXPECT_EQ("/docker/abc", GetCgroupPath(v1, "cpu"));
+  EXPECT_EQ("/docker/def", GetCgroupPath(v1, "cpuset"));
+  EXPECT_EQ("", GetCgroupPath(v1, ""));
+
+  std::string hybrid = "4:cpu,cpuacct:/a\n0::/b\n";
+  EXPECT_EQ("/a", GetCgroupPath(hybrid, "cpu"));
+  EXPECT_EQ("/b", GetCgroupPath(hybrid, ""));
+
+  EXPECT_EQ("", GetCgroupPath("", "cpu"));
+}
+
+TEST_F(UtilsTest, GetEffectiveCpuCount) {
+  uint32_t cpu_count = GetEffectiveCpuCount();
+  EXPECT_GE(cpu_count, 1u);
+  EXPECT_LE(cpu_count, static_cast<uint32_t>(sysconf(_SC_NPROCESSORS_CONF)));
+}
+
 TEST_F(UtilsTest, StringSplit) {
   auto range = SplitString("[ab[c[[d[e[", '[');
   auto it = range.begin();
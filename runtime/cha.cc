@@ -17,15 +17,22 @@
 #include "cha.h"
 
 #include "art_method-inl.h"
+#include "base/array_ref.h"
 #include "base/logging.h"  // For VLOG
 #include "base/mutex.h"
+#include "class_linker.h"
+#include "class_table-inl.h"
+#include "instrumentation.h"
 #include "jit/jit.h"
 #include "jit/jit_code_cache.h"
 #include "linear_alloc.h"
 #include "mirror/class_loader.h"
+#include "oat.h"
+#include "oat_file.h"
 #include "runtime.h"
 #include "scoped_thread_state_change-inl.h"
 #include "stack.h"
+#include "stack_map.h"
 #include "thread.h"
 #include "thread_list.h"
 #include "thread_pool.h"
@@ -545,6 +552,9 @@ void ClassHierarchyAnalysis::InitSingleImplementationFlag(Handle<mirror::Class>
 
 void ClassHierarchyAnalysis::UpdateAfterLoadingOf(Handle<mirror::Class> klass) {
   PointerSize image_pointer_size = Runtime::Current()->GetClassLinker()->GetImagePointerSize();
+  if (UNLIKELY(has_invalidated_aot_methods_.load(std::memory_order_relaxed))) {
+    ResetInvalidatedAotCode(klass);
+  }
   if (klass->IsInterface()) {
     for (ArtMethod& method : klass->GetDeclaredVirtualMethods(image_pointer_size)) {
       DCHECK(method.IsAbstract() || method.IsDefault());
@@ -615,6 +625,150 @@ void ClassHierarchyAnalysis::UpdateAfterLoadingOf(Handle<mirror::Class> klass) {
   InvalidateSingleImplementationMethods(invalidated_single_impl_methods);
 }
 
+// Return the oat file of `klass` if its code may rely on a closed class hierarchy.
+static const OatFile* GetClosedHierarchyOatFile(ObjPtr<mirror::Class> klass)
+    REQUIRES_SHARED(Locks::mutator_lock_) {
+  if (klass->IsProxyClass() || klass->GetDexCache() == nullptr) {
+    return nullptr;
+  }
+  const OatDexFile* oat_dex_file = klass->GetDexFile().GetOatDexFile();
+  if (oat_dex_file == nullptr || oat_dex_file->GetOatFile() == nullptr) {
+    return nullptr;
+  }
+  const OatFile* oat_file = oat_dex_file->GetOatFile();
+  return oat_file->GetOatHeader().AssumesClosedClassHierarchy() ? oat_file : nullptr;
+}
+
+// Return whether the AOT compiled `quick_code` of `method` assumes that one of `methods`
+// has single-implementation.
+template <typename AotMethodReferenceSet>
+static bool AotCodeDependsOn(ArtMethod* method,
+                             const void* quick_code,
+                             const AotMethodReferenceSet& methods)
+    REQUIRES_SHARED(Locks::mutator_lock_) {
+  const OatQuickMethodHeader* method_header = OatQuickMethodHeader::FromEntryPoint(quick_code);
+  if (!method_header->IsOptimized() || !method_header->HasShouldDeoptimizeFlag()) {
+    // Only code with CHA guards has recorded assumptions.
+    return false;
+  }
+  const OatDexFile* oat_dex_file = method->GetDexFile()->GetOatDexFile();
+  ArrayRef<const OatDexFile* const> oat_dex_files(oat_dex_file->GetOatFile()->GetOatDexFiles());
+  CodeInfo code_info(method_header);
+  for (MethodInfo method_info : code_info.GetCHADependencies()) {
+    uint32_t dex_file_index = method_info.GetDexFileIndex();
+    const OatDexFile* dependency_dex_file = (dex_file_index == MethodInfo::kSameDexFile)
+        ? oat_dex_file
+        : oat_dex_files[dex_file_index];
+    if (methods.find({dependency_dex_file, method_info.GetMethodIndex()}) != methods.end()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool ClassHierarchyAnalysis::IsAotCodeInvalidated(ArtMethod* method, const void* quick_code) {
+  if (LIKELY(!has_invalidated_aot_methods_.load(std::memory_order_relaxed))) {
+    return false;
+  }
+  if (method->IsNative() || GetClosedHierarchyOatFile(method->GetDeclaringClass()) == nullptr) {
+    return false;
+  }
+  MutexLock mu(Thread::Current(), *Locks::cha_lock_);
+  return AotCodeDependsOn(method, quick_code, invalidated_aot_methods_);
+}
+
+bool ClassHierarchyAnalysis::SetEntryPointUnlessInvalidated(ArtMethod* method,
+                                                            const void* quick_code) {
+  PointerSize pointer_size = Runtime::Current()->GetClassLinker()->GetImagePointerSize();
+  if (method->IsNative() ||
+      GetClosedHierarchyOatFile(method->GetDeclaringClass()) == nullptr ||
+      quick_code != method->GetOatMethodQuickCode(pointer_size)) {
+    method->SetEntryPointFromQuickCompiledCode(quick_code);
+    return true;
+  }
+  // `InvalidateAotCode()` records the invalidated methods under the lock before it looks for
+  // their dependent AOT code. So either we see them here, or it sees the new entrypoint.
+  MutexLock mu(Thread::Current(), *Locks::cha_lock_);
+  if (has_invalidated_aot_methods_.load(std::memory_order_relaxed) &&
+      AotCodeDependsOn(method, quick_code, invalidated_aot_methods_)) {
+    return false;
+  }
+  method->SetEntryPointFromQuickCompiledCode(quick_code);
+  return true;
+}
+
+void ClassHierarchyAnalysis::RemoveInvalidatedAotMethodsOf(Thread* self,
+                                                           const OatDexFile* oat_dex_file) {
+  MutexLock mu(self, *Locks::cha_lock_);
+  invalidated_aot_methods_.erase(
+      invalidated_aot_methods_.lower_bound({oat_dex_file, 0u}),
+      invalidated_aot_methods_.lower_bound({oat_dex_file + 1, 0u}));
+  if (invalidated_aot_methods_.empty()) {
+    has_invalidated_aot_methods_.store(false, std::memory_order_relaxed);
+  }
+}
+
+void ClassHierarchyAnalysis::ResetInvalidatedAotCode(Handle<mirror::Class> klass) {
+  if (GetClosedHierarchyOatFile(klass.Get()) == nullptr) {
+    return;
+  }
+  instrumentation::Instrumentation* instrumentation = Runtime::Current()->GetInstrumentation();
+  PointerSize pointer_size = Runtime::Current()->GetClassLinker()->GetImagePointerSize();
+  for (ArtMethod& method : klass->GetDeclaredMethods(pointer_size)) {
+    if (method.IsAbstract() || method.IsNative()) {
+      continue;
+    }
+    const void* quick_code = method.GetOatMethodQuickCode(pointer_size);
+    if (quick_code != nullptr &&
+        method.GetEntryPointFromQuickCompiledCode() == quick_code &&
+        IsAotCodeInvalidated(&method, quick_code)) {
+      // The class is not resolved yet, so none of its methods can be running.
+      instrumentation->InitializeMethodsCode(&method, /*aot_code=*/ nullptr);
+    }
+  }
+}
+
+void ClassHierarchyAnalysis::InvalidateAotCode(
+    const std::vector<ArtMethod*>& invalidated_methods,
+    std::unordered_set<OatQuickMethodHeader*>& dependent_method_headers) {
+  Runtime* const runtime = Runtime::Current();
+  ClassLinker* class_linker = runtime->GetClassLinker();
+  PointerSize pointer_size = class_linker->GetImagePointerSize();
+  std::set<AotMethodReference> references;
+  std::unordered_set<ClassTable*> class_tables;
+  for (ArtMethod* method : invalidated_methods) {
+    references.insert({method->GetDexFile()->GetOatDexFile(), method->GetDexMethodIndex()});
+    // AOT code only depends on methods of its own oat file, so the dependent code belongs
+    // to classes defined by the same class loader.
+    class_tables.insert(
+        class_linker->ClassTableForClassLoader(method->GetDeclaringClass()->GetClassLoader()));
+  }
+  // Classes that are not loaded yet get their entrypoints checked by `IsAotCodeInvalidated()`.
+  for (ClassTable* class_table : class_tables) {
+    DCHECK(class_table != nullptr);
+    class_table->Visit([&](ObjPtr<mirror::Class> klass) REQUIRES_SHARED(Locks::mutator_lock_) {
+      if (GetClosedHierarchyOatFile(klass) == nullptr) {
+        return true;
+      }
+      for (ArtMethod& method : klass->GetDeclaredMethods(pointer_size)) {
+        if (method.IsAbstract() || method.IsNative()) {
+          continue;
+        }
+        const void* quick_code = method.GetOatMethodQuickCode(pointer_size);
+        if (quick_code == nullptr || !AotCodeDependsOn(&method, quick_code, references)) {
+          continue;
+        }
+        VLOG(class_linker) << "CHA invalidated AOT code for " << method.PrettyMethod();
+        if (method.GetEntryPointFromQuickCompiledCode() == quick_code) {
+          runtime->GetInstrumentation()->InitializeMethodsCode(&method, /*aot_code=*/ nullptr);
+        }
+        dependent_method_headers.insert(OatQuickMethodHeader::FromEntryPoint(quick_code));
+      }
+      return true;
+    });
+  }
+}
+
 void ClassHierarchyAnalysis::InvalidateSingleImplementationMethods(
     std::unordered_set<ArtMethod*>& invalidated_single_impl_methods) {
   if (!invalidated_single_impl_methods.empty()) {
@@ -630,6 +784,7 @@ void ClassHierarchyAnalysis::InvalidateSingleImplementationMethods(
       // make sure the code is only committed when all single-implementation
       // assumptions are still true.
       std::vector<std::pair<ArtMethod*, OatQuickMethodHeader*>> headers;
+      std::vector<ArtMethod*> aot_invalidated_methods;
       {
         MutexLock cha_mu(self, *Locks::cha_lock_);
         // Invalidate compiled methods that assume some virtual calls have only
@@ -652,6 +807,16 @@ void ClassHierarchyAnalysis::InvalidateSingleImplementationMethods(
             continue;
           }
 
+          if (!invalidated->IsAbstract() &&
+              !invalidated->GetDeclaringClass()->IsInterface() &&
+              GetClosedHierarchyOatFile(invalidated->GetDeclaringClass()) != nullptr) {
+            // AOT code of the app may assume this method has single-implementation.
+            invalidated_aot_methods_.insert(
+                {invalidated->GetDexFile()->GetOatDexFile(), invalidated->GetDexMethodIndex()});
+            has_invalidated_aot_methods_.store(true, std::memory_order_relaxed);
+            aot_invalidated_methods.push_back(invalidated);
+          }
+
           // Invalidate all dependents.
           for (const auto& dependent : GetDependents(invalidated)) {
             ArtMethod* method = dependent.first;;
@@ -678,6 +843,9 @@ void ClassHierarchyAnalysis::InvalidateSingleImplementationMethods(
           code_cache->InvalidateCompiledCodeFor(pair.first, pair.second);
         }
       }
+      if (!aot_invalidated_methods.empty()) {
+        InvalidateAotCode(aot_invalidated_methods, dependent_method_headers);
+      }
     }
 
     if (dependent_method_headers.empty()) {
@@ -17,8 +17,12 @@
 #ifndef ART_RUNTIME_CHA_H_
 #define ART_RUNTIME_CHA_H_
 
+#include <atomic>
+#include <set>
 #include <unordered_map>
 #include <unordered_set>
+#include <utility>
+#include <vector>
 
 #include "base/enums.h"
 #include "base/locks.h"
@@ -30,6 +34,7 @@ namespace art {
 
 class ArtMethod;
 class LinearAlloc;
+class OatDexFile;
 
 /**
  * Class Hierarchy Analysis (CHA) tries to devirtualize virtual calls into
@@ -56,6 +61,12 @@ class LinearAlloc;
  * will be updated as a result. Method A can later be recompiled with less
  * aggressive assumptions.
  *
+ * An app compiled with --assume-closed-class-hierarchy also has AOT code that
+ * relies on the single-implementation status of its own methods, as seen by
+ * dex2oat. The assumptions are recorded in the CodeInfo of that code. When a
+ * class loaded at runtime invalidates one of them, the AOT code is no longer
+ * used as an entrypoint and frames executing it are deoptimized.
+ *
  * For live compiled code that's on stack, deoptmization will be initiated
  * to force the invalidated compiled code into interpreter mode to guarantee
  * correctness. The deoptimization mechanism used is a hybrid of
@@ -129,7 +140,25 @@ class ClassHierarchyAnalysis {
   void RemoveDependenciesForLinearAlloc(Thread* self, const LinearAlloc* linear_alloc)
       REQUIRES(!Locks::cha_lock_);
 
+  // Return whether the AOT compiled `quick_code` of `method` assumes that some method has
+  // single-implementation while a class loaded since then has invalidated that assumption.
+  bool IsAotCodeInvalidated(ArtMethod* method, const void* quick_code)
+      REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(!Locks::cha_lock_);
+
+  // Set the entrypoint of `method` to `quick_code` unless it is AOT code invalidated as above.
+  // Installing AOT code that may rely on a closed class hierarchy is done under the CHA lock, so
+  // that `InvalidateAotCode()` cannot miss it. Return whether the entrypoint was set.
+  bool SetEntryPointUnlessInvalidated(ArtMethod* method, const void* quick_code)
+      REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(!Locks::cha_lock_);
+
+  // Forget the invalidated methods of `oat_dex_file`, which is being unloaded.
+  void RemoveInvalidatedAotMethodsOf(Thread* self, const OatDexFile* oat_dex_file)
+      REQUIRES(!Locks::cha_lock_);
+
  private:
+  // A method of a dex file compiled assuming a closed class hierarchy, identified by
+  // its oat dex file and dex method index.
+  using AotMethodReference = std::pair<const OatDexFile*, uint32_t>;
   void InitSingleImplementationFlag(Handle<mirror::Class> klass,
                                     ArtMethod* method,
                                     PointerSize pointer_size)
@@ -166,11 +195,27 @@ class ClassHierarchyAnalysis {
       std::unordered_set<ArtMethod*>& invalidated_single_impl_methods)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Stop using AOT code of loaded classes that assumes any of `invalidated_methods` has
+  // single-implementation, and append its method headers to `dependent_method_headers`.
+  void InvalidateAotCode(const std::vector<ArtMethod*>& invalidated_methods,
+                         std::unordered_set<OatQuickMethodHeader*>& dependent_method_headers)
+      REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(!Locks::cha_lock_);
+
+  // Stop using invalidated AOT code in the methods of `klass`, which `InvalidateAotCode()`
+  // may have missed while `klass` was being linked.
+  void ResetInvalidatedAotCode(Handle<mirror::Class> klass)
+      REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(!Locks::cha_lock_);
+
   // A map that maps a method to a set of compiled code that assumes that method has a
   // single implementation, which is used to do CHA-based devirtualization.
   std::unordered_map<ArtMethod*, ListOfDependentPairs> cha_dependency_map_
     GUARDED_BY(Locks::cha_lock_);
 
+  // Methods whose single-implementation status was assumed by AOT code and has since been
+  // invalidated. The flag allows checking AOT code without taking the lock in the common case.
+  std::set<AotMethodReference> invalidated_aot_methods_ GUARDED_BY(Locks::cha_lock_);
+  std::atomic<bool> has_invalidated_aot_methods_ = false;
+
   DISALLOW_COPY_AND_ASSIGN(ClassHierarchyAnalysis);
 };
 
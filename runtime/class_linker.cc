@@ -625,6 +625,12 @@ ClassLinker::ClassLinker(InternTable* intern_table, bool fast_class_not_found_ex
   std::fill_n(find_array_class_cache_, kFindArrayCacheSize, GcRoot<mirror::Class>(nullptr));
 }
 
+void ClassLinker::EnableClassHierarchyAnalysis() {
+  DCHECK(Runtime::Current()->IsAotCompiler());
+  DCHECK(cha_ == nullptr);
+  cha_.reset(new ClassHierarchyAnalysis());
+}
+
 void ClassLinker::CheckSystemClass(Thread* self, Handle<mirror::Class> c1, const char* descriptor) {
   ObjPtr<mirror::Class> c2 = FindSystemClass(self, descriptor);
   if (c2 == nullptr) {
@@ -4306,6 +4312,7 @@ ObjPtr<mirror::DexCache> ClassLinker::RegisterDexFile(const DexFile& dex_file,
   }
   VLOG(class_linker) << "Registered dex file " << dex_file.GetLocation();
   PaletteNotifyDexFileLoaded(dex_file.GetLocation().c_str());
+  Runtime::Current()->GetOatFileManager().RunStartupVerification(dex_file, h_class_loader.Get());
   return h_dex_cache.Get();
 }
 
@@ -10839,6 +10846,11 @@ void ClassLinker::CleanupClassLoaders() {
   // Do the delete outside the lock to avoid lock violation in jit code cache.
   {
     WriterMutexLock mu(self, *Locks::classlinker_classes_lock_);
+    // Class sets retired before the last pause are no longer used by lock-free lookups.
+    uint32_t pause_count = Runtime::Current()->GetThreadList()->GetExclusivePauseCount();
+    if (boot_class_table_ != nullptr) {
+      boot_class_table_->FreeRetiredClassSets(pause_count);
+    }
     for (auto it = class_loaders_.begin(); it != class_loaders_.end(); ) {
       auto this_it = it;
       ++it;
@@ -10849,6 +10861,8 @@ void ClassLinker::CleanupClassLoaders() {
       if (class_loader == nullptr) {
         VLOG(class_linker) << "Freeing class loader";
         to_delete.splice(to_delete.end(), class_loaders_, this_it);
+      } else if (data.class_table != nullptr) {
+        data.class_table->FreeRetiredClassSets(pause_count);
       }
     }
   }
@@ -10856,6 +10870,7 @@ void ClassLinker::CleanupClassLoaders() {
     return;
   }
   std::set<const OatFile*> unregistered_oat_files;
+  std::vector<const OatDexFile*> unregistered_oat_dex_files;
   JavaVMExt* vm = self->GetJniEnv()->GetVm();
   {
     WriterMutexLock mu(self, *Locks::dex_lock_);
@@ -10872,6 +10887,9 @@ void ClassLinker::CleanupClassLoaders() {
             dex_file->GetOatDexFile()->GetOatFile()->IsExecutable()) {
           unregistered_oat_files.insert(dex_file->GetOatDexFile()->GetOatFile());
         }
+        if (dex_file->GetOatDexFile() != nullptr) {
+          unregistered_oat_dex_files.push_back(dex_file->GetOatDexFile());
+        }
         vm->DeleteWeakGlobalRef(self, data.weak_root);
         it = dex_caches_.erase(it);
       } else {
@@ -10886,6 +10904,12 @@ void ClassLinker::CleanupClassLoaders() {
       PrepareToDeleteClassLoader(self, data, /*cleanup_cha=*/true);
     }
   }
+  if (cha_ != nullptr) {
+    // The oat dex files are about to be deleted, and their addresses may be reused.
+    for (const OatDexFile* oat_dex_file : unregistered_oat_dex_files) {
+      cha_->RemoveInvalidatedAotMethodsOf(self, oat_dex_file);
+    }
+  }
   for (const ClassLoaderData& data : to_delete) {
     delete data.allocator;
     delete data.class_table;
@@ -829,6 +829,11 @@ class ClassLinker {
     return cha_.get();
   }
 
+  // Enable class hierarchy analysis in the AOT compiler, so that app methods get their
+  // single-implementation flags when their classes are linked. Must be called before
+  // loading the classes being compiled.
+  void EnableClassHierarchyAnalysis();
+
   void MakeInitializedClassesVisiblyInitialized(Thread* self, bool wait /* ==> no locks held */);
 
   // Registers the native method and returns the new entry point. NB The returned entry point
@@ -41,6 +41,7 @@
 #include "mirror/object_array-alloc-inl.h"
 #include "nativehelper/scoped_local_ref.h"
 #include "oat_file_assistant.h"
+#include "oat_file_assistant_context.h"
 #include "obj_ptr-inl.h"
 #include "runtime.h"
 #include "scoped_thread_state_change-inl.h"
@@ -408,11 +409,22 @@ ClassLoaderContext::ClassLoaderInfo* ClassLoaderContext::ParseInternal(const std
   return first.release();
 }
 
+// Returns the location of the class path element `cp_elem`. If it is relative, it is appended
+// to the provided base directory.
+static std::string GetClassPathLocation(const std::string& classpath_dir,
+                                        const std::string& cp_elem) {
+  if (cp_elem[0] != '/' && !classpath_dir.empty()) {
+    return ART_FORMAT("{}{}{}", classpath_dir, classpath_dir.back() == '/' ? "" : "/", cp_elem);
+  }
+  return cp_elem;
+}
+
 // Opens requested class path files and appends them to opened_dex_files. If the dex files have
 // been stripped, this opens them from their oat files (which get added to opened_oat_files).
 bool ClassLoaderContext::OpenDexFiles(const std::string& classpath_dir,
                                       const std::vector<int>& fds,
-                                      bool only_read_checksums) {
+                                      bool only_read_checksums,
+                                      OatFileAssistantContext* ofa_context) {
   switch (dex_files_state_) {
     case kDexFilesNotOpened:
       break;  // files not opened, continue.
@@ -439,6 +451,20 @@ bool ClassLoaderContext::OpenDexFiles(const std::string& classpath_dir,
   if (class_loader_chain_ == nullptr) {
     return true;
   }
+  if (only_read_checksums && ofa_context != nullptr && fds.empty()) {
+    // Warm up the checksum cache for all the class path elements at once.
+    std::vector<std::string> locations;
+    work_list.push_back(class_loader_chain_.get());
+    while (!work_list.empty()) {
+      ClassLoaderInfo* info = work_list.back();
+      work_list.pop_back();
+      for (const std::string& cp_elem : info->classpath) {
+        locations.push_back(GetClassPathLocation(classpath_dir, cp_elem));
+      }
+      AddToWorkList(info, work_list);
+    }
+    ofa_context->PrefetchMultiDexChecksums(locations);
+  }
   work_list.push_back(class_loader_chain_.get());
   size_t dex_file_index = 0;
   while (!work_list.empty()) {
@@ -452,12 +478,7 @@ bool ClassLoaderContext::OpenDexFiles(const std::string& classpath_dir,
     std::vector<uint32_t> dex_checksums;
 
     for (const std::string& cp_elem : info->classpath) {
-      // If path is relative, append it to the provided base directory.
-      std::string location = cp_elem;
-      if (location[0] != '/' && !classpath_dir.empty()) {
-        location =
-            ART_FORMAT("{}{}{}", classpath_dir, classpath_dir.back() == '/' ? "" : "/", location);
-      }
+      std::string location = GetClassPathLocation(classpath_dir, cp_elem);
 
       // If file descriptors were provided for the class loader context dex paths,
       // get the descriptor which corresponds to this dex path. We assume the `fds`
@@ -478,9 +499,16 @@ bool ClassLoaderContext::OpenDexFiles(const std::string& classpath_dir,
       std::optional<uint32_t> dex_checksum;
       if (only_read_checksums) {
         bool zip_file_only_contains_uncompress_dex;
-        ArtDexFileLoader dex_file_loader(&file, location);
-        if (!dex_file_loader.GetMultiDexChecksum(
-                &dex_checksum, &error_msg, &zip_file_only_contains_uncompress_dex)) {
+        bool ok;
+        if (ofa_context != nullptr) {
+          ok = ofa_context->GetMultiDexChecksum(
+              location, &file, &dex_checksum, &error_msg, &zip_file_only_contains_uncompress_dex);
+        } else {
+          ArtDexFileLoader dex_file_loader(&file, location);
+          ok = dex_file_loader.GetMultiDexChecksum(
+              &dex_checksum, &error_msg, &zip_file_only_contains_uncompress_dex);
+        }
+        if (!ok) {
           LOG(WARNING) << "Could not get dex checksums for location " << location
                        << ", fd=" << file.Fd();
           dex_files_state_ = kDexFilesOpenFailed;
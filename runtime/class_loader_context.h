@@ -33,6 +33,7 @@ namespace art {
 
 class DexFile;
 class OatFile;
+class OatFileAssistantContext;
 
 // Utility class which holds the class loader context used during compilation/verification.
 class ClassLoaderContext {
@@ -77,7 +78,9 @@ class ClassLoaderContext {
   // separately.)
   //
   // only_read_checksums controls whether or not we only read the dex locations and the checksums
-  // from the apk instead of fully opening the dex files.
+  // from the apk instead of fully opening the dex files. In that case, if `ofa_context` is not
+  // null, the checksums are read through its cache and the ones missing from the cache are
+  // computed in parallel.
   //
   // This method is not thread safe.
   //
@@ -90,7 +93,8 @@ class ClassLoaderContext {
   // the class loader is created. Consider reworking the dex2oat part.
   bool OpenDexFiles(const std::string& classpath_dir = "",
                     const std::vector<int>& context_fds = std::vector<int>(),
-                    bool only_read_checksums = false);
+                    bool only_read_checksums = false,
+                    OatFileAssistantContext* ofa_context = nullptr);
 
   // Remove the specified compilation sources from all classpaths present in this context.
   // Should only be called before the first call to OpenDexFiles().
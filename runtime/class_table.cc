@@ -16,17 +16,54 @@
 
 #include "class_table-inl.h"
 
+#include <algorithm>
+
 #include "base/stl_util.h"
 #include "mirror/class-inl.h"
 #include "mirror/string-inl.h"
 #include "oat_file.h"
+#include "runtime.h"
+#include "thread_list.h"
 
 namespace art {
 
-ClassTable::ClassTable() : lock_("Class loader classes", kClassLoaderClassesLock) {
+ClassTable::ClassTable()
+    : lock_("Class loader classes", kClassLoaderClassesLock),
+      published_views_(nullptr) {
   Runtime* const runtime = Runtime::Current();
   classes_.push_back(ClassSet(runtime->GetHashTableMinLoadFactor(),
                               runtime->GetHashTableMaxLoadFactor()));
+  // No other thread can see this table yet, so there is nothing to retire.
+  std::unique_ptr<ClassSetViews> views(new ClassSetViews());
+  views->push_back(ClassSet::CreateView(classes_.back()));
+  published_views_.store(views.get(), std::memory_order_release);
+  current_views_ = std::move(views);
+}
+
+void ClassTable::PublishClassSetViews(ClassSet&& retired_set) {
+  std::unique_ptr<ClassSetViews> views(new ClassSetViews());
+  views->reserve(classes_.size());
+  for (const ClassSet& class_set : classes_) {
+    views->push_back(ClassSet::CreateView(class_set));
+  }
+  published_views_.store(views.get(), std::memory_order_release);
+  // Lock-free lookups may still be using the old views and the data of `retired_set`.
+  // Keep them until the next exclusive pause, see `FreeRetiredClassSets()`.
+  uint32_t pause_count = Runtime::Current()->GetThreadList()->GetExclusivePauseCount();
+  retired_.push_back({std::move(current_views_), std::move(retired_set), pause_count});
+  current_views_ = std::move(views);
+}
+
+void ClassTable::FreeRetiredClassSets(uint32_t current_pause_count) {
+  WriterMutexLock mu(Thread::Current(), lock_);
+  // Lookups hold the mutator lock shared and do not suspend. So once the pause count has moved
+  // past the one read at retirement, all lookups that could see the retired set have finished.
+  auto it = std::remove_if(retired_.begin(),
+                           retired_.end(),
+                           [current_pause_count](const RetiredClassSets& retired) {
+                             return current_pause_count != retired.pause_count;
+                           });
+  retired_.erase(it, retired_.end());
 }
 
 void ClassTable::FreezeSnapshot() {
@@ -36,6 +73,7 @@ void ClassTable::FreezeSnapshot() {
   const ClassSet& last_set = classes_.back();
   ClassSet new_set(last_set.GetMinLoadFactor(), last_set.GetMaxLoadFactor());
   classes_.push_back(std::move(new_set));
+  PublishClassSetViews();
 }
 
 ObjPtr<mirror::Class> ClassTable::UpdateClass(const char* descriptor,
@@ -59,6 +97,8 @@ ObjPtr<mirror::Class> ClassTable::UpdateClass(const char* descriptor,
   CHECK_EQ(klass->GetStatus(), ClassStatus::kResolving) << descriptor;
   CHECK(!klass->IsTemp()) << descriptor;
   VerifyObject(klass);
+  // Make the new class visible to lock-free lookups before publishing the reference.
+  std::atomic_thread_fence(std::memory_order_release);
   // Update the element in the hash set with the new class. This is safe to do since the descriptor
   // doesn't change.
   *existing_it = TableSlot(klass, hash);
@@ -106,13 +146,16 @@ size_t ClassTable::NumReferencedNonZygoteClasses() const {
 
 ObjPtr<mirror::Class> ClassTable::Lookup(const char* descriptor, size_t hash) {
   DescriptorHashPair pair(descriptor, hash);
-  ReaderMutexLock mu(Thread::Current(), lock_);
+  // Search the published views without taking the `lock_`. The views and their data stay
+  // valid until this thread reaches a suspend point, see `FreeRetiredClassSets()`.
+  const ClassSetViews* views = published_views_.load(std::memory_order_acquire);
+  DCHECK(views != nullptr);
   // Search from the last table, assuming that apps shall search for their own classes
   // more often than for boot image classes. For prebuilt boot images, this also helps
   // by searching the large table from the framework boot image extension compiled as
   // single-image before the individual small tables from the primary boot image
   // compiled as multi-image.
-  for (ClassSet& class_set : ReverseRange(classes_)) {
+  for (const ClassSet& class_set : ReverseRange(*views)) {
     auto it = class_set.FindWithHash(pair, hash);
     if (it != class_set.end()) {
       return it->Read();
@@ -127,7 +170,22 @@ void ClassTable::Insert(ObjPtr<mirror::Class> klass) {
 
 void ClassTable::InsertWithHash(ObjPtr<mirror::Class> klass, size_t hash) {
   WriterMutexLock mu(Thread::Current(), lock_);
-  classes_.back().InsertWithHash(TableSlot(klass, hash), hash);
+  InsertWithHashLocked(klass, hash);
+}
+
+void ClassTable::InsertWithHashLocked(ObjPtr<mirror::Class> klass, size_t hash) {
+  // Make the class visible to lock-free lookups before publishing the reference.
+  std::atomic_thread_fence(std::memory_order_release);
+  ClassSet& class_set = classes_.back();
+  if (LIKELY(class_set.size() < class_set.ElementsUntilExpand())) {
+    class_set.InsertWithHash(TableSlot(klass, hash), hash);
+    return;
+  }
+  // The insertion would resize the set in place. Grow a copy and swap it in instead.
+  ClassSet new_set(class_set);
+  new_set.InsertWithHash(TableSlot(klass, hash), hash);
+  std::swap(class_set, new_set);
+  PublishClassSetViews(std::move(new_set));
 }
 
 bool ClassTable::InsertStrongRoot(ObjPtr<mirror::Object> obj) {
@@ -179,6 +237,7 @@ void ClassTable::AddClassSet(ClassSet&& set) {
   // TODO: Make use of this in `ClassLinker::FindClass()`.
   DCHECK(!classes_.empty());
   classes_.insert(classes_.end() - 1, std::move(set));
+  PublishClassSetViews();
 }
 
 void ClassTable::ClearStrongRoots() {
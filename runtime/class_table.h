@@ -17,6 +17,8 @@
 #ifndef ART_RUNTIME_CLASS_TABLE_H_
 #define ART_RUNTIME_CLASS_TABLE_H_
 
+#include <atomic>
+#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
@@ -272,11 +274,39 @@ class ClassTable {
       REQUIRES(!lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Free class sets and snapshots retired before the last exclusive pause, see
+  // `ThreadList::GetExclusivePauseCount()`. No lock-free lookup can still be using them.
+  void FreeRetiredClassSets(uint32_t current_pause_count)
+      REQUIRES(!lock_)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
   ReaderWriterMutex& GetLock() {
     return lock_;
   }
 
  private:
+  // Read-only views of `classes_` for lock-free lookups, in the same order as `classes_`.
+  using ClassSetViews = std::vector<ClassSet>;
+
+  // Class sets and snapshots that may still be in use by lock-free lookups.
+  struct RetiredClassSets {
+    std::unique_ptr<const ClassSetViews> views;
+    ClassSet set;
+    uint32_t pause_count;
+  };
+
+  // Insert into the last class set. If the set needs to grow, we do not resize it in place
+  // since lock-free lookups may be searching its data; we copy it to a bigger set instead,
+  // publish new views and retire the old set.
+  void InsertWithHashLocked(ObjPtr<mirror::Class> klass, size_t hash)
+      REQUIRES(lock_)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
+  // Publish new views after `classes_` changed and retire the old views together with `set`.
+  void PublishClassSetViews(ClassSet&& retired_set = ClassSet())
+      REQUIRES(lock_)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
   size_t CountDefiningLoaderClasses(ObjPtr<mirror::ClassLoader> defining_loader,
                                     const ClassSet& set) const
       REQUIRES(lock_)
@@ -291,6 +321,12 @@ class ClassTable {
   mutable ReaderWriterMutex lock_;
   // We have a vector to help prevent dirty pages after the zygote forks by calling FreezeSnapshot.
   std::vector<ClassSet> classes_ GUARDED_BY(lock_);
+  // Views of `classes_` searched by `Lookup()` without taking the `lock_`. Readers never need
+  // an atomic read-modify-write, writers publish new views with a release store whenever a class
+  // set is added or reallocated. Inserts that do not reallocate write to the shared data directly.
+  std::unique_ptr<const ClassSetViews> current_views_ GUARDED_BY(lock_);
+  std::atomic<const ClassSetViews*> published_views_;
+  std::vector<RetiredClassSets> retired_ GUARDED_BY(lock_);
   // Extra strong roots that can be either dex files or dex caches. Dex files used by the class
   // loader which may not be owned by the class loader must be held strongly live. Also dex caches
   // are held live to prevent them being unloading once they have classes in them.
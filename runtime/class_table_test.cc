@@ -161,5 +161,35 @@ TEST_F(ClassTableTest, ClassTable) {
   // TODO: Add tests for UpdateClass, InsertOatFile.
 }
 
+TEST_F(ClassTableTest, LookupAfterGrowth) {
+  ScopedObjectAccess soa(Thread::Current());
+  // Collect enough boot classes to make the class set grow a few times.
+  std::vector<ObjPtr<mirror::Class>> classes;
+  auto visitor = [&classes](ObjPtr<mirror::Class> klass) REQUIRES_SHARED(Locks::mutator_lock_) {
+    classes.push_back(klass);
+    return classes.size() != 5000u;
+  };
+  ClassFuncVisitor<decltype(visitor)> class_visitor(visitor);
+  class_linker_->VisitClasses(&class_visitor);
+  ASSERT_GT(classes.size(), ClassTable::ClassSet::kMinBuckets);
+
+  ClassTable table;
+  std::string temp;
+  for (size_t i = 0; i != classes.size(); ++i) {
+    table.Insert(classes[i]);
+    // Check that a class inserted before the latest growth is still found.
+    const char* descriptor = classes[i / 2]->GetDescriptor(&temp);
+    EXPECT_OBJ_PTR_EQ(table.Lookup(descriptor, ComputeModifiedUtf8Hash(descriptor)),
+                      classes[i / 2]);
+  }
+
+  // Retired class sets are freed after the next GC; lookups must not be affected.
+  table.FreeRetiredClassSets(Runtime::Current()->GetHeap()->GetCurrentGcNum() + 1u);
+  for (ObjPtr<mirror::Class> klass : classes) {
+    EXPECT_OBJ_PTR_EQ(table.LookupByDescriptor(klass), klass);
+  }
+  EXPECT_EQ(table.NumReferencedNonZygoteClasses(), classes.size());
+}
+
 }  // namespace mirror
 }  // namespace art
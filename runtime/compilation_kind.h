@@ -25,6 +25,9 @@ namespace art {
 enum class CompilationKind {
   kOsr,
   kBaseline,
+  // Baseline code, still profiling, with a cheap subset of optimizations. Used as an
+  // intermediate tier for methods that are expensive to compile optimized.
+  kBaselinePlus,
   kOptimized,
 };
 
@@ -22,6 +22,7 @@
 #include "callee_save_frame.h"
 #include "dex/dex_file_types.h"
 #include "entrypoints/entrypoint_utils-inl.h"
+#include "gc/heap.h"
 #include "mirror/class-inl.h"
 #include "mirror/object-inl.h"
 #include "mirror/object_array-inl.h"
@@ -138,6 +139,26 @@ GENERATE_ENTRYPOINTS_FOR_ALLOCATOR(TLAB, gc::kAllocatorTypeTLAB)
 GENERATE_ENTRYPOINTS_FOR_ALLOCATOR(Region, gc::kAllocatorTypeRegion)
 GENERATE_ENTRYPOINTS_FOR_ALLOCATOR(RegionTLAB, gc::kAllocatorTypeRegionTLAB)
 
+// Entrypoints used by JIT code for allocation sites found to be long-lived. They do not depend
+// on the allocator of the other entrypoints, and always take the instrumented path as they
+// allocate outside of the TLAB anyway. The class is known to be initialized.
+extern "C" mirror::Object* artAllocObjectFromCodeNonMoving(mirror::Class* klass, Thread* self)
+    REQUIRES_SHARED(Locks::mutator_lock_) {
+  ScopedQuickEntrypointChecks sqec(self);
+  DCHECK(klass != nullptr);
+  gc::AllocatorType allocator_type = Runtime::Current()->GetHeap()->GetPretenureAllocator();
+  return AllocObjectFromCodeInitialized</*kInstrumented=*/ true>(klass, self, allocator_type).Ptr();
+}
+
+extern "C" mirror::Array* artAllocArrayFromCodeNonMoving(
+    mirror::Class* klass, int32_t component_count, Thread* self)
+    REQUIRES_SHARED(Locks::mutator_lock_) {
+  ScopedQuickEntrypointChecks sqec(self);
+  gc::AllocatorType allocator_type = Runtime::Current()->GetHeap()->GetPretenureAllocator();
+  return AllocArrayFromCodeResolved</*kInstrumented=*/ true>(
+      klass, component_count, self, allocator_type).Ptr();
+}
+
 #define GENERATE_ENTRYPOINTS(suffix) \
 extern "C" void* art_quick_alloc_array_resolved##suffix(mirror::Class* klass, int32_t); \
 extern "C" void* art_quick_alloc_array_resolved8##suffix(mirror::Class* klass, int32_t); \
@@ -201,6 +222,9 @@ GENERATE_ENTRYPOINTS(_bump_pointer)
 GENERATE_ENTRYPOINTS(_tlab)
 GENERATE_ENTRYPOINTS(_region)
 GENERATE_ENTRYPOINTS(_region_tlab)
+
+extern "C" void* art_quick_alloc_object_non_moving(mirror::Class* klass);
+extern "C" void* art_quick_alloc_array_non_moving(mirror::Class* klass, int32_t);
 #endif
 
 static bool entry_points_instrumented = false;
@@ -216,6 +240,8 @@ void SetQuickAllocEntryPointsInstrumented(bool instrumented) {
 
 void ResetQuickAllocEntryPoints(QuickEntryPoints* qpoints) {
 #if !defined(__APPLE__) || !defined(__LP64__)
+  qpoints->SetAllocObjectNonMoving(art_quick_alloc_object_non_moving);
+  qpoints->SetAllocArrayNonMoving(art_quick_alloc_array_non_moving);
   switch (entry_points_allocator) {
     case gc::kAllocatorTypeDlMalloc: {
       SetQuickAllocEntryPoints_dlmalloc(qpoints, entry_points_instrumented);
@@ -18,6 +18,8 @@
 
 #include <sys/mman.h>
 
+#include <algorithm>
+
 #include "base/mem_map.h"
 #include "base/systrace.h"
 #include "base/utils.h"
@@ -53,18 +55,30 @@ namespace accounting {
  * byte is equal to `kCardDirty`. See CardTable::Create for details.
  */
 
-CardTable* CardTable::Create(const uint8_t* heap_begin, size_t heap_capacity) {
+CardTable* CardTable::Create(const uint8_t* heap_begin,
+                             size_t heap_capacity,
+                             bool use_huge_pages) {
   ScopedTrace trace(__PRETTY_FUNCTION__);
   /* Set up the card table */
   size_t capacity = heap_capacity / kCardSize;
   /* Allocate an extra 256 bytes to allow fixed low-byte of base */
   std::string error_msg;
-  MemMap mem_map = MemMap::MapAnonymous("card table",
-                                        capacity + 256,
-                                        PROT_READ | PROT_WRITE,
-                                        /*low_4gb=*/ false,
-                                        &error_msg);
+  MemMap mem_map = use_huge_pages
+      ? MemMap::MapAnonymousAligned("card table",
+                                    RoundUp(capacity + 256, gPMDSize),
+                                    PROT_READ | PROT_WRITE,
+                                    /*low_4gb=*/ false,
+                                    gPMDSize,
+                                    &error_msg)
+      : MemMap::MapAnonymous("card table",
+                             capacity + 256,
+                             PROT_READ | PROT_WRITE,
+                             /*low_4gb=*/ false,
+                             &error_msg);
   CHECK(mem_map.IsValid()) << "couldn't allocate card table: " << error_msg;
+  if (use_huge_pages && mem_map.MadviseHugePages() != 0) {
+    PLOG(WARNING) << "Failed to madvise(MADV_HUGEPAGE) card table";
+  }
   // All zeros is the correct initial value; all clean. Anonymous mmaps are initialized to zero, we
   // don't clear the card table to avoid unnecessary pages being allocated
   static_assert(kCardClean == 0, "kCardClean must be 0");
@@ -84,11 +98,14 @@ CardTable* CardTable::Create(const uint8_t* heap_begin, size_t heap_capacity) {
     biased_begin += offset;
   }
   CHECK_EQ(reinterpret_cast<uintptr_t>(biased_begin) & 0xff, kCardDirty);
-  return new CardTable(std::move(mem_map), biased_begin, offset);
+  return new CardTable(std::move(mem_map), biased_begin, offset, use_huge_pages);
 }
 
-CardTable::CardTable(MemMap&& mem_map, uint8_t* biased_begin, size_t offset)
-    : mem_map_(std::move(mem_map)), biased_begin_(biased_begin), offset_(offset) {
+CardTable::CardTable(MemMap&& mem_map, uint8_t* biased_begin, size_t offset, bool use_huge_pages)
+    : mem_map_(std::move(mem_map)),
+      biased_begin_(biased_begin),
+      offset_(offset),
+      use_huge_pages_(use_huge_pages) {
 }
 
 CardTable::~CardTable() {
@@ -106,7 +123,16 @@ void CardTable::ClearCardRange(uint8_t* start, uint8_t* end) {
   static_assert(kCardClean == 0, "kCardClean must be 0");
   uint8_t* start_card = CardFromAddr(start);
   uint8_t* end_card = CardFromAddr(end);
-  ZeroAndReleaseMemory(start_card, end_card - start_card);
+  if (!use_huge_pages_) {
+    ZeroMemory(start_card, end_card - start_card, /*release_eagerly=*/ true);
+    return;
+  }
+  // Do not madvise the partial huge pages at either end, that would split them.
+  uint8_t* huge_begin = std::min(AlignUp(start_card, gPMDSize), end_card);
+  uint8_t* huge_end = std::max(AlignDown(end_card, gPMDSize), huge_begin);
+  std::fill(start_card, huge_begin, kCardClean);
+  ZeroMemory(huge_begin, huge_end - huge_begin, /*release_eagerly=*/ false);
+  std::fill(huge_end, end_card, kCardClean);
 }
 
 bool CardTable::AddrIsInCardTable(const void* addr) const {
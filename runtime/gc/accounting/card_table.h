@@ -52,7 +52,11 @@ class CardTable {
   static constexpr uint8_t kCardDirty = 0x70;
   static constexpr uint8_t kCardAged = kCardDirty - 1;
 
-  static CardTable* Create(const uint8_t* heap_begin, size_t heap_capacity);
+  // If `use_huge_pages` is true, the table is aligned to the PMD size and advised to be backed by
+  // transparent huge pages.
+  static CardTable* Create(const uint8_t* heap_begin,
+                           size_t heap_capacity,
+                           bool use_huge_pages = false);
   ~CardTable();
 
   // Set the card associated with the given address to `kCardDirty`.
@@ -143,7 +147,7 @@ class CardTable {
   bool AddrIsInCardTable(const void* addr) const;
 
  private:
-  CardTable(MemMap&& mem_map, uint8_t* biased_begin, size_t offset);
+  CardTable(MemMap&& mem_map, uint8_t* biased_begin, size_t offset, bool use_huge_pages);
 
   // Returns true iff the card table address is within the bounds of the card table.
   bool IsValidCard(const uint8_t* card_addr) const ALWAYS_INLINE;
@@ -160,6 +164,9 @@ class CardTable {
   // Card table doesn't begin at the beginning of the mem_map_, instead it is displaced by offset
   // to allow the byte value of `biased_begin_` to equal `kCardDirty`.
   const size_t offset_;
+  // Whether the table is backed by transparent huge pages. Partial clears then only zero the cards
+  // instead of releasing them, which would split the huge pages.
+  const bool use_huge_pages_;
 
   DISALLOW_IMPLICIT_CONSTRUCTORS(CardTable);
 };
@@ -16,6 +16,7 @@
 
 #include "card_table-inl.h"
 
+#include <algorithm>
 #include <string>
 
 #include "base/atomic.h"
@@ -145,6 +146,27 @@ TEST_F(CardTableTest, TestModifyCardsAtomic) {
   }
 }
 
+TEST_F(CardTableTest, TestClearCardRangeWithHugePages) {
+  // Big enough for the card table to span several huge pages.
+  uint8_t* heap_begin = reinterpret_cast<uint8_t*>(0x2000000);
+  const size_t heap_size = 4 * gPMDSize * CardTable::kCardSize;
+  std::unique_ptr<CardTable> card_table(
+      CardTable::Create(heap_begin, heap_size, /*use_huge_pages=*/ true));
+  ASSERT_TRUE(card_table != nullptr);
+  uint8_t* heap_end = heap_begin + heap_size;
+  std::fill(card_table->CardFromAddr(heap_begin), card_table->CardFromAddr(heap_end),
+            CardTable::kCardDirty);
+  // Neither end of the range is huge-page aligned in the card table.
+  uint8_t* start = heap_begin + (gPMDSize / 2) * CardTable::kCardSize;
+  uint8_t* end = heap_end - (gPMDSize / 2 + 1) * CardTable::kCardSize;
+  card_table->ClearCardRange(start, end);
+  for (uint8_t* addr = heap_begin; addr < heap_end; addr += CardTable::kCardSize) {
+    uint8_t expected = (addr >= start && addr < end) ? CardTable::kCardClean
+                                                     : CardTable::kCardDirty;
+    ASSERT_EQ(expected, *card_table->CardFromAddr(addr)) << reinterpret_cast<void*>(addr);
+  }
+}
+
 // TODO: Add test for CardTable::Scan.
 }  // namespace accounting
 }  // namespace gc
@@ -292,8 +292,13 @@ namespace collector {
 // significantly.
 static constexpr bool kCheckLocks = kDebugLocking;
 static constexpr bool kVerifyRootsMarked = kIsDebugBuild;
-// Two threads should suffice on devices.
-static constexpr size_t kMaxNumUffdWorkers = 2;
+// Upper bound on the number of compaction worker threads. The actual number
+// follows Heap::GetParallelGCThreadCount(), which defaults to the number of
+// cores minus one.
+static constexpr size_t kMaxNumUffdWorkers = 32;
+// Number of to-space bytes claimed at a time by parallel compaction workers in
+// SIGBUS feature case.
+static constexpr size_t kParallelCompactionChunkSize = 256 * KB;
 // Number of compaction buffers reserved for mutator threads in SIGBUS feature
 // case. It's extremely unlikely that we will ever have more than these number
 // of mutator threads trying to access the moving-space during one compaction
@@ -418,6 +423,8 @@ MarkCompact::MarkCompact(Heap* heap)
       uffd_(kFdUnused),
       sigbus_in_progress_count_(kSigbusCounterCompactionDoneMask),
       compaction_in_progress_count_(0),
+      parallel_compaction_cursor_(0),
+      gc_compaction_page_idx_(0),
       thread_pool_counter_(0),
       compacting_(false),
       uffd_initialized_(false),
@@ -508,9 +515,10 @@ MarkCompact::MarkCompact(Heap* heap)
       LOG(WARNING) << "Failed to allocate concurrent mark-compact moving-space shadow: " << err_msg;
     }
   }
+  // In SIGBUS feature case, the buffers for parallel compaction workers follow
+  // those reserved for mutators.
   const size_t num_pages =
-      1 + (use_uffd_sigbus_ ? kMutatorCompactionBufferCount :
-                              std::min(heap_->GetParallelGCThreadCount(), kMaxNumUffdWorkers));
+      1 + (use_uffd_sigbus_ ? kMutatorCompactionBufferCount : 0) + NumCompactionWorkers();
   compaction_buffers_map_ = MemMap::MapAnonymous("Concurrent mark-compact compaction buffers",
                                                  gPageSize * num_pages,
                                                  PROT_READ | PROT_WRITE,
@@ -796,7 +804,7 @@ void MarkCompact::RunPhases() {
     ReclaimPhase();
     PrepareForCompaction();
   }
-  if (uffd_ != kFallbackMode && !use_uffd_sigbus_) {
+  if (uffd_ != kFallbackMode && heap_->GetThreadPool() != nullptr) {
     heap_->GetThreadPool()->WaitForWorkersToBeCreated();
   }
 
@@ -981,6 +989,12 @@ bool MarkCompact::CanCompactMovingSpaceWithMinorFault() {
          shadow_to_space_map_.Size() >= min_size;
 }
 
+size_t MarkCompact::NumCompactionWorkers() const {
+  // On devices with 2 cores, GetParallelGCThreadCount() will return 1, which
+  // is desired number of workers on such devices.
+  return std::min(heap_->GetParallelGCThreadCount(), kMaxNumUffdWorkers);
+}
+
 class MarkCompact::ConcurrentCompactionGcTask : public SelfDeletingTask {
  public:
   explicit ConcurrentCompactionGcTask(MarkCompact* collector, size_t idx)
@@ -994,6 +1008,7 @@ class MarkCompact::ConcurrentCompactionGcTask : public SelfDeletingTask {
       // gPageSize buffer for compacting and updating objects into and then
       // passing the buf to uffd ioctls.
       uint8_t* buf = collector_->compaction_buffers_map_.Begin() + index_ * gPageSize;
+      CHECK_LE(buf + gPageSize, collector_->compaction_buffers_map_.End());
       collector_->ConcurrentCompaction<MarkCompact::kCopyMode>(buf);
     }
   }
@@ -1003,6 +1018,26 @@ class MarkCompact::ConcurrentCompactionGcTask : public SelfDeletingTask {
   size_t index_;
 };
 
+// Used in SIGBUS feature case to compact the moving space in parallel with the
+// gc-thread, rather than leaving it all to the gc-thread and the faulting
+// mutators.
+class MarkCompact::ParallelCompactionGcTask : public SelfDeletingTask {
+ public:
+  explicit ParallelCompactionGcTask(MarkCompact* collector, size_t idx)
+      : collector_(collector), index_(idx) {}
+
+  void Run([[maybe_unused]] Thread* self) override REQUIRES_SHARED(Locks::mutator_lock_) {
+    uint8_t* buf = collector_->compaction_buffers_map_.Begin() +
+                   (kMutatorCompactionBufferCount + index_) * gPageSize;
+    CHECK_LE(buf + gPageSize, collector_->compaction_buffers_map_.End());
+    collector_->ParallelCompactMovingSpace(buf);
+  }
+
+ private:
+  MarkCompact* const collector_;
+  size_t index_;
+};
+
 void MarkCompact::PrepareForCompaction() {
   uint8_t* space_begin = bump_pointer_space_->Begin();
   size_t vector_len = (black_allocations_begin_ - space_begin) / kOffsetChunkSize;
@@ -1095,15 +1130,21 @@ void MarkCompact::PrepareForCompaction() {
   // and get rid of it when finished. This is expected to happen rarely as
   // zygote spends most of the time in native fork loop.
   if (uffd_ != kFallbackMode) {
-    if (!use_uffd_sigbus_) {
+    if (use_uffd_sigbus_) {
+      // The parallel compaction tasks are added in CompactionPhase() once it is
+      // known whether copy-mode is used.
+      if (heap_->GetThreadPool() == nullptr && NumCompactionWorkers() > 0) {
+        heap_->CreateThreadPool(NumCompactionWorkers());
+      }
+    } else {
       ThreadPool* pool = heap_->GetThreadPool();
       if (UNLIKELY(pool == nullptr)) {
-        // On devices with 2 cores, GetParallelGCThreadCount() will return 1,
-        // which is desired number of workers on such devices.
-        heap_->CreateThreadPool(std::min(heap_->GetParallelGCThreadCount(), kMaxNumUffdWorkers));
+        heap_->CreateThreadPool(NumCompactionWorkers());
         pool = heap_->GetThreadPool();
       }
-      size_t num_threads = pool->GetThreadCount();
+      // The pool may have been created with more threads than we have
+      // compaction buffers for.
+      size_t num_threads = std::min(pool->GetThreadCount(), NumCompactionWorkers());
       thread_pool_counter_ = num_threads;
       for (size_t i = 0; i < num_threads; i++) {
         pool->AddTask(thread_running_gc_, new ConcurrentCompactionGcTask(this, i + 1));
@@ -2121,6 +2162,10 @@ void MarkCompact::FreeFromSpacePages(size_t cur_page_idx, int mode) {
       // Some mutator is working on the page.
       break;
     }
+    if (use_uffd_sigbus_ && mode == kCopyMode && state == PageState::kProcessingAndMapping) {
+      // Some parallel compaction worker is working on the page.
+      break;
+    }
     DCHECK(state >= PageState::kProcessed ||
            (state == PageState::kUnprocessed &&
             (mode == kFallbackMode || idx > moving_first_objs_count_)));
@@ -2216,6 +2261,13 @@ void MarkCompact::FreeFromSpacePages(size_t cur_page_idx, int mode) {
     break;
   }
 
+  if (heap_->UseTransparentHugePages()) {
+    // Only hand back whole huge pages so that the from-space pages which are still needed keep
+    // their huge-page backing. The rest is released with the whole from-space after compaction.
+    // It is the from-space address that has to be huge-page aligned, and the slide need not be.
+    reclaim_begin =
+        AlignUp(reclaim_begin + from_space_slide_diff_, gPMDSize) - from_space_slide_diff_;
+  }
   ssize_t size = last_reclaimed_page_ - reclaim_begin;
   if (size >= kMinFromSpaceMadviseSize) {
     int behavior = minor_fault_initialized_ ? MADV_REMOVE : MADV_DONTNEED;
@@ -2282,6 +2334,9 @@ void MarkCompact::CompactMovingSpace(uint8_t* page) {
   mirror::Object* next_page_first_obj = nullptr;
   while (idx > moving_first_objs_count_) {
     idx--;
+    if (kMode == kCopyMode) {
+      gc_compaction_page_idx_.store(idx, std::memory_order_relaxed);
+    }
     pre_compact_page -= gPageSize;
     to_space_end -= gPageSize;
     if (kMode == kMinorFaultMode) {
@@ -2317,6 +2372,9 @@ void MarkCompact::CompactMovingSpace(uint8_t* page) {
 
   while (idx > 0) {
     idx--;
+    if (kMode == kCopyMode) {
+      gc_compaction_page_idx_.store(idx, std::memory_order_relaxed);
+    }
     to_space_end -= gPageSize;
     if (kMode == kMinorFaultMode) {
       shadow_space_end -= gPageSize;
@@ -2334,6 +2392,68 @@ void MarkCompact::CompactMovingSpace(uint8_t* page) {
   DCHECK_EQ(to_space_end, bump_pointer_space_->Begin());
 }
 
+void MarkCompact::CompactMovingSpacePage(size_t idx, uint8_t* buf) {
+  size_t page_status_arr_len = moving_first_objs_count_ + black_page_count_;
+  DCHECK_LT(idx, page_status_arr_len);
+  uint8_t* to_space_page = bump_pointer_space_->Begin() + idx * gPageSize;
+  mirror::Object* first_obj = first_objs_moving_space_[idx].AsMirrorPtr();
+  if (idx >= moving_first_objs_count_) {
+    // Allocated-black page. CompactMovingSpace() skips the ones without objects.
+    if (first_obj == nullptr) {
+      return;
+    }
+    uint8_t* pre_compact_page =
+        black_allocations_begin_ + (idx - moving_first_objs_count_) * gPageSize;
+    mirror::Object* next_page_first_obj = idx + 1 < page_status_arr_len
+                                          ? first_objs_moving_space_[idx + 1].AsMirrorPtr()
+                                          : nullptr;
+    uint32_t first_chunk_size = black_alloc_pages_first_chunk_size_[idx];
+    DoPageCompactionWithStateChange<kCopyMode>(
+        idx,
+        page_status_arr_len,
+        to_space_page,
+        buf,
+        [&]() REQUIRES_SHARED(Locks::mutator_lock_) {
+          SlideBlackPage(first_obj,
+                         next_page_first_obj,
+                         first_chunk_size,
+                         pre_compact_page,
+                         buf,
+                         /*needs_memset_zero=*/true);
+        });
+  } else {
+    DoPageCompactionWithStateChange<kCopyMode>(
+        idx,
+        page_status_arr_len,
+        to_space_page,
+        buf,
+        [&]() REQUIRES_SHARED(Locks::mutator_lock_) {
+          CompactPage(first_obj,
+                      pre_compact_offset_moving_space_[idx],
+                      buf,
+                      /*needs_memset_zero=*/true);
+        });
+  }
+}
+
+void MarkCompact::ParallelCompactMovingSpace(uint8_t* buf) {
+  // The gc-thread compacts in reverse direction (see CompactMovingSpace()) as
+  // that's the order in which from-space pages can be freed. The workers claim
+  // chunks of pages from the other end until they meet the gc-thread.
+  const size_t chunk_pages = kParallelCompactionChunkSize / gPageSize;
+  while (true) {
+    size_t begin = parallel_compaction_cursor_.fetch_add(chunk_pages, std::memory_order_relaxed);
+    size_t end =
+        std::min(begin + chunk_pages, gc_compaction_page_idx_.load(std::memory_order_relaxed));
+    if (begin >= end) {
+      break;
+    }
+    for (size_t idx = begin; idx < end; idx++) {
+      CompactMovingSpacePage(idx, buf);
+    }
+  }
+}
+
 void MarkCompact::UpdateNonMovingPage(mirror::Object* first, uint8_t* page) {
   DCHECK_LT(reinterpret_cast<uint8_t*>(first), page + gPageSize);
   // For every object found in the page, visit the previous object. This ensures
@@ -3117,6 +3237,12 @@ void MarkCompact::KernelPreparation() {
                             moving_space_size,
                             moving_to_space_fd_,
                             shadow_addr);
+  if (heap_->UseTransparentHugePages() && !gHaveMremapDontunmap &&
+      moving_to_space_fd_ == kFdUnused) {
+    // The moving space was mmapped afresh above and lost its MADV_HUGEPAGE advice. The mremapped
+    // from-space keeps the advice as it is a property of the VMA.
+    madvise(moving_space_begin, moving_space_size, MADV_HUGEPAGE);
+  }
 
   if (IsValidFd(uffd_)) {
     // Register the moving space with userfaultfd.
@@ -3768,7 +3894,25 @@ void MarkCompact::CompactionPhase() {
       ZeropageIoctl(unused_first_page, /*tolerate_eexist*/ true, /*tolerate_enoent*/ false);
       UnregisterUffd(unused_first_page, moving_space_size - used_size);
     }
+    ThreadPool* pool = use_uffd_sigbus_ ? heap_->GetThreadPool() : nullptr;
+    if (pool != nullptr) {
+      // The pool may have been created with more threads than we have
+      // compaction buffers for.
+      size_t num_threads = std::min(pool->GetThreadCount(), NumCompactionWorkers());
+      parallel_compaction_cursor_.store(0, std::memory_order_relaxed);
+      gc_compaction_page_idx_.store(moving_first_objs_count_ + black_page_count_,
+                                    std::memory_order_relaxed);
+      for (size_t i = 0; i < num_threads; i++) {
+        pool->AddTask(thread_running_gc_, new ParallelCompactionGcTask(this, i + 1));
+      }
+      pool->StartWorkers(thread_running_gc_);
+    }
     CompactMovingSpace<kCopyMode>(compaction_buffers_map_.Begin());
+    if (pool != nullptr) {
+      // The workers must be done with the from-space before it is released below.
+      pool->Wait(thread_running_gc_, /*do_work=*/ false, /*may_hold_locks=*/ true);
+      pool->StopWorkers(thread_running_gc_);
+    }
   }
 
   // Make sure no mutator is reading from the from-space before unregistering
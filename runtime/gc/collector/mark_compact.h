@@ -344,6 +344,14 @@ class MarkCompact final : public GarbageCollector {
   // userfaultfd.
   template <int kMode>
   void CompactMovingSpace(uint8_t* page) REQUIRES_SHARED(Locks::mutator_lock_);
+  // Compact the moving-space page at 'idx' in copy-mode using 'buf' as buffer,
+  // unless some other thread has already claimed it.
+  void CompactMovingSpacePage(size_t idx, uint8_t* buf) REQUIRES_SHARED(Locks::mutator_lock_);
+  // Called by thread-pool workers in SIGBUS feature case to compact chunks of
+  // the moving space alongside the gc-thread.
+  void ParallelCompactMovingSpace(uint8_t* buf) REQUIRES_SHARED(Locks::mutator_lock_);
+  // Number of thread-pool workers used for concurrent compaction.
+  size_t NumCompactionWorkers() const;
 
   // Compact the given page as per func and change its state. Also map/copy the
   // page, if required.
@@ -781,6 +789,11 @@ class MarkCompact final : public GarbageCollector {
   // When using SIGBUS feature, this counter is used by mutators to claim a page
   // out of compaction buffers to be used for the entire compaction cycle.
   std::atomic<uint16_t> compaction_buffer_counter_;
+  // Next moving-space page index to be claimed by parallel compaction workers.
+  std::atomic<size_t> parallel_compaction_cursor_;
+  // Moving-space page index the gc-thread is compacting in copy-mode. Parallel
+  // compaction workers stop when they reach it.
+  std::atomic<size_t> gc_compaction_page_idx_;
   // Used to exit from compaction loop at the end of concurrent compaction
   uint8_t thread_pool_counter_;
   // True while compacting.
@@ -824,6 +837,7 @@ class MarkCompact final : public GarbageCollector {
   class LinearAllocPageUpdater;
   class ImmuneSpaceUpdateObjVisitor;
   class ConcurrentCompactionGcTask;
+  class ParallelCompactionGcTask;
 
   DISALLOW_IMPLICIT_CONSTRUCTORS(MarkCompact);
 };
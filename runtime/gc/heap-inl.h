@@ -82,6 +82,7 @@ inline mirror::Object* Heap::AllocObjectWithAllocator(Thread* self,
   size_t usable_size;
   size_t new_num_bytes_allocated = 0;
   bool need_gc = false;
+  bool sample_allocation_site = false;
   uint32_t starting_gc_num;  // o.w. GC number at which we observed need for GC.
   {
     // Bytes allocated that includes bulk thread-local buffer allocations in addition to direct
@@ -214,6 +215,9 @@ inline mirror::Object* Heap::AllocObjectWithAllocator(Thread* self,
       }
       GetMetrics()->TotalBytesAllocated()->Add(bytes_tl_bulk_allocated);
       GetMetrics()->TotalBytesAllocatedDelta()->Add(bytes_tl_bulk_allocated);
+      // A TLAB refill samples the allocation site of the object that triggered it, which
+      // weighs allocation sites by the number of bytes they allocate.
+      sample_allocation_site = pretenure_allocation_sites_ && IsTLABAllocator(allocator);
     }
   }
   if (kIsDebugBuild && Runtime::Current()->IsStarted()) {
@@ -258,6 +262,9 @@ inline mirror::Object* Heap::AllocObjectWithAllocator(Thread* self,
   } else {
     DCHECK(!gc_stress_mode_);
   }
+  if (UNLIKELY(sample_allocation_site)) {
+    SampleAllocationSite(self, obj);
+  }
   if (need_gc) {
     // Do this only once thread suspension is allowed again, and we're done with kInstrumented.
     RequestConcurrentGCAndSaveObject(self, /*force_full=*/ false, starting_gc_num, &obj);
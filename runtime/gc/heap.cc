@@ -16,12 +16,14 @@
 
 #include "heap.h"
 
+#include <algorithm>
 #include <limits>
 #include "android-base/thread_annotations.h"
 #if defined(__BIONIC__) || defined(__GLIBC__) || defined(ANDROID_HOST_MUSL)
 #include <malloc.h>  // For mallinfo()
 #endif
 #include <memory>
+#include <numeric>
 #include <random>
 #include <unistd.h>
 #include <sys/types.h>
@@ -31,6 +33,7 @@
 
 #include "allocation_listener.h"
 #include "art_field-inl.h"
+#include "art_method-inl.h"
 #include "backtrace_helper.h"
 #include "base/allocator.h"
 #include "base/arena_allocator.h"
@@ -147,6 +150,14 @@ DEFINE_RUNTIME_DEBUG_FLAG(Heap, kStressCollectorTransition);
 // Minimum amount of remaining bytes before a concurrent GC is triggered.
 static constexpr size_t kMinConcurrentRemainingBytes = 128 * KB;
 static constexpr size_t kMaxConcurrentRemainingBytes = 512 * KB;
+// Bounds and step of the target utilization chosen by the adaptive ergonomics.
+static constexpr double kMinAdaptiveTargetUtilization = 0.25;
+static constexpr double kMaxAdaptiveTargetUtilization = 0.9;
+static constexpr double kAdaptiveTargetUtilizationStep = 0.05;
+// Upper bound for how much earlier than usual a concurrent GC may be started.
+static constexpr double kMaxAdaptiveConcurrentStartFactor = 8.0;
+// Weight of the previous value when smoothing the measured GC CPU fraction and allocation rate.
+static constexpr double kGcCpuFractionSmoothing = 0.5;
 // Sticky GC throughput adjustment, divided by 4. Increasing this causes sticky GC to occur more
 // relative to partial/full GC. This may be desirable since sticky GCs interfere less with mutator
 // threads (lower pauses, use less memory bandwidth).
@@ -302,7 +313,14 @@ Heap::Heap(size_t initial_size,
            bool use_generational_cc,
            uint64_t min_interval_homogeneous_space_compaction_by_oom,
            bool dump_region_info_before_gc,
-           bool dump_region_info_after_gc)
+           bool dump_region_info_after_gc,
+           bool use_transparent_huge_pages,
+           uint32_t gc_cpu_budget_percent,
+           uint32_t gc_pause_goal_ms,
+           bool pretenure_allocation_sites,
+           bool numa_aware_regions,
+           uint32_t fake_numa_nodes,
+           bool pin_gc_workers)
     : non_moving_space_(nullptr),
       rosalloc_space_(nullptr),
       dlmalloc_space_(nullptr),
@@ -314,6 +332,7 @@ Heap::Heap(size_t initial_size,
       pending_task_lock_(nullptr),
       parallel_gc_threads_(parallel_gc_threads),
       conc_gc_threads_(conc_gc_threads),
+      pin_gc_workers_(pin_gc_workers),
       low_memory_mode_(low_memory_mode),
       long_pause_log_threshold_(long_pause_log_threshold),
       long_gc_log_threshold_(long_gc_log_threshold),
@@ -419,10 +438,23 @@ Heap::Heap(size_t initial_size,
       gc_disabled_for_shutdown_(false),
       dump_region_info_before_gc_(dump_region_info_before_gc),
       dump_region_info_after_gc_(dump_region_info_after_gc),
+      use_transparent_huge_pages_(use_transparent_huge_pages),
+      gc_cpu_budget_(gc_cpu_budget_percent / 100.0),
+      gc_pause_goal_ns_(MsToNs(gc_pause_goal_ms)),
+      adaptive_target_utilization_(target_utilization),
+      adaptive_concurrent_start_factor_(1.0),
+      gc_cpu_fraction_(0.0),
+      last_ergonomics_update_time_ns_(0u),
+      last_ergonomics_gc_time_ns_(0u),
+      allocation_rate_(0.0),
+      last_ergonomics_bytes_allocated_ever_(0u),
+      pretenure_allocation_sites_(pretenure_allocation_sites),
       boot_image_spaces_(),
       boot_images_start_address_(0u),
       boot_images_size_(0u),
-      pre_oome_gc_count_(0u) {
+      pre_oome_gc_count_(0u),
+      tlab_refill_count_(0u),
+      tlab_waste_bytes_(0u) {
   if (VLOG_IS_ON(heap) || VLOG_IS_ON(startup)) {
     LOG(INFO) << "Heap() entering";
   }
@@ -639,15 +671,40 @@ Heap::Heap(size_t initial_size,
     CHECK(separate_non_moving_space);
     // Reserve twice the capacity, to allow evacuating every region for explicit GCs.
     MemMap region_space_mem_map =
-        space::RegionSpace::CreateMemMap(kRegionSpaceName, capacity_ * 2, request_begin);
+        space::RegionSpace::CreateMemMap(kRegionSpaceName,
+                                         capacity_ * 2,
+                                         request_begin,
+                                         use_transparent_huge_pages_);
     CHECK(region_space_mem_map.IsValid()) << "No region space mem map";
-    region_space_ = space::RegionSpace::Create(
-        kRegionSpaceName, std::move(region_space_mem_map), use_generational_cc_);
+    // -XX:FakeNumaNodes splits the regions between made-up nodes, for testing the placement on
+    // single-node machines.
+    std::vector<uint32_t> numa_nodes;
+    if (numa_aware_regions) {
+      if (fake_numa_nodes != 0u) {
+        numa_nodes.resize(fake_numa_nodes);
+        std::iota(numa_nodes.begin(), numa_nodes.end(), 0u);
+      } else {
+        numa_nodes = space::RegionSpace::GetConfiguredNumaNodes();
+      }
+    }
+    region_space_ = space::RegionSpace::Create(kRegionSpaceName,
+                                               std::move(region_space_mem_map),
+                                               use_generational_cc_,
+                                               use_transparent_huge_pages_,
+                                               numa_nodes,
+                                               /*fake_numa_topology=*/ fake_numa_nodes != 0u);
     AddSpace(region_space_);
   } else if (IsMovingGc(foreground_collector_type_)) {
     // Create bump pointer spaces.
     // We only to create the bump pointer if the foreground collector is a compacting GC.
     // TODO: Place bump-pointer spaces somewhere to minimize size of card table.
+    if (use_transparent_huge_pages_) {
+      for (MemMap* map : {&main_mem_map_1, &main_mem_map_2}) {
+        if (map->IsValid() && map->MadviseHugePages() != 0) {
+          PLOG(WARNING) << "Failed to madvise(MADV_HUGEPAGE) " << map->GetName();
+        }
+      }
+    }
     bump_pointer_space_ = space::BumpPointerSpace::CreateFromMemMap("Bump pointer space 1",
                                                                     std::move(main_mem_map_1));
     CHECK(bump_pointer_space_ != nullptr) << "Failed to create bump pointer space";
@@ -719,7 +776,8 @@ Heap::Heap(size_t initial_size,
   // reserved by the kernel.
   static constexpr size_t kMinHeapAddress = 4 * KB;
   card_table_.reset(accounting::CardTable::Create(reinterpret_cast<uint8_t*>(kMinHeapAddress),
-                                                  4 * GB - kMinHeapAddress));
+                                                  4 * GB - kMinHeapAddress,
+                                                  use_transparent_huge_pages_));
   CHECK(card_table_.get() != nullptr) << "Failed to create card table";
   if (foreground_collector_type_ == kCollectorTypeCC && kUseTableLookupReadBarrier) {
     rb_table_.reset(new accounting::ReadBarrierTable());
@@ -1128,6 +1186,9 @@ void Heap::CreateThreadPool(size_t num_threads) {
   }
   if (num_threads != 0) {
     thread_pool_.reset(new ThreadPool("Heap thread pool", num_threads));
+    if (pin_gc_workers_) {
+      thread_pool_->PinWorkersToCpus();
+    }
   }
 }
 
@@ -1297,6 +1358,9 @@ void Heap::DumpGcPerformanceInfo(std::ostream& os) {
   os << "Total blocking GC count: " << GetBlockingGcCount() << "\n";
   os << "Total blocking GC time: " << PrettyDuration(GetBlockingGcTime()) << "\n";
   os << "Total pre-OOME GC count: " << GetPreOomeGcCount() << "\n";
+  os << "Total TLAB refills: " << tlab_refill_count_.load(std::memory_order_relaxed) << "\n";
+  os << "Total TLAB waste: "
+     << PrettySize(tlab_waste_bytes_.load(std::memory_order_relaxed)) << "\n";
   {
     MutexLock mu(Thread::Current(), *gc_complete_lock_);
     if (gc_count_rate_histogram_.SampleSize() > 0U) {
@@ -1344,6 +1408,8 @@ void Heap::ResetGcPerformanceInfo() {
   blocking_gc_count_ = 0;
   blocking_gc_time_ = 0;
   pre_oome_gc_count_.store(0, std::memory_order_relaxed);
+  tlab_refill_count_.store(0, std::memory_order_relaxed);
+  tlab_waste_bytes_.store(0, std::memory_order_relaxed);
   gc_count_last_window_ = 0;
   blocking_gc_count_last_window_ = 0;
   last_update_time_gc_count_rate_histograms_ =  // Round down by the window duration.
@@ -1671,6 +1737,9 @@ void Heap::TrimSpaces(Thread* self) {
       }
     }
   }
+  if (large_object_space_ != nullptr) {
+    managed_reclaimed += large_object_space_->Trim();
+  }
   total_alloc_space_allocated = GetBytesAllocated();
   if (large_object_space_ != nullptr) {
     total_alloc_space_allocated -= large_object_space_->GetBytesAllocated();
@@ -3650,6 +3719,9 @@ void Heap::DumpForSigQuit(std::ostream& os) {
       }
     }
   }
+  os << "GC threads: " << parallel_gc_threads_ << " parallel, " << conc_gc_threads_
+     << " concurrent, " << GetEffectiveCpuCount() << " effective CPUs"
+     << (pin_gc_workers_ ? ", workers pinned" : "") << "\n";
   DumpGcPerformanceInfo(os);
 }
 
@@ -3713,12 +3785,34 @@ void Heap::GrowForUtilization(collector::GarbageCollector* collector_ran,
   MutexLock mu(Thread::Current(), process_state_update_lock_);
   // Use the multiplier to grow more for foreground.
   const double multiplier = HeapGrowthMultiplier();
+  double target_utilization = GetTargetHeapUtilization();
+  size_t max_free = max_free_;
+  if (IsAdaptiveErgonomicsEnabled()) {
+    AdaptiveErgonomicsSample sample;
+    sample.time_ns = NanoTime();
+    sample.gc_time_ns = 0u;
+    for (collector::GarbageCollector* collector : garbage_collectors_) {
+      sample.gc_time_ns += collector->GetCumulativeTimings().GetTotalNs();
+    }
+    sample.bytes_allocated_ever = GetBytesAllocatedEver();
+    sample.bytes_alive = bytes_allocated;
+    sample.gc_duration_ns = current_gc_iteration_.GetDurationNs();
+    const std::vector<uint64_t>& pauses = current_gc_iteration_.GetPauseTimes();
+    sample.max_pause_ns = pauses.empty() ? 0u : *std::max_element(pauses.begin(), pauses.end());
+    sample.gc_for_alloc = current_gc_iteration_.GetGcCause() == kGcCauseForAlloc;
+    UpdateAdaptiveErgonomics(sample);
+    // Scale max_free_ along with the growth implied by the adaptive target utilization.
+    const double free_scale = (1.0 / adaptive_target_utilization_ - 1.0) /
+                              (1.0 / target_utilization - 1.0);
+    target_utilization = adaptive_target_utilization_;
+    max_free = std::max(static_cast<size_t>(max_free_ * free_scale), min_free_);
+  }
   if (gc_type != collector::kGcTypeSticky) {
     // Grow the heap for non sticky GC.
-    uint64_t delta = bytes_allocated * (1.0 / GetTargetHeapUtilization() - 1.0);
+    uint64_t delta = bytes_allocated * (1.0 / target_utilization - 1.0);
     DCHECK_LE(delta, std::numeric_limits<size_t>::max()) << "bytes_allocated=" << bytes_allocated
-        << " target_utilization_=" << target_utilization_;
-    grow_bytes = std::min(delta, static_cast<uint64_t>(max_free_));
+        << " target_utilization=" << target_utilization;
+    grow_bytes = std::min(delta, static_cast<uint64_t>(max_free));
     grow_bytes = std::max(grow_bytes, static_cast<uint64_t>(min_free_));
     target_size = bytes_allocated + static_cast<uint64_t>(grow_bytes * multiplier);
     next_gc_type_ = collector::kGcTypeSticky;
@@ -3750,10 +3844,10 @@ void Heap::GrowForUtilization(collector::GarbageCollector* collector_ran,
       next_gc_type_ = non_sticky_gc_type;
     }
     // If we have freed enough memory, shrink the heap back down.
-    const size_t adjusted_max_free = static_cast<size_t>(max_free_ * multiplier);
+    const size_t adjusted_max_free = static_cast<size_t>(max_free * multiplier);
     if (bytes_allocated + adjusted_max_free < target_footprint) {
       target_size = bytes_allocated + adjusted_max_free;
-      grow_bytes = max_free_;
+      grow_bytes = max_free;
     } else {
       target_size = std::max(bytes_allocated, target_footprint);
       // The same whether jank perceptible or not; just avoid the adjustment.
@@ -3792,8 +3886,17 @@ void Heap::GrowForUtilization(collector::GarbageCollector* collector_ran,
       // Calculate when to perform the next ConcurrentGC.
       // Estimate how many remaining bytes we will have when we need to start the next GC.
       size_t remaining_bytes = bytes_allocated_during_gc;
+      if (IsAdaptiveErgonomicsEnabled()) {
+        // Also leave room for what the mutators allocate during a GC at the rate measured
+        // between GCs, which is usually higher than the rate while the GC runs.
+        remaining_bytes = std::max(
+            remaining_bytes,
+            static_cast<size_t>(allocation_rate_ * current_gc_iteration_.GetDurationNs()));
+      }
       remaining_bytes = std::min(remaining_bytes, kMaxConcurrentRemainingBytes);
       remaining_bytes = std::max(remaining_bytes, kMinConcurrentRemainingBytes);
+      // Start earlier if the adaptive ergonomics found that GCs do not finish in time.
+      remaining_bytes = static_cast<size_t>(remaining_bytes * adaptive_concurrent_start_factor_);
       size_t target_footprint = target_footprint_.load(std::memory_order_relaxed);
       if (UNLIKELY(remaining_bytes > target_footprint)) {
         // A never going to happen situation that from the estimated allocation rate we will exceed
@@ -3814,6 +3917,79 @@ void Heap::GrowForUtilization(collector::GarbageCollector* collector_ran,
           : 0;
     }
   }
+  if (IsAdaptiveErgonomicsEnabled()) {
+    metrics::ArtMetrics* metrics = Runtime::Current()->GetMetrics();
+    metrics->GcAdaptiveTargetUtilizationAvg()->Add(
+        static_cast<uint64_t>(adaptive_target_utilization_ * 100));
+    metrics->GcAdaptiveTargetFootprintAvg()->Add(
+        target_footprint_.load(std::memory_order_relaxed) / KB);
+    if (IsGcConcurrent()) {
+      metrics->GcAdaptiveConcurrentStartBytesAvg()->Add(concurrent_start_bytes_ / KB);
+    }
+  }
+}
+
+void Heap::UpdateAdaptiveErgonomics(const AdaptiveErgonomicsSample& sample) {
+  double utilization = adaptive_target_utilization_;
+  // The cumulative timings are reset with the GC performance info, skip the sample then.
+  if (last_ergonomics_update_time_ns_ != 0u &&
+      sample.time_ns > last_ergonomics_update_time_ns_ &&
+      sample.gc_time_ns >= last_ergonomics_gc_time_ns_ &&
+      sample.bytes_allocated_ever >= last_ergonomics_bytes_allocated_ever_) {
+    const double interval_ns =
+        static_cast<double>(sample.time_ns - last_ergonomics_update_time_ns_);
+    const double gc_cpu_sample = (sample.gc_time_ns - last_ergonomics_gc_time_ns_) / interval_ns;
+    gc_cpu_fraction_ = kGcCpuFractionSmoothing * gc_cpu_fraction_ +
+                       (1.0 - kGcCpuFractionSmoothing) * gc_cpu_sample;
+    const double allocation_rate_sample =
+        (sample.bytes_allocated_ever - last_ergonomics_bytes_allocated_ever_) / interval_ns;
+    allocation_rate_ = kGcCpuFractionSmoothing * allocation_rate_ +
+                       (1.0 - kGcCpuFractionSmoothing) * allocation_rate_sample;
+    if (gc_cpu_budget_ > 0.0) {
+      if (gc_cpu_fraction_ > gc_cpu_budget_) {
+        // Over budget: grow the heap so that GCs run less often.
+        utilization -= kAdaptiveTargetUtilizationStep;
+      } else if (sample.bytes_alive != 0u) {
+        // A GC as costly as this one stays within the budget if it runs at most every
+        // gc_duration / budget. Move towards the utilization that leaves enough free bytes
+        // for the mutators to allocate at the measured rate for that long.
+        const double free_bytes = allocation_rate_ * sample.gc_duration_ns / gc_cpu_budget_;
+        const double desired = sample.bytes_alive / (sample.bytes_alive + free_bytes);
+        utilization = std::clamp(desired,
+                                 utilization - kAdaptiveTargetUtilizationStep,
+                                 utilization + kAdaptiveTargetUtilizationStep);
+      }
+    }
+  }
+  if (gc_pause_goal_ns_ != 0u) {
+    // A GC for alloc means that a mutator had to wait for the heap to be collected.
+    if (sample.max_pause_ns > gc_pause_goal_ns_ || sample.gc_for_alloc) {
+      adaptive_concurrent_start_factor_ =
+          std::min(adaptive_concurrent_start_factor_ * 2, kMaxAdaptiveConcurrentStartFactor);
+      utilization -= kAdaptiveTargetUtilizationStep;
+    } else {
+      adaptive_concurrent_start_factor_ = std::max(adaptive_concurrent_start_factor_ * 0.9, 1.0);
+      if (gc_cpu_budget_ == 0.0 && utilization < target_utilization_) {
+        // Without a CPU budget nothing else gives memory back, so recover towards the
+        // configured utilization once the pauses are within the goal again.
+        utilization = std::min(utilization + kAdaptiveTargetUtilizationStep, target_utilization_);
+      }
+    }
+  }
+  adaptive_target_utilization_ =
+      std::clamp(utilization, kMinAdaptiveTargetUtilization, kMaxAdaptiveTargetUtilization);
+  last_ergonomics_update_time_ns_ = sample.time_ns;
+  last_ergonomics_gc_time_ns_ = sample.gc_time_ns;
+  last_ergonomics_bytes_allocated_ever_ = sample.bytes_allocated_ever;
+  VLOG(heap) << "Adaptive ergonomics: gc cpu fraction=" << gc_cpu_fraction_
+             << " allocation rate=" << PrettySize(static_cast<uint64_t>(allocation_rate_ * 1e9))
+             << "/s target utilization=" << adaptive_target_utilization_
+             << " concurrent start factor=" << adaptive_concurrent_start_factor_;
+}
+
+double Heap::GetAdaptiveTargetUtilization() {
+  MutexLock mu(Thread::Current(), process_state_update_lock_);
+  return adaptive_target_utilization_;
 }
 
 void Heap::ClampGrowthLimit() {
@@ -4365,6 +4541,31 @@ void Heap::InitPerfettoJavaHeapProf() {
   VLOG(heap) << "Java Heap Profiler Initialized";
 }
 
+AllocatorType Heap::GetPretenureAllocator() const {
+  // `Size()` is a relaxed load of the end of the space, so this does not need the space lock.
+  // The value may be stale by the time we allocate, which is fine for a heuristic: the
+  // non-moving allocator still falls back to a GC or an OOME when the space is full.
+  if (non_moving_space_->Size() > non_moving_space_->Capacity() / 2) {
+    return GetCurrentAllocator();
+  }
+  return GetCurrentNonMovingAllocator();
+}
+
+void Heap::SampleAllocationSite(Thread* self, ObjPtr<mirror::Object> obj) {
+  jit::Jit* jit = Runtime::Current()->GetJit();
+  if (jit == nullptr) {
+    return;
+  }
+  // The stack walk is only done once per TLAB, which keeps the cost of sampling low.
+  uint32_t dex_pc = dex::kDexNoIndex;
+  ArtMethod* method =
+      self->GetCurrentMethod(&dex_pc, /*check_suspended=*/ false, /*abort_on_error=*/ false);
+  if (method == nullptr || method->IsNative() || dex_pc == dex::kDexNoIndex) {
+    return;
+  }
+  jit->GetCodeCache()->AddAllocationSample(self, method, dex_pc, obj);
+}
+
 void Heap::JHPCheckNonTlabSampleAllocation(Thread* self, mirror::Object* obj, size_t alloc_size) {
   bool take_sample = false;
   size_t bytes_until_sample = 0;
@@ -4480,6 +4681,25 @@ void Heap::RemoveGcPauseListener() {
   gc_pause_listener_.store(nullptr, std::memory_order_relaxed);
 }
 
+size_t Heap::NextTlabSize(Thread* self, size_t default_size, size_t max_size) {
+  uint32_t gc_num = GetCurrentGcNum();
+  size_t size = self->GetDesiredTlabSize();
+  if (size == 0u) {
+    // First TLAB of this thread.
+    size = default_size;
+    self->SetDesiredTlabSize(size, gc_num);
+  } else if (gc_num != self->GetTlabResizeGcNum()) {
+    // Average the current size with the size that would have given the target number of
+    // refills per GC, so that a single burst does not resize the TLAB all at once. Threads
+    // that stay idle over several GCs get smaller TLABs.
+    size_t gcs = gc_num - self->GetTlabResizeGcNum();
+    size_t target_size = self->GetTlabBytesSinceResize() / gcs / kTargetTlabRefillsPerGc;
+    size = std::clamp((size + target_size) / 2, kMinAdaptiveTlabSize, max_size);
+    self->SetDesiredTlabSize(size, gc_num);
+  }
+  return std::clamp(size, kMinAdaptiveTlabSize, max_size);
+}
+
 mirror::Object* Heap::AllocWithNewTLAB(Thread* self,
                                        AllocatorType allocator_type,
                                        size_t alloc_size,
@@ -4497,10 +4717,11 @@ mirror::Object* Heap::AllocWithNewTLAB(Thread* self,
     // There is enough space if we grow the TLAB. Lets do that. This increases the
     // TLAB bytes.
     const size_t min_expand_size = alloc_size - self->TlabSize();
-    size_t next_tlab_size =
-        jhp_enabled ? JHPCalculateNextTlabSize(
-                          self, kPartialTlabSize, alloc_size, &take_sample, &bytes_until_sample) :
-                      kPartialTlabSize;
+    size_t next_tlab_size = NextTlabSize(self, kPartialTlabSize, space::RegionSpace::kRegionSize);
+    if (jhp_enabled) {
+      next_tlab_size = JHPCalculateNextTlabSize(
+          self, next_tlab_size, alloc_size, &take_sample, &bytes_until_sample);
+    }
     const size_t expand_bytes = std::max(
         min_expand_size,
         std::min(self->TlabRemainingCapacity() - self->TlabSize(), next_tlab_size));
@@ -4516,7 +4737,11 @@ mirror::Object* Heap::AllocWithNewTLAB(Thread* self,
     // TODO: for large allocations, which are rare, maybe we should allocate
     // that object and return. There is no need to revoke the current TLAB,
     // particularly if it's mostly unutilized.
-    size_t next_tlab_size = RoundDown(alloc_size + kDefaultTLABSize, gPageSize) - alloc_size;
+    const size_t max_tlab_size =
+        std::max(kDefaultTLABSize, bump_pointer_space_->Capacity() / kMovingSpaceTlabFraction);
+    size_t next_tlab_size =
+        std::max(NextTlabSize(self, kDefaultTLABSize, max_tlab_size), gPageSize);
+    next_tlab_size = RoundDown(alloc_size + next_tlab_size, gPageSize) - alloc_size;
     if (jhp_enabled) {
       next_tlab_size = JHPCalculateNextTlabSize(
           self, next_tlab_size, alloc_size, &take_sample, &bytes_until_sample);
@@ -4541,8 +4766,9 @@ mirror::Object* Heap::AllocWithNewTLAB(Thread* self,
       if (LIKELY(!IsOutOfMemoryOnAllocation(allocator_type,
                                             space::RegionSpace::kRegionSize,
                                             grow))) {
-        size_t next_pr_tlab_size =
-            kUsePartialTlabs ? kPartialTlabSize : gc::space::RegionSpace::kRegionSize;
+        size_t next_pr_tlab_size = kUsePartialTlabs
+            ? NextTlabSize(self, kPartialTlabSize, space::RegionSpace::kRegionSize)
+            : space::RegionSpace::kRegionSize;
         if (jhp_enabled) {
           next_pr_tlab_size = JHPCalculateNextTlabSize(
               self, next_pr_tlab_size, alloc_size, &take_sample, &bytes_until_sample);
@@ -4594,6 +4820,8 @@ mirror::Object* Heap::AllocWithNewTLAB(Thread* self,
     }
   }
   // Refilled TLAB, return.
+  self->AddTlabBytesSinceResize(*bytes_tl_bulk_allocated);
+  tlab_refill_count_.fetch_add(1u, std::memory_order_relaxed);
   ret = self->AllocTlab(alloc_size);
   DCHECK(ret != nullptr);
   *bytes_allocated = alloc_size;
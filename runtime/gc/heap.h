@@ -147,6 +147,11 @@ class Heap {
   static constexpr size_t kDefaultLongGCLogThreshold = MsToNs(100);
   static constexpr size_t kDefaultLongGCLogThresholdGcStress = MsToNs(1000);
   static constexpr size_t kDefaultTLABSize = 32 * KB;
+  // Bounds and target of the adaptive TLAB sizing, see NextTlabSize().
+  static constexpr size_t kMinAdaptiveTlabSize = 8 * KB;
+  static constexpr size_t kTargetTlabRefillsPerGc = 50;
+  // A CMC TLAB is never larger than this fraction of the moving space.
+  static constexpr size_t kMovingSpaceTlabFraction = 64;
   static constexpr double kDefaultTargetUtilization = 0.6;
   static constexpr double kDefaultHeapGrowthMultiplier = 2.0;
   // Primitive arrays larger than this size are put in the large object space.
@@ -240,7 +245,14 @@ class Heap {
        bool use_generational_cc,
        uint64_t min_interval_homogeneous_space_compaction_by_oom,
        bool dump_region_info_before_gc,
-       bool dump_region_info_after_gc);
+       bool dump_region_info_after_gc,
+       bool use_transparent_huge_pages,
+       uint32_t gc_cpu_budget_percent,
+       uint32_t gc_pause_goal_ms,
+       bool pretenure_allocation_sites,
+       bool numa_aware_regions,
+       uint32_t fake_numa_nodes,
+       bool pin_gc_workers);
 
   ~Heap();
 
@@ -312,6 +324,11 @@ class Heap {
         GetCurrentNonMovingAllocator() : GetCurrentAllocator();
   }
 
+  // Returns the allocator used for objects of allocation sites found to be long-lived. This is
+  // the non-moving allocator, unless the non-moving space is already more than half full, in
+  // which case we keep the remaining room for objects that must not move.
+  AllocatorType GetPretenureAllocator() const;
+
   // Visit all of the live objects in the heap.
   template <typename Visitor>
   ALWAYS_INLINE void VisitObjects(Visitor&& visitor)
@@ -535,6 +552,25 @@ class Heap {
     return low_memory_mode_;
   }
 
+  // Returns true if the heap is sized from the GC CPU budget and pause goal rather than from the
+  // fixed target utilization.
+  bool IsAdaptiveErgonomicsEnabled() const {
+    return gc_cpu_budget_ > 0.0 || gc_pause_goal_ns_ != 0u;
+  }
+
+  // Returns the target utilization currently chosen by the adaptive ergonomics.
+  double GetAdaptiveTargetUtilization() REQUIRES(!process_state_update_lock_);
+
+  // Returns true if the heap spaces are backed by transparent huge pages.
+  bool UseTransparentHugePages() const {
+    return use_transparent_huge_pages_;
+  }
+
+  // Returns true if allocations are sampled to find the allocation sites worth pretenuring.
+  bool PretenureAllocationSites() const {
+    return pretenure_allocation_sites_;
+  }
+
   // Returns the heap growth multiplier, this affects how much we grow the heap after a GC.
   // Scales heap growth, min free, and max free.
   double HeapGrowthMultiplier() const;
@@ -911,6 +947,16 @@ class Heap {
   }
   uint64_t GetPreOomeGcCount() const;
 
+  // Returns the size of the next TLAB, or TLAB expansion, for `self`. The size adapts to the
+  // bytes the thread allocated per GC since it was last resized, so that the thread refills
+  // about kTargetTlabRefillsPerGc times between GCs, and is clamped to `max_size`.
+  size_t NextTlabSize(Thread* self, size_t default_size, size_t max_size);
+
+  // Record `bytes` left unused at the end of a TLAB when it was retired.
+  void RecordTlabWaste(size_t bytes) {
+    tlab_waste_bytes_.fetch_add(bytes, std::memory_order_relaxed);
+  }
+
   // Perfetto Art Heap Profiler Support.
   HeapSampler& GetHeapSampler() {
     return heap_sampler_;
@@ -1221,6 +1267,23 @@ class Heap {
                           size_t bytes_allocated_before_gc = 0)
       REQUIRES(!process_state_update_lock_);
 
+  // Measurements taken at the end of a GC, the input of UpdateAdaptiveErgonomics().
+  struct AdaptiveErgonomicsSample {
+    uint64_t time_ns;               // Wall time at the end of the GC.
+    uint64_t gc_time_ns;            // Cumulative time spent in all collectors.
+    uint64_t bytes_allocated_ever;  // Bytes allocated since the start of the process.
+    size_t bytes_alive;             // Bytes allocated once the GC is done.
+    uint64_t gc_duration_ns;        // Duration of the GC.
+    uint64_t max_pause_ns;          // Longest pause of the GC.
+    bool gc_for_alloc;              // Whether a mutator had to wait for the GC to allocate.
+  };
+
+  // Adjust adaptive_target_utilization_ and adaptive_concurrent_start_factor_ from the GC time
+  // and allocation rate measured since the last update and the pauses of the GC that just
+  // finished.
+  void UpdateAdaptiveErgonomics(const AdaptiveErgonomicsSample& sample)
+      REQUIRES(process_state_update_lock_);
+
   size_t GetPercentFree();
 
   // Swap the allocation stack with the live stack.
@@ -1235,6 +1298,11 @@ class Heap {
                     bool clear_alloc_space_cards)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Report `obj` to the JIT as a sample of the allocation site of the current method, so that
+  // the survival of the samples can later decide whether the site gets pretenured.
+  void SampleAllocationSite(Thread* self, ObjPtr<mirror::Object> obj)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
   // Push an object onto the allocation stack.
   void PushOnAllocationStack(Thread* self, ObjPtr<mirror::Object>* obj)
       REQUIRES_SHARED(Locks::mutator_lock_)
@@ -1372,6 +1440,9 @@ class Heap {
   // How many GC threads we may use for unpaused parts of garbage collection.
   const size_t conc_gc_threads_;
 
+  // Whether the workers of the heap thread pool are pinned to CPUs, see -XX:PinGCWorkers.
+  const bool pin_gc_workers_;
+
   // Boolean for if we are in low memory mode.
   const bool low_memory_mode_;
 
@@ -1722,6 +1793,30 @@ class Heap {
   bool dump_region_info_before_gc_;
   bool dump_region_info_after_gc_;
 
+  // Turned on by -XX:UseTransparentHugePages to back the moving space, the region space and the
+  // card table with transparent huge pages, and to release their memory in whole huge pages.
+  const bool use_transparent_huge_pages_;
+
+  // Adaptive heap ergonomics, see UpdateAdaptiveErgonomics(). Turned on by a non-zero GC CPU
+  // budget (as a fraction of wall time) or pause goal.
+  const double gc_cpu_budget_;
+  const uint64_t gc_pause_goal_ns_;
+  // Target utilization used by GrowForUtilization() in place of target_utilization_.
+  double adaptive_target_utilization_ GUARDED_BY(process_state_update_lock_);
+  // Scales the headroom left for allocations during a concurrent GC, i.e. how early it starts.
+  double adaptive_concurrent_start_factor_ GUARDED_BY(process_state_update_lock_);
+  // Smoothed fraction of wall time spent in GC, and the inputs at the previous update.
+  double gc_cpu_fraction_ GUARDED_BY(process_state_update_lock_);
+  uint64_t last_ergonomics_update_time_ns_ GUARDED_BY(process_state_update_lock_);
+  uint64_t last_ergonomics_gc_time_ns_ GUARDED_BY(process_state_update_lock_);
+  // Smoothed allocation rate in bytes per nanosecond, and the input at the previous update.
+  double allocation_rate_ GUARDED_BY(process_state_update_lock_);
+  uint64_t last_ergonomics_bytes_allocated_ever_ GUARDED_BY(process_state_update_lock_);
+
+  // Turned on by -XX:PretenureAllocationSites to sample the allocation site of the object
+  // allocated at each TLAB refill, see SampleAllocationSite().
+  const bool pretenure_allocation_sites_;
+
   // Boot image spaces.
   std::vector<space::ImageSpace*> boot_image_spaces_;
 
@@ -1732,6 +1827,10 @@ class Heap {
   // The number of times we initiated a GC of last resort to try to avoid an OOME.
   Atomic<uint64_t> pre_oome_gc_count_;
 
+  // The number of TLAB refills and expansions, and the bytes left unused in retired TLABs.
+  Atomic<uint64_t> tlab_refill_count_;
+  Atomic<uint64_t> tlab_waste_bytes_;
+
   // An installed allocation listener.
   Atomic<AllocationListener*> alloc_listener_;
   // An installed GC Pause listener.
@@ -1752,6 +1851,8 @@ class Heap {
   friend class VerifyReferenceCardVisitor;
   friend class VerifyReferenceVisitor;
   friend class VerifyObjectVisitor;
+  ART_FRIEND_TEST(AdaptiveErgonomicsHeapTest, AllocationRateDrivesUtilization);
+  ART_FRIEND_TEST(PauseGoalHeapTest, UtilizationFollowsPauses);
 
   DISALLOW_IMPLICIT_CONSTRUCTORS(Heap);
 };
@@ -21,12 +21,15 @@
 #include "common_runtime_test.h"
 #include "gc/accounting/card_table-inl.h"
 #include "gc/accounting/space_bitmap-inl.h"
+#include "gc/space/region_space-inl.h"
 #include "handle_scope-inl.h"
+#include "mirror/array-alloc-inl.h"
 #include "mirror/class-inl.h"
 #include "mirror/object-inl.h"
 #include "mirror/object_array-alloc-inl.h"
 #include "mirror/object_array-inl.h"
 #include "scoped_thread_state_change-inl.h"
+#include "thread_pool.h"
 
 namespace art {
 namespace gc {
@@ -106,6 +109,103 @@ TEST_F(HeapTest, DumpGCPerformanceOnShutdown) {
   Runtime::Current()->SetDumpGCPerformanceOnShutdown(true);
 }
 
+TEST_F(HeapTest, AdaptiveTlabSize) {
+  Heap* heap = Runtime::Current()->GetHeap();
+  Thread* self = Thread::Current();
+  constexpr size_t kMaxTlabSize = 1 * MB;
+  // A thread starts with the default size.
+  self->SetDesiredTlabSize(0u, heap->GetCurrentGcNum());
+  EXPECT_EQ(Heap::kDefaultTLABSize, heap->NextTlabSize(self, Heap::kDefaultTLABSize, kMaxTlabSize));
+
+  // A thread allocating heavily between two GCs gets bigger TLABs, up to the maximum.
+  self->AddTlabBytesSinceResize(Heap::kTargetTlabRefillsPerGc * 4 * kMaxTlabSize);
+  heap->CollectGarbage(/* clear_soft_references= */ false);
+  size_t busy_size = heap->NextTlabSize(self, Heap::kDefaultTLABSize, kMaxTlabSize);
+  EXPECT_EQ(kMaxTlabSize, busy_size);
+
+  // A thread not allocating between GCs gets smaller TLABs, down to the minimum.
+  size_t idle_size = busy_size;
+  for (size_t i = 0; i < 16; ++i) {
+    heap->CollectGarbage(/* clear_soft_references= */ false);
+    size_t size = heap->NextTlabSize(self, Heap::kDefaultTLABSize, kMaxTlabSize);
+    EXPECT_LE(size, idle_size);
+    idle_size = size;
+  }
+  EXPECT_LT(idle_size, busy_size);
+  EXPECT_GE(idle_size, Heap::kMinAdaptiveTlabSize);
+}
+
+TEST_F(HeapTest, NumaAwareRegionAllocation) {
+  using space::RegionSpace;
+  Thread* self = Thread::Current();
+  ScopedObjectAccess soa(self);
+  // Node ids need not be contiguous.
+  const std::vector<uint32_t> kNodes = {0u, 2u, 5u, 7u};
+  const size_t kNumNodes = kNodes.size();
+  constexpr size_t kNumRegions = 16;
+  const size_t kRegionsPerNode = kNumRegions / kNumNodes;
+  MemMap mem_map = RegionSpace::CreateMemMap("NUMA region space",
+                                             kNumRegions * RegionSpace::kRegionSize,
+                                             /*requested_begin=*/ nullptr);
+  ASSERT_TRUE(mem_map.IsValid());
+  std::unique_ptr<RegionSpace> region_space(RegionSpace::Create("NUMA region space",
+                                                                std::move(mem_map),
+                                                                /*use_generational_cc=*/ false,
+                                                                /*use_huge_pages=*/ false,
+                                                                kNodes,
+                                                                /*fake_numa_topology=*/ true));
+  ASSERT_EQ(kNumNodes, region_space->GetNumNumaNodes());
+  const size_t node = region_space->GetNumaNode(self);
+  EXPECT_EQ(static_cast<size_t>(self->GetTid()) % kNumNodes, node);
+
+  // Every allocation needs a region of its own. The first ones come from the thread's node, and
+  // once those are used up, from the next node. The space gives out at most half its regions.
+  const size_t alloc_size = RegionSpace::kRegionSize / 2 + kObjectAlignment;
+  for (size_t i = 0; i < kNumRegions / 2; ++i) {
+    size_t bytes_allocated, bytes_tl_bulk_allocated;
+    mirror::Object* obj = region_space->Alloc(
+        self, alloc_size, &bytes_allocated, nullptr, &bytes_tl_bulk_allocated);
+    ASSERT_TRUE(obj != nullptr);
+    size_t region =
+        (reinterpret_cast<uint8_t*>(obj) - region_space->Begin()) / RegionSpace::kRegionSize;
+    size_t expected_node = (node + i / kRegionsPerNode) % kNumNodes;
+    EXPECT_GE(region, region_space->GetNumaNodeFirstRegion(expected_node)) << i;
+    EXPECT_LT(region, region_space->GetNumaNodeFirstRegion(expected_node + 1)) << i;
+  }
+}
+
+TEST_F(HeapTest, ConfiguredNumaNodes) {
+  using space::RegionSpace;
+  std::vector<uint32_t> nodes = RegionSpace::GetConfiguredNumaNodes();
+  EXPECT_TRUE(std::is_sorted(nodes.begin(), nodes.end()));
+  EXPECT_TRUE(std::adjacent_find(nodes.begin(), nodes.end()) == nodes.end());
+
+  // The space binds its regions to the actual node ids, and maps the node of the current
+  // CPU back to the index of its range.
+  Thread* self = Thread::Current();
+  ScopedObjectAccess soa(self);
+  constexpr size_t kNumRegions = 16;
+  if (nodes.size() > kNumRegions) {
+    nodes.resize(kNumRegions);
+  }
+  MemMap mem_map = RegionSpace::CreateMemMap("NUMA region space",
+                                             kNumRegions * RegionSpace::kRegionSize,
+                                             /*requested_begin=*/ nullptr);
+  ASSERT_TRUE(mem_map.IsValid());
+  std::unique_ptr<RegionSpace> region_space(RegionSpace::Create("NUMA region space",
+                                                                std::move(mem_map),
+                                                                /*use_generational_cc=*/ false,
+                                                                /*use_huge_pages=*/ false,
+                                                                nodes,
+                                                                /*fake_numa_topology=*/ false));
+  EXPECT_EQ(std::max<size_t>(nodes.size(), 1u), region_space->GetNumNumaNodes());
+  EXPECT_LT(region_space->GetNumaNode(self), region_space->GetNumNumaNodes());
+  size_t bytes_allocated, bytes_tl_bulk_allocated;
+  mirror::Object* obj = region_space->Alloc(
+      self, kObjectAlignment, &bytes_allocated, nullptr, &bytes_tl_bulk_allocated);
+  EXPECT_TRUE(obj != nullptr);
+}
+
 bool AnyIsFalse(bool x, bool y) { return !x || !y; }
 
 TEST_F(HeapTest, GCMetrics) {
@@ -258,6 +358,229 @@ TEST_F(HeapTest, GCMetrics) {
   }
 }
 
+class AdaptiveErgonomicsHeapTest : public HeapTest {
+ public:
+  void SetUpRuntimeOptions(RuntimeOptions* options) override {
+    HeapTest::SetUpRuntimeOptions(options);
+    options->push_back(std::make_pair("-XX:GcCpuBudgetPercent=5", nullptr));
+    options->push_back(std::make_pair("-XX:GcPauseGoalMs=10", nullptr));
+  }
+};
+
+TEST_F(AdaptiveErgonomicsHeapTest, DecisionsAreBoundedAndReported) {
+  Heap* heap = Runtime::Current()->GetHeap();
+  ASSERT_TRUE(heap->IsAdaptiveErgonomicsEnabled());
+  for (size_t i = 0; i < 8; ++i) {
+    {
+      ScopedObjectAccess soa(Thread::Current());
+      StackHandleScope<1> hs(soa.Self());
+      Handle<mirror::String> string [[maybe_unused]] (
+          hs.NewHandle(mirror::String::AllocFromModifiedUtf8(soa.Self(), "test")));
+    }
+    heap->CollectGarbage(/* clear_soft_references= */ false);
+  }
+
+  double utilization = heap->GetAdaptiveTargetUtilization();
+  EXPECT_GE(utilization, 0.25);
+  EXPECT_LE(utilization, 0.9);
+
+  metrics::ArtMetrics* metrics = Runtime::Current()->GetMetrics();
+  EXPECT_FALSE(metrics->GcAdaptiveTargetUtilizationAvg()->IsNull());
+  EXPECT_FALSE(metrics->GcAdaptiveTargetFootprintAvg()->IsNull());
+}
+
+TEST_F(AdaptiveErgonomicsHeapTest, AllocationRateDrivesUtilization) {
+  Heap* heap = Runtime::Current()->GetHeap();
+  MutexLock mu(Thread::Current(), heap->process_state_update_lock_);
+  // One 10ms GC per second, well within the 5% CPU budget and the 10ms pause goal.
+  Heap::AdaptiveErgonomicsSample sample = {};
+  sample.time_ns = heap->last_ergonomics_update_time_ns_;
+  sample.gc_time_ns = heap->last_ergonomics_gc_time_ns_;
+  sample.bytes_allocated_ever = heap->last_ergonomics_bytes_allocated_ever_;
+  sample.bytes_alive = 16 * MB;
+  sample.gc_duration_ns = MsToNs(10);
+  sample.max_pause_ns = MsToNs(1);
+  const double initial = heap->adaptive_target_utilization_;
+
+  // Allocating 1GB/s needs 200MB of free space to keep GCs within budget: grow the heap.
+  for (size_t i = 0; i < 32; ++i) {
+    sample.time_ns += MsToNs(1000);
+    sample.gc_time_ns += MsToNs(10);
+    sample.bytes_allocated_ever += 1 * GB;
+    heap->UpdateAdaptiveErgonomics(sample);
+  }
+  const double fast = heap->adaptive_target_utilization_;
+  EXPECT_LT(fast, initial);
+  EXPECT_DOUBLE_EQ(0.25, fast);
+
+  // Allocating 1MB/s needs almost no free space: give memory back.
+  for (size_t i = 0; i < 32; ++i) {
+    sample.time_ns += MsToNs(1000);
+    sample.gc_time_ns += MsToNs(10);
+    sample.bytes_allocated_ever += 1 * MB;
+    heap->UpdateAdaptiveErgonomics(sample);
+  }
+  const double slow = heap->adaptive_target_utilization_;
+  EXPECT_GT(slow, fast);
+  EXPECT_DOUBLE_EQ(0.9, slow);
+
+  // Spending more than the budget in GC grows the heap whatever the allocation rate.
+  sample.time_ns += MsToNs(1000);
+  sample.gc_time_ns += MsToNs(500);
+  sample.bytes_allocated_ever += 1 * MB;
+  heap->UpdateAdaptiveErgonomics(sample);
+  EXPECT_LT(heap->adaptive_target_utilization_, slow);
+}
+
+class PauseGoalHeapTest : public HeapTest {
+ public:
+  void SetUpRuntimeOptions(RuntimeOptions* options) override {
+    HeapTest::SetUpRuntimeOptions(options);
+    options->push_back(std::make_pair("-XX:GcPauseGoalMs=10", nullptr));
+  }
+};
+
+TEST_F(PauseGoalHeapTest, UtilizationFollowsPauses) {
+  Heap* heap = Runtime::Current()->GetHeap();
+  ASSERT_TRUE(heap->IsAdaptiveErgonomicsEnabled());
+  MutexLock mu(Thread::Current(), heap->process_state_update_lock_);
+  const double configured = heap->GetTargetHeapUtilization();
+  Heap::AdaptiveErgonomicsSample sample = {};
+  sample.time_ns = heap->last_ergonomics_update_time_ns_;
+  sample.gc_time_ns = heap->last_ergonomics_gc_time_ns_;
+  sample.bytes_allocated_ever = heap->last_ergonomics_bytes_allocated_ever_;
+  sample.bytes_alive = 16 * MB;
+  sample.gc_duration_ns = MsToNs(20);
+
+  // Pauses over the goal grow the heap and start concurrent GCs earlier.
+  sample.max_pause_ns = MsToNs(20);
+  for (size_t i = 0; i < 32; ++i) {
+    sample.time_ns += MsToNs(1000);
+    heap->UpdateAdaptiveErgonomics(sample);
+  }
+  EXPECT_DOUBLE_EQ(0.25, heap->adaptive_target_utilization_);
+  EXPECT_GT(heap->adaptive_concurrent_start_factor_, 1.0);
+
+  // Once the pauses are within the goal, the configured utilization is restored.
+  sample.max_pause_ns = MsToNs(1);
+  for (size_t i = 0; i < 32; ++i) {
+    sample.time_ns += MsToNs(1000);
+    heap->UpdateAdaptiveErgonomics(sample);
+  }
+  EXPECT_DOUBLE_EQ(configured, heap->adaptive_target_utilization_);
+  EXPECT_DOUBLE_EQ(1.0, heap->adaptive_concurrent_start_factor_);
+
+  // A mutator waiting for a GC to allocate grows the heap again.
+  sample.time_ns += MsToNs(1000);
+  sample.gc_for_alloc = true;
+  heap->UpdateAdaptiveErgonomics(sample);
+  EXPECT_LT(heap->adaptive_target_utilization_, configured);
+}
+
+class TransparentHugePagesHeapTest : public HeapTest {
+ public:
+  void SetUpRuntimeOptions(RuntimeOptions* options) override {
+    HeapTest::SetUpRuntimeOptions(options);
+    options->push_back(std::make_pair("-XX:UseTransparentHugePages", nullptr));
+  }
+};
+
+TEST_F(TransparentHugePagesHeapTest, ClearedMemoryIsZeroed) {
+  Heap* heap = Runtime::Current()->GetHeap();
+  ASSERT_TRUE(heap->UseTransparentHugePages());
+  // Small enough to stay out of the large object space.
+  constexpr size_t kArrayLength = 2 * KB;
+  constexpr size_t kNumArrays = 4 * KB;
+  Thread* self = Thread::Current();
+  {
+    ScopedObjectAccess soa(self);
+    for (size_t i = 0; i < kNumArrays; ++i) {
+      ObjPtr<mirror::IntArray> array = mirror::IntArray::Alloc(self, kArrayLength);
+      ASSERT_TRUE(array != nullptr);
+      std::fill_n(array->GetData(), kArrayLength, -1);
+    }
+  }
+  // The garbage above spans several huge pages. Collecting it clears the regions and cards it
+  // used, and what is allocated there afterwards must read as zero.
+  heap->CollectGarbage(/* clear_soft_references= */ false);
+  heap->CollectGarbage(/* clear_soft_references= */ false);
+  ScopedObjectAccess soa(self);
+  for (size_t i = 0; i < kNumArrays; ++i) {
+    ObjPtr<mirror::IntArray> array = mirror::IntArray::Alloc(self, kArrayLength);
+    ASSERT_TRUE(array != nullptr);
+    const int32_t* data = array->GetData();
+    ASSERT_TRUE(std::all_of(data, data + kArrayLength, [](int32_t v) { return v == 0; })) << i;
+  }
+  accounting::CardTable* card_table = heap->GetCardTable();
+  space::RegionSpace* region_space = heap->GetRegionSpace();
+  if (region_space != nullptr) {
+    card_table->ClearCardRange(region_space->Begin(), region_space->Limit());
+    for (uint8_t* addr = region_space->Begin(); addr < region_space->Limit();
+         addr += accounting::CardTable::kCardSize) {
+      ASSERT_EQ(accounting::CardTable::kCardClean,
+                card_table->GetCard(reinterpret_cast<mirror::Object*>(addr)));
+    }
+  }
+}
+
+class ParallelCompactionHeapTest : public HeapTest {
+ public:
+  void SetUpRuntimeOptions(RuntimeOptions* options) override {
+    HeapTest::SetUpRuntimeOptions(options);
+    options->push_back(std::make_pair("-XX:ParallelGCThreads=4", nullptr));
+    // More concurrent GC threads than compaction workers, so that the heap thread pool may
+    // have more threads than there are compaction buffers.
+    options->push_back(std::make_pair("-XX:ConcGCThreads=8", nullptr));
+  }
+};
+
+TEST_F(ParallelCompactionHeapTest, CompactsWithSeveralWorkers) {
+  Heap* heap = Runtime::Current()->GetHeap();
+  if (heap->CurrentCollectorType() != kCollectorTypeCMC) {
+    GTEST_SKIP() << "Needs the concurrent mark-compact collector";
+  }
+  // Small enough to stay out of the large object space. Together the arrays span many
+  // chunks of pages claimed by the compaction workers.
+  constexpr size_t kArrayLength = 256;
+  constexpr size_t kNumArrays = 8 * KB;
+  Thread* self = Thread::Current();
+  ScopedObjectAccess soa(self);
+  StackHandleScope<1> hs(self);
+  Handle<mirror::ObjectArray<mirror::Object>> survivors(hs.NewHandle(
+      mirror::ObjectArray<mirror::Object>::Alloc(
+          self,
+          class_linker_->FindSystemClass(self, "[Ljava/lang/Object;"),
+          kNumArrays / 2)));
+  ASSERT_TRUE(survivors != nullptr);
+  // Interleave live and dead arrays so that every page has objects to slide.
+  for (size_t i = 0; i < kNumArrays; ++i) {
+    ObjPtr<mirror::IntArray> array = mirror::IntArray::Alloc(self, kArrayLength);
+    ASSERT_TRUE(array != nullptr);
+    std::fill_n(array->GetData(), kArrayLength, static_cast<int32_t>(i));
+    if (i % 2 == 0) {
+      survivors->Set<false>(i / 2, array);
+    }
+  }
+
+  {
+    ScopedThreadSuspension sts(self, ThreadState::kNative);
+    heap->CollectGarbage(/* clear_soft_references= */ false);
+    heap->CollectGarbage(/* clear_soft_references= */ false);
+  }
+  ThreadPool* pool = heap->GetThreadPool();
+  ASSERT_TRUE(pool != nullptr);
+  EXPECT_GT(pool->GetThreadCount(), 1u);
+
+  for (size_t i = 0; i < kNumArrays / 2; ++i) {
+    ObjPtr<mirror::IntArray> array = survivors->Get(i)->AsIntArray();
+    ASSERT_EQ(kArrayLength, static_cast<size_t>(array->GetLength()));
+    const int32_t* data = array->GetData();
+    const int32_t expected = static_cast<int32_t>(2 * i);
+    ASSERT_TRUE(std::all_of(data, data + kArrayLength, [=](int32_t v) { return v == expected; }))
+        << i;
+  }
+}
+
 class ZygoteHeapTest : public CommonRuntimeTest {
  public:
   ZygoteHeapTest() {
@@ -16,6 +16,8 @@
 
 #include "reference_processor.h"
 
+#include <algorithm>
+
 #include "art_field-inl.h"
 #include "base/mutex.h"
 #include "base/time_utils.h"
@@ -23,6 +25,7 @@
 #include "base/systrace.h"
 #include "class_root-inl.h"
 #include "collector/garbage_collector.h"
+#include "heap.h"
 #include "jni/java_vm_ext.h"
 #include "mirror/class-inl.h"
 #include "mirror/object-inl.h"
@@ -41,6 +44,10 @@ namespace gc {
 
 static constexpr bool kAsyncReferenceQueueAdd = false;
 
+// Reference queues shorter than this are cleared on the GC thread alone, since waking up the
+// workers would cost more than it saves.
+static constexpr size_t kMinParallelClearReferences = 1024;
+
 ReferenceProcessor::ReferenceProcessor()
     : collector_(nullptr),
       condition_("reference processor condition", *Locks::reference_processor_lock_) ,
@@ -230,8 +237,8 @@ void ReferenceProcessor::ProcessReferences(Thread* self, TimingLogger* timings)
   }
   // Clear all remaining soft and weak references with white referents.
   // This misses references only reachable through finalizers.
-  soft_reference_queue_.ClearWhiteReferences(&cleared_references_, collector_);
-  weak_reference_queue_.ClearWhiteReferences(&cleared_references_, collector_);
+  ClearWhiteReferences(&soft_reference_queue_);
+  ClearWhiteReferences(&weak_reference_queue_);
   // Defer PhantomReference processing until we've finished marking through finalizers.
   {
     // TODO: Capture mark state of some system weaks here. If the referent was marked here,
@@ -253,6 +260,8 @@ void ReferenceProcessor::ProcessReferences(Thread* self, TimingLogger* timings)
     // Preserve all white objects with finalize methods and schedule them for finalization.
     FinalizerStats finalizer_stats =
         finalizer_reference_queue_.EnqueueFinalizerReferences(&cleared_references_, collector_);
+    Runtime::Current()->GetMetrics()->FinalizerReferencesEnqueued()->Add(
+        finalizer_stats.num_enqueued_);
     if (ATraceEnabled()) {
       static constexpr size_t kBufSize = 80;
       char buf[kBufSize];
@@ -291,7 +300,7 @@ void ReferenceProcessor::ProcessReferences(Thread* self, TimingLogger* timings)
                                              /*report_cleared=*/ true);
 
   // Clear all phantom references with white referents. It's fine to do this just once here.
-  phantom_reference_queue_.ClearWhiteReferences(&cleared_references_, collector_);
+  ClearWhiteReferences(&phantom_reference_queue_);
 
   // At this point all reference queues other than the cleared references should be empty.
   DCHECK(soft_reference_queue_.IsEmpty());
@@ -312,6 +321,32 @@ void ReferenceProcessor::ProcessReferences(Thread* self, TimingLogger* timings)
   }
 }
 
+size_t ReferenceProcessor::GetThreadCount() const {
+  // Like the marking phase, leave the CPU to the foreground apps when we are in the background.
+  Heap* heap = Runtime::Current()->GetHeap();
+  ThreadPool* thread_pool = heap->GetThreadPool();
+  if (thread_pool == nullptr || !Runtime::Current()->InJankPerceptibleProcessState()) {
+    return 1;
+  }
+  size_t workers = concurrent_ ? heap->GetConcGCThreadCount() : heap->GetParallelGCThreadCount();
+  return std::min(workers, thread_pool->GetThreadCount()) + 1;
+}
+
+void ReferenceProcessor::ClearWhiteReferences(ReferenceQueue* queue) {
+  size_t thread_count = GetThreadCount();
+  // Clearing in transaction mode records every referent, which is not thread safe.
+  if (thread_count > 1 &&
+      !collector_->IsTransactionActive() &&
+      queue->HasAtLeast(kMinParallelClearReferences)) {
+    queue->ClearWhiteReferencesParallel(&cleared_references_,
+                                        collector_,
+                                        Runtime::Current()->GetHeap()->GetThreadPool(),
+                                        thread_count);
+  } else {
+    queue->ClearWhiteReferences(&cleared_references_, collector_);
+  }
+}
+
 // Process the "referent" field in a java.lang.ref.Reference.  If the referent has not yet been
 // marked, put it on the appropriate list in the heap for later processing.
 void ReferenceProcessor::DelayReferenceReferent(ObjPtr<mirror::Class> klass,
@@ -362,6 +397,9 @@ class ClearedReferenceTask : public HeapTask {
       : HeapTask(NanoTime()), cleared_references_(cleared_references) {
   }
   void Run(Thread* thread) override {
+    // How long the cleared references waited before the reference queue daemons could see them.
+    Runtime::Current()->GetMetrics()->ReferenceQueueHandoffDelayUsAvg()->Add(
+        NsToUs(NanoTime() - GetTargetRunTime()));
     ScopedObjectAccess soa(thread);
     WellKnownClasses::java_lang_ref_ReferenceQueue_add->InvokeStatic<'V', 'L'>(
         thread, soa.Decode<mirror::Object>(cleared_references_));
@@ -93,6 +93,12 @@ class ReferenceProcessor {
 
  private:
   bool SlowPathEnabled() REQUIRES_SHARED(Locks::mutator_lock_);
+  // Clear the white referents of queue into cleared_references_. Long queues are processed on the
+  // heap thread pool when there is one.
+  void ClearWhiteReferences(ReferenceQueue* queue)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+  // Number of threads, including the GC thread, to clear references with.
+  size_t GetThreadCount() const;
   // Called by ProcessReferences.
   void DisableSlowPath(Thread* self) REQUIRES(Locks::reference_processor_lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
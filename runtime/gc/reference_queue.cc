@@ -131,6 +131,38 @@ size_t ReferenceQueue::GetLength() const {
   return count;
 }
 
+bool ReferenceQueue::HasAtLeast(size_t n) const {
+  size_t count = 0;
+  ObjPtr<mirror::Reference> cur = list_;
+  if (cur != nullptr) {
+    do {
+      if (++count >= n) {
+        return true;
+      }
+      cur = cur->GetPendingNext<kWithoutReadBarrier>();
+    } while (cur != list_);
+  }
+  return count >= n;
+}
+
+void ReferenceQueue::Splice(ReferenceQueue* other) {
+  if (other->IsEmpty()) {
+    return;
+  }
+  if (IsEmpty()) {
+    list_ = other->list_;
+  } else {
+    // Both lists are cyclic: swapping the successors of the two heads joins them into one cycle.
+    ObjPtr<mirror::Reference> head = list_->GetPendingNext<kWithoutReadBarrier>();
+    ObjPtr<mirror::Reference> other_head = other->list_->GetPendingNext<kWithoutReadBarrier>();
+    DCHECK(head != nullptr);
+    DCHECK(other_head != nullptr);
+    list_->SetPendingNext(other_head);
+    other->list_->SetPendingNext(head);
+  }
+  other->Clear();
+}
+
 void ReferenceQueue::ClearWhiteReferences(ReferenceQueue* cleared_references,
                                           collector::GarbageCollector* collector,
                                           bool report_cleared) {
@@ -163,6 +195,60 @@ void ReferenceQueue::ClearWhiteReferences(ReferenceQueue* cleared_references,
   }
 }
 
+void ReferenceQueue::ClearWhiteReferencesParallel(ReferenceQueue* cleared_references,
+                                                  collector::GarbageCollector* collector,
+                                                  ThreadPool* thread_pool,
+                                                  size_t thread_count) {
+  DCHECK(!Runtime::Current()->IsActiveTransaction());
+  DCHECK_GT(thread_count, 1u);
+  Thread* self = Thread::Current();
+  // EnqueueReference is not thread safe, so every task gets its own cleared queue. The lock is
+  // never taken on these.
+  std::vector<std::unique_ptr<ReferenceQueue>> local_queues;
+  local_queues.reserve(thread_count);
+  for (size_t i = 0; i < thread_count; ++i) {
+    local_queues.emplace_back(new ReferenceQueue(lock_));
+    ReferenceQueue* local = local_queues.back().get();
+    thread_pool->AddTask(self, new FunctionTask([this, local, collector](Thread* thread)
+        NO_THREAD_SAFETY_ANALYSIS {
+      static constexpr size_t kBatchSize = 32;
+      ObjPtr<mirror::Reference> buf[kBatchSize];
+      size_t n_entries;
+      bool empty;
+      do {
+        {
+          // Acquire lock only a few times and hold it as briefly as possible.
+          MutexLock mu(thread, *lock_);
+          empty = IsEmpty();
+          for (n_entries = 0; n_entries < kBatchSize && !empty; ++n_entries) {
+            buf[n_entries] = DequeuePendingReference();
+            empty = IsEmpty();
+          }
+        }
+        for (size_t j = 0; j < n_entries; ++j) {
+          mirror::HeapReference<mirror::Object>* referent_addr =
+              buf[j]->GetReferentReferenceAddr();
+          // do_atomic_update is false because this happens during the reference processing
+          // phase where Reference.clear() would block.
+          if (!collector->IsNullOrMarkedHeapReference(referent_addr,
+                                                      /*do_atomic_update=*/false)) {
+            buf[j]->ClearReferent<false>();
+            local->EnqueueReference(buf[j]);
+          }
+          DisableReadBarrierForReference(buf[j], std::memory_order_release);
+        }
+      } while (!empty);
+    }));
+  }
+  thread_pool->SetMaxActiveWorkers(thread_count - 1);
+  thread_pool->StartWorkers(self);
+  thread_pool->Wait(self, /*do_work=*/ true, /*may_hold_locks=*/ true);
+  thread_pool->StopWorkers(self);
+  for (const std::unique_ptr<ReferenceQueue>& local : local_queues) {
+    cleared_references->Splice(local.get());
+  }
+}
+
 FinalizerStats ReferenceQueue::EnqueueFinalizerReferences(ReferenceQueue* cleared_references,
                                                 collector::GarbageCollector* collector) {
   uint32_t num_refs(0), num_enqueued(0);
@@ -18,6 +18,7 @@
 #define ART_RUNTIME_GC_REFERENCE_QUEUE_H_
 
 #include <iosfwd>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -108,8 +109,24 @@ class ReferenceQueue {
                             bool report_cleared = false)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Parallel variant of ClearWhiteReferences. References are handed out in small batches under
+  // lock_ to the calling thread and to thread_count - 1 workers of thread_pool. Each of them clears
+  // into a private queue, and the private queues are spliced onto cleared_references once all
+  // workers are done. Must not be used in transaction mode.
+  void ClearWhiteReferencesParallel(ReferenceQueue* cleared_references,
+                                    collector::GarbageCollector* collector,
+                                    ThreadPool* thread_pool,
+                                    size_t thread_count)
+      REQUIRES(!*lock_)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
+  // Move all the references of other to this queue in constant time, leaving other empty.
+  void Splice(ReferenceQueue* other) REQUIRES_SHARED(Locks::mutator_lock_);
+
   void Dump(std::ostream& os) const REQUIRES_SHARED(Locks::mutator_lock_);
   size_t GetLength() const REQUIRES_SHARED(Locks::mutator_lock_);
+  // Returns true if the queue holds at least n references. Walks at most n entries.
+  bool HasAtLeast(size_t n) const REQUIRES_SHARED(Locks::mutator_lock_);
 
   bool IsEmpty() const {
     return list_ == nullptr;
@@ -16,12 +16,18 @@
 
 #include <sstream>
 
+#include "class_root-inl.h"
 #include "common_runtime_test.h"
+#include "gc/collector/garbage_collector.h"
 #include "handle_scope-inl.h"
 #include "mirror/class-alloc-inl.h"
 #include "mirror/class-inl.h"
+#include "mirror/object_array-alloc-inl.h"
+#include "mirror/object_array-inl.h"
+#include "mirror/reference-inl.h"
 #include "reference_queue.h"
 #include "scoped_thread_state_change-inl.h"
+#include "thread_pool.h"
 
 namespace art {
 namespace gc {
@@ -67,6 +73,157 @@ TEST_F(ReferenceQueueTest, EnqueueDequeue) {
   ASSERT_EQ(refs, dequeued);
 }
 
+TEST_F(ReferenceQueueTest, Splice) {
+  Thread* self = Thread::Current();
+  ScopedObjectAccess soa(self);
+  StackHandleScope<20> hs(self);
+  Mutex lock("Reference queue lock");
+  ReferenceQueue queue(&lock);
+  ReferenceQueue other(&lock);
+  auto ref_class = hs.NewHandle(
+      Runtime::Current()->GetClassLinker()->FindClass(self, "Ljava/lang/ref/WeakReference;",
+                                                      ScopedNullHandle<mirror::ClassLoader>()));
+  ASSERT_TRUE(ref_class != nullptr);
+  auto ref1(hs.NewHandle(ref_class->AllocObject(self)->AsReference()));
+  auto ref2(hs.NewHandle(ref_class->AllocObject(self)->AsReference()));
+  auto ref3(hs.NewHandle(ref_class->AllocObject(self)->AsReference()));
+  ASSERT_TRUE(ref1 != nullptr);
+  ASSERT_TRUE(ref2 != nullptr);
+  ASSERT_TRUE(ref3 != nullptr);
+
+  // Splicing into an empty queue takes over the other list.
+  other.EnqueueReference(ref1.Get());
+  queue.Splice(&other);
+  ASSERT_TRUE(other.IsEmpty());
+  ASSERT_EQ(queue.GetLength(), 1U);
+
+  // Splicing two non-empty queues keeps a single cycle.
+  other.EnqueueReference(ref2.Get());
+  other.EnqueueReference(ref3.Get());
+  queue.Splice(&other);
+  ASSERT_TRUE(other.IsEmpty());
+  ASSERT_EQ(queue.GetLength(), 3U);
+  ASSERT_TRUE(queue.HasAtLeast(3U));
+  ASSERT_FALSE(queue.HasAtLeast(4U));
+
+  // Splicing an empty queue is a no-op.
+  queue.Splice(&other);
+  ASSERT_EQ(queue.GetLength(), 3U);
+
+  std::set<mirror::Reference*> refs = {ref1.Get(), ref2.Get(), ref3.Get()};
+  std::set<mirror::Reference*> dequeued;
+  while (!queue.IsEmpty()) {
+    dequeued.insert(queue.DequeuePendingReference().Ptr());
+  }
+  ASSERT_EQ(refs, dequeued);
+}
+
+// A collector for which exactly the objects of a given set are marked.
+class FakeCollector : public collector::GarbageCollector {
+ public:
+  FakeCollector(Heap* heap, const std::set<mirror::Object*>& marked)
+      : GarbageCollector(heap, "fake collector"), marked_(marked) {}
+
+  collector::GcType GetGcType() const override { return collector::kGcTypeFull; }
+  CollectorType GetCollectorType() const override { return kCollectorTypeNone; }
+
+  mirror::Object* IsMarked(mirror::Object* obj) override {
+    return marked_.find(obj) != marked_.end() ? obj : nullptr;
+  }
+  bool IsNullOrMarkedHeapReference(mirror::HeapReference<mirror::Object>* obj,
+                                   [[maybe_unused]] bool do_atomic_update) override
+      REQUIRES_SHARED(Locks::mutator_lock_) {
+    mirror::Object* ref = obj->AsMirrorPtr();
+    return ref == nullptr || IsMarked(ref) != nullptr;
+  }
+  void ProcessMarkStack() override {}
+  mirror::Object* MarkObject(mirror::Object* obj) override { return obj; }
+  void MarkHeapReference([[maybe_unused]] mirror::HeapReference<mirror::Object>* obj,
+                         [[maybe_unused]] bool do_atomic_update) override {}
+  void DelayReferenceReferent([[maybe_unused]] ObjPtr<mirror::Class> klass,
+                              [[maybe_unused]] ObjPtr<mirror::Reference> reference) override {}
+  void VisitRoots([[maybe_unused]] mirror::Object*** roots,
+                  [[maybe_unused]] size_t count,
+                  [[maybe_unused]] const RootInfo& info) override {}
+  void VisitRoots([[maybe_unused]] mirror::CompressedReference<mirror::Object>** roots,
+                  [[maybe_unused]] size_t count,
+                  [[maybe_unused]] const RootInfo& info) override {}
+
+ protected:
+  void RunPhases() override {}
+  void RevokeAllThreadLocalBuffers() override {}
+
+ private:
+  const std::set<mirror::Object*>& marked_;
+};
+
+TEST_F(ReferenceQueueTest, ClearWhiteReferencesParallel) {
+  // Enough references for the reference processor to clear them in parallel.
+  constexpr size_t kNumReferences = 2048;
+  Thread* self = Thread::Current();
+  ScopedObjectAccess soa(self);
+  StackHandleScope<3> hs(self);
+  auto ref_class = hs.NewHandle(
+      Runtime::Current()->GetClassLinker()->FindClass(self, "Ljava/lang/ref/WeakReference;",
+                                                      ScopedNullHandle<mirror::ClassLoader>()));
+  ASSERT_TRUE(ref_class != nullptr);
+  ObjPtr<mirror::Class> array_class = GetClassRoot<mirror::ObjectArray<mirror::Object>>();
+  auto refs = hs.NewHandle(
+      mirror::ObjectArray<mirror::Object>::Alloc(self, array_class, kNumReferences));
+  auto referents = hs.NewHandle(
+      mirror::ObjectArray<mirror::Object>::Alloc(self, array_class, kNumReferences));
+  ASSERT_TRUE(refs != nullptr);
+  ASSERT_TRUE(referents != nullptr);
+  for (size_t i = 0; i < kNumReferences; ++i) {
+    ObjPtr<mirror::Object> ref = ref_class->AllocObject(self);
+    ASSERT_TRUE(ref != nullptr);
+    refs->Set<false>(i, ref);
+    // Every fourth reference has no referent.
+    if (i % 4 != 3) {
+      ObjPtr<mirror::Object> referent = ref_class->AllocObject(self);
+      ASSERT_TRUE(referent != nullptr);
+      referents->Set<false>(i, referent);
+    }
+  }
+  // Every other referent is marked.
+  std::set<mirror::Object*> marked;
+  Mutex lock("Reference queue lock");
+  ReferenceQueue queue(&lock);
+  for (size_t i = 0; i < kNumReferences; ++i) {
+    ObjPtr<mirror::Reference> ref = refs->Get(i)->AsReference();
+    ref->SetReferent<false>(referents->Get(i));
+    if (i % 2 == 0) {
+      marked.insert(referents->Get(i).Ptr());
+    }
+    queue.EnqueueReference(ref);
+  }
+  ASSERT_TRUE(queue.HasAtLeast(kNumReferences));
+
+  FakeCollector collector(Runtime::Current()->GetHeap(), marked);
+  ThreadPool thread_pool("Reference queue test thread pool", 3);
+  ReferenceQueue cleared(&lock);
+  queue.ClearWhiteReferencesParallel(&cleared, &collector, &thread_pool, /*thread_count=*/ 4);
+  ASSERT_TRUE(queue.IsEmpty());
+
+  // Exactly the references with an unmarked referent are cleared, each of them once.
+  std::set<mirror::Reference*> expected_cleared;
+  for (size_t i = 0; i < kNumReferences; ++i) {
+    ObjPtr<mirror::Reference> ref = refs->Get(i)->AsReference();
+    if (i % 4 == 1) {  // Unmarked and not null.
+      expected_cleared.insert(ref.Ptr());
+      EXPECT_TRUE(ref->GetReferent() == nullptr) << i;
+    } else {
+      EXPECT_EQ(referents->Get(i), ref->GetReferent()) << i;
+    }
+  }
+  ASSERT_EQ(expected_cleared.size(), cleared.GetLength());
+  std::set<mirror::Reference*> dequeued;
+  while (!cleared.IsEmpty()) {
+    dequeued.insert(cleared.DequeuePendingReference().Ptr());
+  }
+  ASSERT_EQ(expected_cleared, dequeued);
+}
+
 TEST_F(ReferenceQueueTest, Dump) {
   Thread* self = Thread::Current();
   ScopedObjectAccess soa(self);
@@ -42,7 +42,10 @@ namespace space {
 
 class MemoryToolLargeObjectMapSpace final : public LargeObjectMapSpace {
  public:
-  explicit MemoryToolLargeObjectMapSpace(const std::string& name) : LargeObjectMapSpace(name) {
+  // Reused maps would keep the access state of the previous object's red zones, so don't cache
+  // freed maps.
+  explicit MemoryToolLargeObjectMapSpace(const std::string& name)
+      : LargeObjectMapSpace(name, /*max_free_extent_bytes=*/ 0u) {
   }
 
   ~MemoryToolLargeObjectMapSpace() override {
@@ -83,6 +86,11 @@ class MemoryToolLargeObjectMapSpace final : public LargeObjectMapSpace {
     return LargeObjectMapSpace::Free(self, object_with_rdz);
   }
 
+  size_t FreeList(Thread* self, size_t num_ptrs, mirror::Object** ptrs) override {
+    // Go through Free() for each object to strip the red zones.
+    return LargeObjectSpace::FreeList(self, num_ptrs, ptrs);
+  }
+
   bool Contains(const mirror::Object* obj) const override {
     return LargeObjectMapSpace::Contains(ObjectWithRedzone(obj));
   }
@@ -124,27 +132,72 @@ void LargeObjectSpace::CopyLiveToMarked() {
   mark_bitmap_.CopyFrom(&live_bitmap_);
 }
 
-LargeObjectMapSpace::LargeObjectMapSpace(const std::string& name)
-    : LargeObjectSpace(name, nullptr, nullptr, "large object map space lock") {}
+LargeObjectMapSpace::LargeObjectMapSpace(const std::string& name, size_t max_free_extent_bytes)
+    : LargeObjectSpace(name, nullptr, nullptr, "large object map space lock"),
+      free_extent_bytes_(0u),
+      max_free_extent_bytes_(max_free_extent_bytes) {}
 
 LargeObjectMapSpace* LargeObjectMapSpace::Create(const std::string& name) {
   if (Runtime::Current()->IsRunningOnMemoryTool()) {
     return new MemoryToolLargeObjectMapSpace(name);
   } else {
-    return new LargeObjectMapSpace(name);
+    return new LargeObjectMapSpace(name, kMaxFreeExtentBytes);
+  }
+}
+
+MemMap LargeObjectMapSpace::TakeFreeExtent(size_t num_bytes) {
+  // Accept some slack, but don't let small requests pin down much bigger extents. The alignment
+  // term covers the unaligned tail that MapAnonymousAligned leaves on every map.
+  const size_t needed = RoundUp(num_bytes, gPageSize);
+  const size_t max_size = needed + std::max(needed / 8, kLargeObjectAlignment);
+  auto it = free_extents_.lower_bound(needed);
+  if (it == free_extents_.end() || it->first > max_size) {
+    return MemMap::Invalid();
+  }
+  MemMap mem_map = std::move(it->second);
+  free_extents_.erase(it);
+  DCHECK_GE(free_extent_bytes_, mem_map.BaseSize());
+  free_extent_bytes_ -= mem_map.BaseSize();
+  return mem_map;
+}
+
+void LargeObjectMapSpace::CacheFreeExtent(MemMap* mem_map) {
+  const size_t size = mem_map->BaseSize();
+  if (size <= kMaxFreeExtentSize && free_extent_bytes_ + size <= max_free_extent_bytes_) {
+    // The cached extents are not accounted in the heap, so let the kernel take their pages
+    // back under memory pressure. This must be done before the extent can be reused, which is
+    // why it is done with lock_ held. Reuse zeroes the extent anyway.
+    mem_map->MadviseFree();
+    free_extent_bytes_ += size;
+    free_extents_.emplace(size, std::move(*mem_map));
   }
 }
 
 mirror::Object* LargeObjectMapSpace::Alloc(Thread* self, size_t num_bytes,
                                            size_t* bytes_allocated, size_t* usable_size,
                                            size_t* bytes_tl_bulk_allocated) {
-  std::string error_msg;
-  MemMap mem_map = MemMap::MapAnonymousAligned<kLargeObjectAlignment>(
-      "large object space allocation", num_bytes, PROT_READ | PROT_WRITE,
-      /*low_4gb=*/ true, &error_msg);
-  if (UNLIKELY(!mem_map.IsValid())) {
-    LOG(WARNING) << "Large object allocation failed: " << error_msg;
-    return nullptr;
+  MemMap mem_map;
+  if (num_bytes <= kMaxFreeExtentSize) {
+    MutexLock mu(self, lock_);
+    mem_map = TakeFreeExtent(num_bytes);
+  }
+  if (mem_map.IsValid()) {
+    // The extent still holds the contents of the object it was freed from. Zero it outside of
+    // lock_. For big extents, dropping the pages is cheaper than writing them.
+    if (mem_map.BaseSize() <= kFreeExtentMemsetThreshold) {
+      memset(mem_map.BaseBegin(), 0, mem_map.BaseSize());
+    } else {
+      mem_map.MadviseDontNeedAndZero();
+    }
+  } else {
+    std::string error_msg;
+    mem_map = MemMap::MapAnonymousAligned<kLargeObjectAlignment>(
+        "large object space allocation", num_bytes, PROT_READ | PROT_WRITE,
+        /*low_4gb=*/ true, &error_msg);
+    if (UNLIKELY(!mem_map.IsValid())) {
+      LOG(WARNING) << "Large object allocation failed: " << error_msg;
+      return nullptr;
+    }
   }
   mirror::Object* const obj = reinterpret_cast<mirror::Object*>(mem_map.Begin());
   const size_t allocation_size = mem_map.BaseSize();
@@ -188,23 +241,60 @@ void LargeObjectMapSpace::SetAllLargeObjectsAsZygoteObjects(Thread* self, bool s
   }
 }
 
-size_t LargeObjectMapSpace::Free(Thread* self, mirror::Object* ptr) {
-  MutexLock mu(self, lock_);
+size_t LargeObjectMapSpace::FreeLocked(Thread* self,
+                                       mirror::Object* ptr,
+                                       std::vector<MemMap>* maps_to_unmap) {
   auto it = large_objects_.find(ptr);
   if (UNLIKELY(it == large_objects_.end())) {
     ScopedObjectAccess soa(self);
     Runtime::Current()->GetHeap()->DumpSpaces(LOG_STREAM(FATAL_WITHOUT_ABORT));
     LOG(FATAL) << "Attempted to free large object " << ptr << " which was not live";
   }
-  const size_t map_size = it->second.mem_map.BaseSize();
-  DCHECK_GE(num_bytes_allocated_, map_size);
-  size_t allocation_size = map_size;
+  MemMap mem_map = std::move(it->second.mem_map);
+  const size_t allocation_size = mem_map.BaseSize();
+  DCHECK_GE(num_bytes_allocated_, allocation_size);
   num_bytes_allocated_ -= allocation_size;
   --num_objects_allocated_;
   large_objects_.erase(it);
+  CacheFreeExtent(&mem_map);
+  if (mem_map.IsValid()) {
+    maps_to_unmap->push_back(std::move(mem_map));
+  }
   return allocation_size;
 }
 
+size_t LargeObjectMapSpace::Free(Thread* self, mirror::Object* ptr) {
+  // Declared before `mu` so that a map which is not cached is unmapped after lock_ is released.
+  std::vector<MemMap> maps_to_unmap;
+  MutexLock mu(self, lock_);
+  return FreeLocked(self, ptr, &maps_to_unmap);
+}
+
+size_t LargeObjectMapSpace::FreeList(Thread* self, size_t num_ptrs, mirror::Object** ptrs) {
+  std::vector<MemMap> maps_to_unmap;
+  size_t total = 0;
+  {
+    MutexLock mu(self, lock_);
+    for (size_t i = 0; i < num_ptrs; ++i) {
+      total += FreeLocked(self, ptrs[i], &maps_to_unmap);
+    }
+  }
+  // `maps_to_unmap` goes out of scope here, so the munmap calls happen without lock_ held.
+  return total;
+}
+
+size_t LargeObjectMapSpace::Trim() {
+  decltype(free_extents_) free_extents;
+  size_t released;
+  {
+    MutexLock mu(Thread::Current(), lock_);
+    free_extents.swap(free_extents_);
+    released = free_extent_bytes_;
+    free_extent_bytes_ = 0u;
+  }
+  return released;
+}
+
 size_t LargeObjectMapSpace::AllocationSize(mirror::Object* obj, size_t* usable_size) {
   MutexLock mu(Thread::Current(), lock_);
   auto it = large_objects_.find(obj);
@@ -24,6 +24,7 @@
 #include "space.h"
 #include "thread-current-inl.h"
 
+#include <map>
 #include <set>
 #include <vector>
 
@@ -117,6 +118,11 @@ class LargeObjectSpace : public DiscontinuousSpace, public AllocSpace {
   virtual std::pair<uint8_t*, uint8_t*> GetBeginEndAtomic() const = 0;
   // Clamp the space size to the given capacity.
   virtual void ClampGrowthLimit(size_t capacity) = 0;
+  // Give memory held for future allocations back to the system. Returns the number of bytes
+  // released.
+  virtual size_t Trim() {
+    return 0U;
+  }
 
  protected:
   explicit LargeObjectSpace(const std::string& name, uint8_t* begin, uint8_t* end,
@@ -161,6 +167,14 @@ class LargeObjectMapSpace : public LargeObjectSpace {
                         size_t* usable_size, size_t* bytes_tl_bulk_allocated) override
       REQUIRES(!lock_);
   size_t Free(Thread* self, mirror::Object* ptr) override REQUIRES(!lock_);
+  // Frees all the objects under a single acquisition of lock_. Maps that don't fit in the free
+  // extent cache are unmapped after the lock is released.
+  size_t FreeList(Thread* self, size_t num_ptrs, mirror::Object** ptrs) override REQUIRES(!lock_);
+  size_t Trim() override REQUIRES(!lock_);
+  size_t GetFreeExtentBytes() const REQUIRES(!lock_) {
+    MutexLock mu(Thread::Current(), lock_);
+    return free_extent_bytes_;
+  }
   void Walk(DlMallocSpace::WalkCallback, void* arg) override REQUIRES(!lock_);
   // TODO: disabling thread safety analysis as this may be called when we already hold lock_.
   bool Contains(const mirror::Object* obj) const override NO_THREAD_SAFETY_ANALYSIS;
@@ -173,9 +187,28 @@ class LargeObjectMapSpace : public LargeObjectSpace {
     MemMap mem_map;
     bool is_zygote;
   };
-  explicit LargeObjectMapSpace(const std::string& name);
+  // Freed maps of up to kMaxFreeExtentSize bytes are kept in a cache ordered by size, and reused
+  // for later allocations that fit them closely, saving the munmap / mmap pair. Workloads that
+  // churn through buffers of a few sizes hit the cache almost always.
+  static constexpr size_t kMaxFreeExtentSize = 1 * MB;
+  static constexpr size_t kMaxFreeExtentBytes = 16 * MB;
+  // Reused extents up to this size are zeroed with memset, larger ones with madvise.
+  static constexpr size_t kFreeExtentMemsetThreshold = 64 * KB;
+
+  LargeObjectMapSpace(const std::string& name, size_t max_free_extent_bytes);
   virtual ~LargeObjectMapSpace() {}
 
+  // Take a cached map of at least num_bytes, and not much more, out of the cache. Returns an
+  // invalid map if there is none. The contents of the map are not zeroed yet.
+  MemMap TakeFreeExtent(size_t num_bytes) REQUIRES(lock_);
+  // Move the map of a freed object to the cache if it is small enough and the cache has room.
+  // Otherwise the map is left with the caller, who should unmap it outside of lock_.
+  void CacheFreeExtent(MemMap* mem_map) REQUIRES(lock_);
+  // Unregister ptr and cache its map. A map that can't be cached is added to maps_to_unmap, to be
+  // unmapped once lock_ is released. Returns the freed size.
+  size_t FreeLocked(Thread* self, mirror::Object* ptr, std::vector<MemMap>* maps_to_unmap)
+      REQUIRES(lock_);
+
   bool IsZygoteLargeObject(Thread* self, mirror::Object* obj) const override REQUIRES(!lock_);
   void SetAllLargeObjectsAsZygoteObjects(Thread* self, bool set_mark_bit) override
       REQUIRES(!lock_)
@@ -183,6 +216,14 @@ class LargeObjectMapSpace : public LargeObjectSpace {
 
   AllocationTrackingSafeMap<mirror::Object*, LargeObject, kAllocatorTagLOSMaps> large_objects_
       GUARDED_BY(lock_);
+
+  std::multimap<size_t,
+                MemMap,
+                std::less<size_t>,
+                TrackingAllocator<std::pair<const size_t, MemMap>, kAllocatorTagLOSMaps>>
+      free_extents_ GUARDED_BY(lock_);
+  size_t free_extent_bytes_ GUARDED_BY(lock_);
+  const size_t max_free_extent_bytes_;
 };
 
 // A continuous large object space with a free-list to handle holes.
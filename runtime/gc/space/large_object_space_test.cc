@@ -174,6 +174,50 @@ void LargeObjectSpaceTest::RaceTest() {
   }
 }
 
+TEST_F(LargeObjectSpaceTest, FreeExtentReuse) {
+  // Freed maps are not cached under a memory tool.
+  TEST_DISABLED_FOR_MEMORY_TOOL();
+  Thread* const self = Thread::Current();
+  LargeObjectMapSpace* los = space::LargeObjectMapSpace::Create("large object space");
+  // The destructor of LargeObjectMapSpace is protected.
+  std::unique_ptr<LargeObjectSpace> los_holder(los);
+  size_t alloc_size, bytes_tl_bulk_allocated;
+  mirror::Object* obj = los->Alloc(self, 64 * KB, &alloc_size, nullptr, &bytes_tl_bulk_allocated);
+  ASSERT_TRUE(obj != nullptr);
+  memset(obj, 0xff, 64 * KB);
+  EXPECT_EQ(los->Free(self, obj), alloc_size);
+  EXPECT_EQ(los->GetFreeExtentBytes(), alloc_size);
+
+  // An allocation of the same size gets the cached map back, zeroed.
+  size_t reuse_size;
+  mirror::Object* reused = los->Alloc(self, 64 * KB, &reuse_size, nullptr,
+                                      &bytes_tl_bulk_allocated);
+  ASSERT_TRUE(reused != nullptr);
+  EXPECT_EQ(reused, obj);
+  EXPECT_EQ(reuse_size, alloc_size);
+  EXPECT_EQ(los->GetFreeExtentBytes(), 0u);
+  for (size_t i = 0; i < 64 * KB; ++i) {
+    ASSERT_EQ(reinterpret_cast<const uint8_t*>(reused)[i], 0u);
+  }
+
+  // A much smaller request does not take the extent.
+  EXPECT_EQ(los->FreeList(self, 1, &reused), alloc_size);
+  mirror::Object* small = los->Alloc(self, 16 * KB, &reuse_size, nullptr,
+                                     &bytes_tl_bulk_allocated);
+  ASSERT_TRUE(small != nullptr);
+  EXPECT_NE(small, obj);
+  EXPECT_EQ(los->GetFreeExtentBytes(), alloc_size);
+
+  // Maps over the size limit are unmapped right away, and trimming drops the cache.
+  mirror::Object* big = los->Alloc(self, 4 * MB, &reuse_size, nullptr, &bytes_tl_bulk_allocated);
+  ASSERT_TRUE(big != nullptr);
+  los->Free(self, big);
+  EXPECT_EQ(los->GetFreeExtentBytes(), alloc_size);
+  EXPECT_EQ(los->Trim(), alloc_size);
+  EXPECT_EQ(los->GetFreeExtentBytes(), 0u);
+  los->Free(self, small);
+}
+
 TEST_F(LargeObjectSpaceTest, LargeObjectTest) {
   LargeObjectTest();
 }
@@ -13,10 +13,21 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include <dirent.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#if defined(__linux__)
+#include <linux/mempolicy.h>
+#endif
+
+#include <algorithm>
 #include <deque>
+#include <vector>
 
 #include "bump_pointer_space-inl.h"
 #include "bump_pointer_space.h"
+#include "base/bit_utils.h"
 #include "base/dumpable.h"
 #include "base/logging.h"
 #include "gc/accounting/read_barrier_table.h"
@@ -49,16 +60,21 @@ static constexpr bool kCheckLiveBytesAgainstRegionBitmap = kIsDebugBuild;
 
 MemMap RegionSpace::CreateMemMap(const std::string& name,
                                  size_t capacity,
-                                 uint8_t* requested_begin) {
+                                 uint8_t* requested_begin,
+                                 bool use_huge_pages) {
   CHECK_ALIGNED(capacity, kRegionSize);
   std::string error_msg;
-  // Ask for the capacity of an additional kRegionSize so that we can align the map by kRegionSize
-  // even if we get unaligned base address. This is necessary for the ReadBarrierTable to work.
+  // With transparent huge pages the map has to start on a PMD boundary, otherwise the kernel
+  // cannot back the first and last partial huge page of every run of regions with a huge page.
+  const size_t alignment = use_huge_pages ? std::max(kRegionSize, gPMDSize) : kRegionSize;
+  const size_t aligned_capacity = RoundUp(capacity, alignment);
+  // Ask for the capacity of an additional `alignment` so that we can align the map by it even if
+  // we get unaligned base address. This is necessary for the ReadBarrierTable to work.
   MemMap mem_map;
   while (true) {
     mem_map = MemMap::MapAnonymous(name.c_str(),
                                    requested_begin,
-                                   capacity + kRegionSize,
+                                   aligned_capacity + alignment,
                                    PROT_READ | PROT_WRITE,
                                    /*low_4gb=*/ true,
                                    /*reuse=*/ false,
@@ -77,29 +93,62 @@ MemMap RegionSpace::CreateMemMap(const std::string& name,
     MemMap::DumpMaps(LOG_STREAM(ERROR));
     return MemMap::Invalid();
   }
-  CHECK_EQ(mem_map.Size(), capacity + kRegionSize);
+  CHECK_EQ(mem_map.Size(), aligned_capacity + alignment);
   CHECK_EQ(mem_map.Begin(), mem_map.BaseBegin());
   CHECK_EQ(mem_map.Size(), mem_map.BaseSize());
-  if (IsAlignedParam(mem_map.Begin(), kRegionSize)) {
-    // Got an aligned map. Since we requested a map that's kRegionSize larger. Shrink by
-    // kRegionSize at the end.
-    mem_map.SetSize(capacity);
-  } else {
+  if (!IsAlignedParam(mem_map.Begin(), alignment)) {
     // Got an unaligned map. Align the both ends.
-    mem_map.AlignBy(kRegionSize);
+    mem_map.AlignBy(alignment);
   }
-  CHECK_ALIGNED(mem_map.Begin(), kRegionSize);
+  // Shrink by whatever is left over at the end.
+  mem_map.SetSize(capacity);
+  CHECK_ALIGNED_PARAM(mem_map.Begin(), alignment);
   CHECK_ALIGNED(mem_map.End(), kRegionSize);
   CHECK_EQ(mem_map.Size(), capacity);
+  if (use_huge_pages && mem_map.MadviseHugePages() != 0) {
+    PLOG(WARNING) << "Failed to madvise(MADV_HUGEPAGE) " << name;
+  }
   return mem_map;
 }
 
-RegionSpace* RegionSpace::Create(
-    const std::string& name, MemMap&& mem_map, bool use_generational_cc) {
-  return new RegionSpace(name, std::move(mem_map), use_generational_cc);
+RegionSpace* RegionSpace::Create(const std::string& name,
+                                 MemMap&& mem_map,
+                                 bool use_generational_cc,
+                                 bool use_huge_pages,
+                                 const std::vector<uint32_t>& numa_nodes,
+                                 bool fake_numa_topology) {
+  return new RegionSpace(name,
+                         std::move(mem_map),
+                         use_generational_cc,
+                         use_huge_pages,
+                         numa_nodes,
+                         fake_numa_topology);
+}
+
+std::vector<uint32_t> RegionSpace::GetConfiguredNumaNodes() {
+  std::vector<uint32_t> nodes;
+  DIR* dir = opendir("/sys/devices/system/node");
+  if (dir != nullptr) {
+    while (dirent* entry = readdir(dir)) {
+      unsigned int node;
+      int length;
+      if (sscanf(entry->d_name, "node%u%n", &node, &length) == 1 &&
+          entry->d_name[length] == '\0') {
+        nodes.push_back(node);
+      }
+    }
+    closedir(dir);
+  }
+  std::sort(nodes.begin(), nodes.end());
+  return nodes;
 }
 
-RegionSpace::RegionSpace(const std::string& name, MemMap&& mem_map, bool use_generational_cc)
+RegionSpace::RegionSpace(const std::string& name,
+                         MemMap&& mem_map,
+                         bool use_generational_cc,
+                         bool use_huge_pages,
+                         const std::vector<uint32_t>& numa_nodes,
+                         bool fake_numa_topology)
     : ContinuousMemMapAllocSpace(name,
                                  std::move(mem_map),
                                  mem_map.Begin(),
@@ -108,6 +157,10 @@ RegionSpace::RegionSpace(const std::string& name, MemMap&& mem_map, bool use_gen
                                  kGcRetentionPolicyAlwaysCollect),
       region_lock_("Region lock", kRegionSpaceRegionLock),
       use_generational_cc_(use_generational_cc),
+      use_huge_pages_(use_huge_pages),
+      num_numa_nodes_(std::max(numa_nodes.size(), static_cast<size_t>(1u))),
+      numa_nodes_(numa_nodes),
+      fake_numa_topology_(fake_numa_topology),
       time_(1U),
       num_regions_(mem_map_.Size() / kRegionSize),
       madvise_time_(0U),
@@ -121,6 +174,7 @@ RegionSpace::RegionSpace(const std::string& name, MemMap&& mem_map, bool use_gen
   CHECK_ALIGNED(mem_map_.Size(), kRegionSize);
   CHECK_ALIGNED(mem_map_.Begin(), kRegionSize);
   DCHECK_GT(num_regions_, 0U);
+  CHECK_LE(num_numa_nodes_, num_regions_);
   regions_.reset(new Region[num_regions_]);
   uint8_t* region_addr = mem_map_.Begin();
   for (size_t i = 0; i < num_regions_; ++i, region_addr += kRegionSize) {
@@ -143,10 +197,59 @@ RegionSpace::RegionSpace(const std::string& name, MemMap&& mem_map, bool use_gen
   DCHECK(full_region_.IsAllocated());
   size_t ignored;
   DCHECK(full_region_.Alloc(kAlignment, &ignored, nullptr, &ignored) == nullptr);
+  if (num_numa_nodes_ > 1u && !fake_numa_topology_) {
+    BindRegionsToNumaNodes();
+  }
   // Protect the whole region space from the start.
   Protect();
 }
 
+void RegionSpace::BindRegionsToNumaNodes() {
+#if defined(__linux__)
+  static constexpr size_t kBitsPerMaskWord = BitSizeOf<unsigned long>();  // NOLINT
+  for (size_t index = 0; index < num_numa_nodes_; ++index) {
+    uint8_t* begin = Begin() + GetNumaNodeFirstRegion(index) * kRegionSize;
+    uint8_t* end = Begin() + GetNumaNodeFirstRegion(index + 1) * kRegionSize;
+    const size_t node = numa_nodes_[index];
+    std::vector<unsigned long> node_mask(node / kBitsPerMaskWord + 1, 0u);  // NOLINT
+    node_mask[node / kBitsPerMaskWord] = 1ul << (node % kBitsPerMaskWord);
+    // MPOL_PREFERRED rather than MPOL_BIND: when the node runs out of memory we would rather get
+    // remote pages than fail.
+    if (syscall(__NR_mbind,
+                begin,
+                end - begin,
+                MPOL_PREFERRED,
+                node_mask.data(),
+                node_mask.size() * kBitsPerMaskWord,
+                0u) != 0) {
+      PLOG(WARNING) << "Failed to bind regions of " << GetName() << " to NUMA node " << node;
+      return;
+    }
+  }
+#endif
+}
+
+size_t RegionSpace::GetNumaNode(Thread* self) const {
+  if (num_numa_nodes_ == 1u) {
+    return 0u;
+  }
+  if (fake_numa_topology_) {
+    return static_cast<size_t>(self->GetTid()) % num_numa_nodes_;
+  }
+  unsigned int node = 0u;
+#if defined(__linux__)
+  unsigned int cpu;
+  if (syscall(__NR_getcpu, &cpu, &node, nullptr) != 0) {
+    return 0u;
+  }
+#endif
+  // Node ids need not be contiguous, map the id to the index of its range.
+  auto it = std::lower_bound(numa_nodes_.begin(), numa_nodes_.end(), node);
+  return (it != numa_nodes_.end() && *it == node)
+      ? static_cast<size_t>(std::distance(numa_nodes_.begin(), it))
+      : 0u;
+}
+
 size_t RegionSpace::FromSpaceSize() {
   uint64_t num_regions = 0;
   MutexLock mu(Thread::Current(), region_lock_);
@@ -393,8 +496,22 @@ void RegionSpace::SetFromSpace(accounting::ReadBarrierTable* rb_table,
   evac_region_ = &full_region_;
 }
 
-static void ZeroAndProtectRegion(uint8_t* begin, uint8_t* end, bool release_eagerly) {
-  ZeroMemory(begin, end - begin, release_eagerly);
+static void ZeroAndProtectRegion(uint8_t* begin,
+                                 uint8_t* end,
+                                 bool release_eagerly,
+                                 bool use_huge_pages = false) {
+  if (!use_huge_pages) {
+    ZeroMemory(begin, end - begin, release_eagerly);
+  } else {
+    // Only whole huge pages are handed back to the kernel. The partial huge pages at either end
+    // are still backing live regions, so zero them in place: any madvise on them, even
+    // MADV_FREE, would split the huge page.
+    uint8_t* huge_begin = std::min(AlignUp(begin, gPMDSize), end);
+    uint8_t* huge_end = std::max(AlignDown(end, gPMDSize), huge_begin);
+    std::fill(begin, huge_begin, 0);
+    ZeroMemory(huge_begin, huge_end - huge_begin, release_eagerly);
+    std::fill(huge_end, end, 0);
+  }
   if (kProtectClearedRegions) {
     CheckedCall(mprotect, __FUNCTION__, begin, end - begin, PROT_NONE);
   }
@@ -402,14 +519,28 @@ static void ZeroAndProtectRegion(uint8_t* begin, uint8_t* end, bool release_eage
 
 void RegionSpace::ReleaseFreeRegions() {
   MutexLock mu(Thread::Current(), region_lock_);
+  // Coalesce runs of free regions so that each run costs a single madvise, and with transparent
+  // huge pages only release the huge pages that lie entirely within a run.
   for (size_t i = 0u; i < num_regions_; ++i) {
-    if (regions_[i].IsFree()) {
-      uint8_t* begin = regions_[i].Begin();
-      DCHECK_ALIGNED_PARAM(begin, gPageSize);
-      DCHECK_ALIGNED_PARAM(regions_[i].End(), gPageSize);
-      bool res = madvise(begin, regions_[i].End() - begin, MADV_DONTNEED);
-      CHECK_NE(res, -1) << "madvise failed";
+    if (!regions_[i].IsFree()) {
+      continue;
+    }
+    uint8_t* begin = regions_[i].Begin();
+    while (i + 1 < num_regions_ && regions_[i + 1].IsFree()) {
+      ++i;
+    }
+    uint8_t* end = regions_[i].End();
+    if (use_huge_pages_) {
+      begin = AlignUp(begin, gPMDSize);
+      end = AlignDown(end, gPMDSize);
+      if (begin >= end) {
+        continue;
+      }
     }
+    DCHECK_ALIGNED_PARAM(begin, gPageSize);
+    DCHECK_ALIGNED_PARAM(end, gPageSize);
+    bool res = madvise(begin, end - begin, MADV_DONTNEED);
+    CHECK_NE(res, -1) << "madvise failed";
   }
 }
 
@@ -497,7 +628,7 @@ void RegionSpace::ClearFromSpace(/* out */ uint64_t* cleared_bytes,
   // Madvise the memory ranges.
   uint64_t start_time = NanoTime();
   for (const auto &iter : madvise_list) {
-    ZeroAndProtectRegion(iter.first, iter.second, release_eagerly);
+    ZeroAndProtectRegion(iter.first, iter.second, release_eagerly, use_huge_pages_);
   }
   madvise_time_ += NanoTime() - start_time;
 
@@ -1042,14 +1173,20 @@ RegionSpace::Region* RegionSpace::AllocateRegion(bool for_evac) {
   if (!for_evac && (num_non_free_regions_ + 1) * 2 > num_regions_) {
     return nullptr;
   }
+  // With NUMA-aware allocation, start from the regions of the allocating thread's node, so
+  // mutators get node-local TLABs and GC threads evacuate into node-local regions. Other nodes'
+  // regions are only used once those run out.
+  const bool numa_aware = num_numa_nodes_ > 1u;
+  const size_t first_region =
+      numa_aware ? GetNumaNodeFirstRegion(GetNumaNode(Thread::Current())) : 0u;
   for (size_t i = 0; i < num_regions_; ++i) {
     // When using the cyclic region allocation strategy, try to
     // allocate a region starting from the last cyclic allocated
     // region marker. Otherwise, try to allocate a region starting
     // from the beginning of the region space.
-    size_t region_index = kCyclicRegionAllocation
+    size_t region_index = (kCyclicRegionAllocation && !numa_aware)
         ? ((cyclic_alloc_region_index_ + i) % num_regions_)
-        : i;
+        : ((first_region + i) % num_regions_);
     Region* r = &regions_[region_index];
     if (r->IsFree()) {
       r->Unfree(this, time_);
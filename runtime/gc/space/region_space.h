@@ -24,6 +24,7 @@
 
 #include <functional>
 #include <map>
+#include <vector>
 
 namespace art {
 namespace gc {
@@ -60,9 +61,27 @@ class RegionSpace final : public ContinuousMemMapAllocSpace {
 
   // Create a region space mem map with the requested sizes. The requested base address is not
   // guaranteed to be granted, if it is required, the caller should call Begin on the returned
-  // space to confirm the request was granted.
-  static MemMap CreateMemMap(const std::string& name, size_t capacity, uint8_t* requested_begin);
-  static RegionSpace* Create(const std::string& name, MemMap&& mem_map, bool use_generational_cc);
+  // space to confirm the request was granted. If `use_huge_pages` is true, the map is aligned to
+  // the PMD size and advised to be backed by transparent huge pages.
+  static MemMap CreateMemMap(const std::string& name,
+                             size_t capacity,
+                             uint8_t* requested_begin,
+                             bool use_huge_pages = false);
+  // With more than one node in numa_nodes, the regions are split into one contiguous range per
+  // NUMA node, in the order of numa_nodes, and regions are allocated from the range of the
+  // allocating thread's node first. With fake_numa_topology the ranges are not bound to real
+  // nodes and threads are assigned to nodes by thread id, which lets the placement logic run on
+  // single-node machines.
+  static RegionSpace* Create(const std::string& name,
+                             MemMap&& mem_map,
+                             bool use_generational_cc,
+                             bool use_huge_pages = false,
+                             const std::vector<uint32_t>& numa_nodes = {},
+                             bool fake_numa_topology = false);
+
+  // The sorted ids of the NUMA nodes of the system, which need not be contiguous. Empty if they
+  // can't be determined.
+  static std::vector<uint32_t> GetConfiguredNumaNodes();
 
   // Allocate `num_bytes`, returns null if the space is full.
   mirror::Object* Alloc(Thread* self,
@@ -192,6 +211,17 @@ class RegionSpace final : public ContinuousMemMapAllocSpace {
   size_t GetNumRegions() const {
     return num_regions_;
   }
+  size_t GetNumNumaNodes() const {
+    return num_numa_nodes_;
+  }
+  // The index of the NUMA node whose regions are preferred for allocations by self.
+  size_t GetNumaNode(Thread* self) const;
+  // Index of the first region of the node with the given index. Node num_numa_nodes_ maps to
+  // num_regions_.
+  size_t GetNumaNodeFirstRegion(size_t node) const {
+    DCHECK_LE(node, num_numa_nodes_);
+    return node * num_regions_ / num_numa_nodes_;
+  }
   size_t GetNumNonFreeRegions() const NO_THREAD_SAFETY_ANALYSIS {
     return num_non_free_regions_;
   }
@@ -388,7 +418,15 @@ class RegionSpace final : public ContinuousMemMapAllocSpace {
   void ReleaseFreeRegions();
 
  private:
-  RegionSpace(const std::string& name, MemMap&& mem_map, bool use_generational_cc);
+  RegionSpace(const std::string& name,
+              MemMap&& mem_map,
+              bool use_generational_cc,
+              bool use_huge_pages,
+              const std::vector<uint32_t>& numa_nodes,
+              bool fake_numa_topology);
+
+  // Set the memory policy of each node's range of regions to prefer that node.
+  void BindRegionsToNumaNodes();
 
   class Region {
    public:
@@ -749,6 +787,15 @@ class RegionSpace final : public ContinuousMemMapAllocSpace {
 
   // Cached version of Heap::use_generational_cc_.
   const bool use_generational_cc_;
+  // Cached version of Heap::use_transparent_huge_pages_. When set, memory is only returned to the
+  // kernel in whole huge pages so that the remaining huge pages are not split.
+  const bool use_huge_pages_;
+  // Number of NUMA nodes the regions are split between, 1 when NUMA-aware allocation is off.
+  const size_t num_numa_nodes_;
+  // The sorted ids of these nodes, indexed like the region ranges. Empty when NUMA-aware
+  // allocation is off.
+  const std::vector<uint32_t> numa_nodes_;
+  const bool fake_numa_topology_;
   uint32_t time_;                  // The time as the number of collections since the startup.
   size_t num_regions_;             // The number of regions in this space.
   uint64_t madvise_time_;          // The amount of time spent in madvise for purging pages.
@@ -27,6 +27,7 @@
 #include "art_method-inl.h"
 #include "base/atomic.h"
 #include "base/callee_save_type.h"
+#include "cha.h"
 #include "class_linker.h"
 #include "debugger.h"
 #include "dex/dex_file-inl.h"
@@ -249,6 +250,12 @@ static bool CodeSupportsEntryExitHooks(const void* entry_point, ArtMethod* metho
   return false;
 }
 
+static bool CanUseNterp(ArtMethod* method) REQUIRES_SHARED(Locks::mutator_lock_) {
+  return interpreter::CanRuntimeUseNterp() &&
+      CanMethodUseNterp(method) &&
+      method->IsDeclaringClassVerifiedMayBeDead();
+}
+
 static void UpdateEntryPoints(ArtMethod* method, const void* quick_code)
     REQUIRES_SHARED(Locks::mutator_lock_) {
   if (kIsDebugBuild) {
@@ -270,7 +277,20 @@ static void UpdateEntryPoints(ArtMethod* method, const void* quick_code)
   // If the method is from a boot image, don't dirty it if the entrypoint
   // doesn't change.
   if (method->GetEntryPointFromQuickCompiledCode() != quick_code) {
-    method->SetEntryPointFromQuickCompiledCode(quick_code);
+    ClassLinker* class_linker = Runtime::Current()->GetClassLinker();
+    ClassHierarchyAnalysis* cha = class_linker->GetClassHierarchyAnalysis();
+    // Only AOT code can have been invalidated by CHA, stubs and nterp can always be used.
+    if (cha == nullptr ||
+        class_linker->IsQuickResolutionStub(quick_code) ||
+        class_linker->IsQuickToInterpreterBridge(quick_code) ||
+        class_linker->IsQuickGenericJniStub(quick_code) ||
+        class_linker->IsNterpEntryPoint(quick_code)) {
+      method->SetEntryPointFromQuickCompiledCode(quick_code);
+    } else if (!cha->SetEntryPointUnlessInvalidated(method, quick_code)) {
+      // The AOT code was invalidated since the caller checked it.
+      method->SetEntryPointFromQuickCompiledCode(
+          CanUseNterp(method) ? interpreter::GetNterpEntryPoint() : GetQuickToInterpreterBridge());
+    }
   }
 }
 
@@ -285,7 +305,7 @@ bool Instrumentation::InterpretOnly(ArtMethod* method) REQUIRES_SHARED(Locks::mu
   return InterpretOnly() || IsDeoptimized(method);
 }
 
-static bool CanUseAotCode(const void* quick_code)
+static bool CanUseAotCode(ArtMethod* method, const void* quick_code)
     REQUIRES_SHARED(Locks::mutator_lock_) {
   if (quick_code == nullptr) {
     return false;
@@ -306,13 +326,14 @@ static bool CanUseAotCode(const void* quick_code)
     return runtime->GetHeap()->IsInBootImageOatFile(quick_code);
   }
 
-  return true;
-}
+  // Code compiled assuming a closed class hierarchy may have been invalidated by
+  // classes loaded at runtime.
+  ClassHierarchyAnalysis* cha = runtime->GetClassLinker()->GetClassHierarchyAnalysis();
+  if (cha != nullptr && cha->IsAotCodeInvalidated(method, quick_code)) {
+    return false;
+  }
 
-static bool CanUseNterp(ArtMethod* method) REQUIRES_SHARED(Locks::mutator_lock_) {
-  return interpreter::CanRuntimeUseNterp() &&
-      CanMethodUseNterp(method) &&
-      method->IsDeclaringClassVerifiedMayBeDead();
+  return true;
 }
 
 static const void* GetOptimizedCodeFor(ArtMethod* method) REQUIRES_SHARED(Locks::mutator_lock_) {
@@ -325,7 +346,7 @@ static const void* GetOptimizedCodeFor(ArtMethod* method) REQUIRES_SHARED(Locks:
   // In debuggable mode, we can only use AOT code for native methods.
   ClassLinker* class_linker = Runtime::Current()->GetClassLinker();
   const void* aot_code = method->GetOatMethodQuickCode(class_linker->GetImagePointerSize());
-  if (CanUseAotCode(aot_code)) {
+  if (CanUseAotCode(method, aot_code)) {
     return aot_code;
   }
 
@@ -389,7 +410,7 @@ void Instrumentation::InitializeMethodsCode(ArtMethod* method, const void* aot_c
   }
 
   // Use the provided AOT code if possible.
-  if (CanUseAotCode(aot_code)) {
+  if (CanUseAotCode(method, aot_code)) {
     UpdateEntryPoints(method, aot_code);
     return;
   }
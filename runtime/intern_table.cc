@@ -39,7 +39,8 @@ namespace art {
 InternTable::InternTable()
     : log_new_roots_(false),
       weak_intern_condition_("New intern condition", *Locks::intern_table_lock_),
-      weak_root_state_(gc::kWeakRootStateNormal) {
+      weak_root_state_(gc::kWeakRootStateNormal),
+      frozen_strong_interns_(nullptr) {
 }
 
 size_t InternTable::Size() const {
@@ -110,20 +111,67 @@ ObjPtr<mirror::String> InternTable::LookupWeak(Thread* self, ObjPtr<mirror::Stri
   return weak_interns_.Find(s, hash);
 }
 
+template <typename Key>
+ObjPtr<mirror::String> InternTable::FindFrozenStrong(const Key& key,
+                                                     uint32_t hash,
+                                                     size_t* num_searched_frozen_tables) {
+  const FrozenTables* frozen = frozen_strong_interns_.load(std::memory_order_acquire);
+  if (frozen == nullptr) {
+    return nullptr;
+  }
+  DCHECK_LE(*num_searched_frozen_tables, frozen->Size());
+  auto begin = frozen->views_.begin() + *num_searched_frozen_tables;
+  // Search from the last table, assuming that apps shall search for their own
+  // strings more often than for boot image strings.
+  for (const UnorderedSet& set : ReverseRange(MakeIterationRange(begin, frozen->views_.end()))) {
+    auto it = set.FindWithHash(key, hash);
+    if (it != set.end()) {
+      return it->Read();
+    }
+  }
+  *num_searched_frozen_tables = frozen->Size();
+  return nullptr;
+}
+
+void InternTable::PublishFrozenStrongTables() {
+  DCHECK(!strong_interns_.tables_.empty());
+  size_t num_frozen_tables = strong_interns_.tables_.size() - 1u;
+  dchecked_vector<UnorderedSet> views;
+  views.reserve(num_frozen_tables);
+  for (size_t i = 0; i != num_frozen_tables; ++i) {
+    views.push_back(UnorderedSet::CreateView(strong_interns_.tables_[i].set_));
+  }
+  frozen_strong_interns_storage_.push_back(std::make_unique<FrozenTables>(std::move(views)));
+  frozen_strong_interns_.store(frozen_strong_interns_storage_.back().get(),
+                               std::memory_order_release);
+}
+
 ObjPtr<mirror::String> InternTable::LookupStrong(Thread* self, ObjPtr<mirror::String> s) {
   DCHECK(s != nullptr);
   // `String::GetHashCode()` ensures that the stored hash is calculated.
   uint32_t hash = static_cast<uint32_t>(s->GetHashCode());
+  size_t num_searched_frozen_tables = 0u;
+  ObjPtr<mirror::String> frozen =
+      FindFrozenStrong(GcRoot<mirror::String>(s), hash, &num_searched_frozen_tables);
+  if (frozen != nullptr) {
+    return frozen;
+  }
   MutexLock mu(self, *Locks::intern_table_lock_);
-  return strong_interns_.Find(s, hash);
+  return strong_interns_.Find(s, hash, num_searched_frozen_tables);
 }
 
 ObjPtr<mirror::String> InternTable::LookupStrong(Thread* self,
                                                  uint32_t utf16_length,
                                                  const char* utf8_data) {
   uint32_t hash = Utf8String::Hash(utf16_length, utf8_data);
+  Utf8String string(utf16_length, utf8_data);
+  size_t num_searched_frozen_tables = 0u;
+  ObjPtr<mirror::String> frozen = FindFrozenStrong(string, hash, &num_searched_frozen_tables);
+  if (frozen != nullptr) {
+    return frozen;
+  }
   MutexLock mu(self, *Locks::intern_table_lock_);
-  return strong_interns_.Find(Utf8String(utf16_length, utf8_data), hash);
+  return strong_interns_.Find(string, hash, num_searched_frozen_tables);
 }
 
 ObjPtr<mirror::String> InternTable::LookupWeakLocked(ObjPtr<mirror::String> s) {
@@ -144,6 +192,7 @@ void InternTable::AddNewTable() {
   MutexLock mu(Thread::Current(), *Locks::intern_table_lock_);
   weak_interns_.AddNewTable();
   strong_interns_.AddNewTable();
+  PublishFrozenStrongTables();
 }
 
 ObjPtr<mirror::String> InternTable::InsertStrong(ObjPtr<mirror::String> s, uint32_t hash) {
@@ -206,6 +255,13 @@ ObjPtr<mirror::String> InternTable::Insert(ObjPtr<mirror::String> s,
   DCHECK_EQ(hash, static_cast<uint32_t>(s->GetStoredHashCode()));
   DCHECK_IMPLIES(hash == 0u, s->ComputeHashCode() == 0);
   Thread* const self = Thread::Current();
+  // Frozen strong tables can be searched without the lock. Most strings that are interned
+  // repeatedly, such as string literals, shall be found there.
+  ObjPtr<mirror::String> frozen =
+      FindFrozenStrong(GcRoot<mirror::String>(s), hash, &num_searched_strong_frozen_tables);
+  if (frozen != nullptr) {
+    return frozen;
+  }
   MutexLock mu(self, *Locks::intern_table_lock_);
   if (kDebugLocking) {
     Locks::mutator_lock_->AssertSharedHeld(self);
@@ -253,14 +309,18 @@ ObjPtr<mirror::String> InternTable::InternStrong(uint32_t utf16_length, const ch
   DCHECK(utf8_data != nullptr);
   uint32_t hash = Utf8String::Hash(utf16_length, utf8_data);
   Thread* self = Thread::Current();
-  ObjPtr<mirror::String> s;
-  size_t num_searched_strong_frozen_tables;
+  Utf8String string(utf16_length, utf8_data);
+  size_t num_searched_strong_frozen_tables = 0u;
+  ObjPtr<mirror::String> s = FindFrozenStrong(string, hash, &num_searched_strong_frozen_tables);
+  if (s != nullptr) {
+    return s;
+  }
   {
     // Try to avoid allocation. If we need to allocate, release the mutex before the allocation.
     MutexLock mu(self, *Locks::intern_table_lock_);
     DCHECK(!strong_interns_.tables_.empty());
+    s = strong_interns_.Find(string, hash, num_searched_strong_frozen_tables);
     num_searched_strong_frozen_tables = strong_interns_.tables_.size() - 1u;
-    s = strong_interns_.Find(Utf8String(utf16_length, utf8_data), hash);
   }
   if (s != nullptr) {
     return s;
@@ -352,11 +412,14 @@ ObjPtr<mirror::String> InternTable::Table::Find(ObjPtr<mirror::String> s,
 }
 
 FLATTEN
-ObjPtr<mirror::String> InternTable::Table::Find(const Utf8String& string, uint32_t hash) {
+ObjPtr<mirror::String> InternTable::Table::Find(const Utf8String& string,
+                                                uint32_t hash,
+                                                size_t num_searched_frozen_tables) {
   Locks::intern_table_lock_->AssertHeld(Thread::Current());
+  auto mid = tables_.begin() + num_searched_frozen_tables;
   // Search from the last table, assuming that apps shall search for their own
   // strings more often than for boot image strings.
-  for (InternalTable& table : ReverseRange(tables_)) {
+  for (InternalTable& table : ReverseRange(MakeIterationRange(mid, tables_.end()))) {
     auto it = table.set_.FindWithHash(string, hash);
     if (it != table.set_.end()) {
       return it->Read();
@@ -17,6 +17,9 @@
 #ifndef ART_RUNTIME_INTERN_TABLE_H_
 #define ART_RUNTIME_INTERN_TABLE_H_
 
+#include <atomic>
+#include <memory>
+
 #include "base/dchecked_vector.h"
 #include "base/gc_visited_arena_pool.h"
 #include "base/hash_set.h"
@@ -241,7 +244,9 @@ class InternTable {
                                 uint32_t hash,
                                 size_t num_searched_frozen_tables = 0u)
         REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(Locks::intern_table_lock_);
-    ObjPtr<mirror::String> Find(const Utf8String& string, uint32_t hash)
+    ObjPtr<mirror::String> Find(const Utf8String& string,
+                                uint32_t hash,
+                                size_t num_searched_frozen_tables = 0u)
         REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(Locks::intern_table_lock_);
     void Insert(ObjPtr<mirror::String> s, uint32_t hash)
         REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(Locks::intern_table_lock_);
@@ -279,6 +284,38 @@ class InternTable {
     ART_FRIEND_TEST(InternTableTest, CrossHash);
   };
 
+  // Immutable snapshot of the frozen strong tables, i.e. all strong tables except the last one.
+  // Frozen tables are never inserted into, so their data can be searched without holding the
+  // `Locks::intern_table_lock_`. The `views_` alias the data of `strong_interns_.tables_` in
+  // the same order; new frozen tables are only ever appended, see `Table::AddInternStrings()`.
+  class FrozenTables {
+   public:
+    explicit FrozenTables(dchecked_vector<UnorderedSet>&& views) : views_(std::move(views)) {}
+
+    size_t Size() const {
+      return views_.size();
+    }
+
+   private:
+    dchecked_vector<UnorderedSet> views_;
+
+    friend class InternTable;
+  };
+
+  // Lock-free lookup in the frozen strong tables. Tables with index below
+  // `*num_searched_frozen_tables` are skipped. On return, `*num_searched_frozen_tables` holds
+  // the number of frozen tables searched so far, so that the caller can skip them when it
+  // continues the search in `strong_interns_` while holding the `Locks::intern_table_lock_`.
+  template <typename Key>
+  ObjPtr<mirror::String> FindFrozenStrong(const Key& key,
+                                          uint32_t hash,
+                                          /*inout*/ size_t* num_searched_frozen_tables)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
+  // Publish a new snapshot of the frozen strong tables after `strong_interns_.tables_` changed.
+  void PublishFrozenStrongTables()
+      REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(Locks::intern_table_lock_);
+
   // Insert if non null, otherwise return null. Must be called holding the mutator lock.
   ObjPtr<mirror::String> Insert(ObjPtr<mirror::String> s,
                                 uint32_t hash,
@@ -322,6 +359,13 @@ class InternTable {
   // not directly access the strings in it. Use functions that contain
   // read barriers.
   Table weak_interns_ GUARDED_BY(Locks::intern_table_lock_);
+  // The current snapshot of frozen strong tables for lock-free lookups, null if there are none.
+  std::atomic<const FrozenTables*> frozen_strong_interns_;
+  // All snapshots ever published. Readers may still use an old snapshot after a new one has been
+  // published, so we keep them until the intern table is destroyed. There is one snapshot per
+  // image with interned strings plus one for the zygote, so this does not grow in steady state.
+  dchecked_vector<std::unique_ptr<const FrozenTables>> frozen_strong_interns_storage_
+      GUARDED_BY(Locks::intern_table_lock_);
   // Weak root state, used for concurrent system weak processing and more.
   gc::WeakRootState weak_root_state_ GUARDED_BY(Locks::intern_table_lock_);
 
@@ -263,4 +263,30 @@ TEST_F(InternTableTest, InternStrongFrozenWeak) {
   ASSERT_TRUE(strong_foo == foo.Get());
 }
 
+TEST_F(InternTableTest, LookupStrongFrozen) {
+  ScopedObjectAccess soa(Thread::Current());
+  InternTable intern_table;
+  StackHandleScope<2> hs(soa.Self());
+  Handle<mirror::String> foo = hs.NewHandle(intern_table.InternStrong(3, "foo"));
+  ASSERT_TRUE(foo != nullptr);
+
+  // Freeze the table with "foo"; it shall now be found by the lock-free lookup.
+  intern_table.AddNewTable();
+
+  Handle<mirror::String> bar = hs.NewHandle(intern_table.InternStrong(3, "bar"));
+  ASSERT_TRUE(bar != nullptr);
+  EXPECT_OBJ_PTR_EQ(foo.Get(), intern_table.LookupStrong(soa.Self(), 3, "foo"));
+  EXPECT_OBJ_PTR_EQ(bar.Get(), intern_table.LookupStrong(soa.Self(), 3, "bar"));
+  EXPECT_OBJ_PTR_EQ(foo.Get(), intern_table.InternStrong(3, "foo"));
+  EXPECT_OBJ_PTR_EQ(bar.Get(), intern_table.InternStrong(3, "bar"));
+  EXPECT_OBJ_PTR_EQ(foo.Get(), intern_table.LookupStrong(soa.Self(), foo.Get()));
+
+  // Freezing again shall keep both strings visible.
+  intern_table.AddNewTable();
+  EXPECT_OBJ_PTR_EQ(foo.Get(), intern_table.LookupStrong(soa.Self(), 3, "foo"));
+  EXPECT_OBJ_PTR_EQ(bar.Get(), intern_table.LookupStrong(soa.Self(), 3, "bar"));
+  EXPECT_TRUE(intern_table.LookupStrong(soa.Self(), 3, "baz") == nullptr);
+  EXPECT_EQ(2u, intern_table.StrongSize());
+}
+
 }  // namespace art
@@ -63,6 +63,17 @@ namespace jit {
 
 static constexpr bool kEnableOnStackReplacement = true;
 
+// Whether hot baseline code is first recompiled with the cheaper baseline-plus
+// tier when an optimized compilation of the method is expected to be expensive.
+static constexpr bool kUseBaselinePlusTier = true;
+
+// Estimated optimized compile time above which we go through the baseline-plus tier.
+static constexpr uint64_t kBaselinePlusCompileTimeThresholdNs = MsToNs(5);
+
+// Number of dex code units that must have been compiled optimized before we trust
+// the measured compile time per code unit.
+static constexpr uint64_t kMinimumCodeUnitsForCompileTimeEstimate = 4096;
+
 // Maximum permitted threshold value.
 static constexpr uint32_t kJitMaxThreshold = std::numeric_limits<uint16_t>::max();
 
@@ -183,6 +194,8 @@ Jit::Jit(JitCodeCache* code_cache, JitOptions* options)
       cumulative_timings_("JIT timings"),
       memory_use_("Memory used for compilation", 16),
       lock_("JIT memory use lock"),
+      optimized_compile_time_ns_(0u),
+      optimized_compiled_code_units_(0u),
       zygote_mapping_methods_(),
       fd_methods_(-1),
       fd_methods_size_(0) {}
@@ -240,7 +253,8 @@ bool Jit::CompileMethodInternal(ArtMethod* method,
 
   // If we're asked to compile baseline, but we cannot allocate profiling infos,
   // change the compilation kind to optimized.
-  if ((compilation_kind == CompilationKind::kBaseline) &&
+  if ((compilation_kind == CompilationKind::kBaseline ||
+       compilation_kind == CompilationKind::kBaselinePlus) &&
       !GetCodeCache()->CanAllocateProfilingInfo()) {
     compilation_kind = CompilationKind::kOptimized;
   }
@@ -303,12 +317,22 @@ bool Jit::CompileMethodInternal(ArtMethod* method,
   VLOG(jit) << "Compiling method "
             << ArtMethod::PrettyMethod(method_to_compile)
             << " kind=" << compilation_kind;
+  uint64_t start_ns = ThreadCpuNanoTime();
   bool success = jit_compiler_->CompileMethod(self, region, method_to_compile, compilation_kind);
+  uint64_t compile_time_ns = ThreadCpuNanoTime() - start_ns;
   code_cache_->DoneCompiling(method_to_compile, self);
   if (!success) {
     VLOG(jit) << "Failed to compile method "
               << ArtMethod::PrettyMethod(method_to_compile)
               << " kind=" << compilation_kind;
+  } else if (compilation_kind == CompilationKind::kOptimized && !method_to_compile->IsNative()) {
+    optimized_compile_time_ns_.fetch_add(compile_time_ns, std::memory_order_relaxed);
+    optimized_compiled_code_units_.fetch_add(
+        method_to_compile->DexInstructions().InsnsSizeInCodeUnits(), std::memory_order_relaxed);
+  } else if (compilation_kind == CompilationKind::kBaselinePlus) {
+    // The baseline-plus code keeps profiling: give it a full hotness period before
+    // considering the optimized compilation.
+    code_cache_->ResetHotnessCounter(method_to_compile, self);
   }
   if (kIsDebugBuild) {
     if (self->IsExceptionPending()) {
@@ -1451,8 +1475,37 @@ void Jit::EnqueueOptimizedCompilation(ArtMethod* method, Thread* self) {
   // hotness threshold. If we're not only using the baseline compiler, enqueue a compilation
   // task that will compile optimize the method.
   if (!options_->UseBaselineCompiler()) {
-    AddCompileTask(self, method, CompilationKind::kOptimized);
+    AddCompileTask(self,
+                   method,
+                   ShouldCompileBaselinePlus(method) ? CompilationKind::kBaselinePlus
+                                                     : CompilationKind::kOptimized);
+  }
+}
+
+uint64_t Jit::EstimateOptimizedCompileTimeNs(ArtMethod* method) {
+  uint64_t code_units = optimized_compiled_code_units_.load(std::memory_order_relaxed);
+  if (code_units < kMinimumCodeUnitsForCompileTimeEstimate) {
+    return 0u;
+  }
+  uint64_t time_ns = optimized_compile_time_ns_.load(std::memory_order_relaxed);
+  return time_ns * method->DexInstructions().InsnsSizeInCodeUnits() / code_units;
+}
+
+bool Jit::ShouldCompileBaselinePlus(ArtMethod* method) {
+  if (!kUseBaselinePlusTier || method->IsNative()) {
+    return false;
+  }
+  // Only go through the baseline-plus tier once, coming from baseline code.
+  const void* entry_point = method->GetEntryPointFromQuickCompiledCode();
+  if (!code_cache_->ContainsPc(entry_point)) {
+    return false;
+  }
+  const OatQuickMethodHeader* header = OatQuickMethodHeader::FromEntryPoint(entry_point);
+  if (!CodeInfo::IsBaseline(header->GetOptimizedCodeInfoPtr()) ||
+      CodeInfo::IsBaselinePlus(header->GetOptimizedCodeInfoPtr())) {
+    return false;
   }
+  return EstimateOptimizedCompileTimeNs(method) >= kBaselinePlusCompileTimeThresholdNs;
 }
 
 class ScopedSetRuntimeThread {
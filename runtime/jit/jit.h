@@ -17,6 +17,8 @@
 #ifndef ART_RUNTIME_JIT_JIT_H_
 #define ART_RUNTIME_JIT_JIT_H_
 
+#include <atomic>
+
 #include <android-base/unique_fd.h>
 
 #include "base/histogram-inl.h"
@@ -474,6 +476,14 @@ class Jit {
                              bool prejit)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Whether a method whose baseline code reached its hotness threshold should
+  // first be recompiled with the baseline-plus tier rather than straight to optimized.
+  bool ShouldCompileBaselinePlus(ArtMethod* method) REQUIRES_SHARED(Locks::mutator_lock_);
+
+  // Estimate of the time it would take to compile `method` optimized, based on the
+  // compile time per code unit measured so far. Returns 0 if not enough data is available.
+  uint64_t EstimateOptimizedCompileTimeNs(ArtMethod* method) REQUIRES_SHARED(Locks::mutator_lock_);
+
   // JIT compiler
   static JitCompilerInterface* jit_compiler_;
 
@@ -493,6 +503,11 @@ class Jit {
   Histogram<uint64_t> memory_use_ GUARDED_BY(lock_);
   Mutex lock_ DEFAULT_MUTEX_ACQUIRED_AFTER;
 
+  // Thread CPU time spent in optimized compilations, and the number of dex code
+  // units compiled by them. Used to estimate the cost of an optimized compilation.
+  std::atomic<uint64_t> optimized_compile_time_ns_;
+  std::atomic<uint64_t> optimized_compiled_code_units_;
+
   // In the JIT zygote configuration, after all compilation is done, the zygote
   // will copy its contents of the boot image to the zygote_mapping_methods_,
   // which will be picked up by processes that will map the memory
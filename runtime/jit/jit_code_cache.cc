@@ -16,6 +16,7 @@
 
 #include "jit_code_cache.h"
 
+#include <algorithm>
 #include <sstream>
 
 #include <android-base/logging.h>
@@ -66,6 +67,11 @@ namespace jit {
 static constexpr size_t kCodeSizeLogThreshold = 50 * KB;
 static constexpr size_t kStackMapSizeLogThreshold = 50 * KB;
 
+// Upper bound on the number of allocation samples waiting for their fate to be known.
+static constexpr size_t kMaxAllocationSamples = 4 * KB;
+// Number of GCs a sampled object must survive to count as long-lived for its allocation site.
+static constexpr uint32_t kAllocationSampleSurvivedGcs = 2;
+
 class JitCodeCache::JniStubKey {
  public:
   explicit JniStubKey(ArtMethod* method) REQUIRES_SHARED(Locks::mutator_lock_)
@@ -263,8 +269,13 @@ JitCodeCache::JitCodeCache()
       collection_in_progress_(false),
       garbage_collect_code_(true),
       number_of_baseline_compilations_(0),
+      number_of_baseline_plus_compilations_(0),
       number_of_optimized_compilations_(0),
       number_of_osr_compilations_(0),
+      baseline_code_size_(0),
+      baseline_plus_code_size_(0),
+      optimized_code_size_(0),
+      osr_code_size_(0),
       number_of_collections_(0),
       histogram_stack_map_memory_use_("Memory used for stack maps", 16),
       histogram_code_memory_use_("Memory used for compiled code", 16),
@@ -455,11 +466,63 @@ void JitCodeCache::SweepRootTables(IsMarkedVisitor* visitor) {
           mirror::Class* new_klass = down_cast<mirror::Class*>(visitor->IsMarked(klass));
           if (new_klass != klass) {
             cache->classes_[j] = GcRoot<mirror::Class>(new_klass);
+            if (new_klass == nullptr) {
+              // The entry can be reused by another class, forget the calls seen so far.
+              cache->counts_[j] = 0u;
+            }
           }
         }
       }
     }
   }
+  SweepAllocationSamples(visitor);
+}
+
+void JitCodeCache::SweepAllocationSamples(IsMarkedVisitor* visitor) {
+  auto is_resolved = [&](AllocationSample& sample) REQUIRES(Locks::jit_lock_) {
+    mirror::Object* object = sample.object.Read<kWithoutReadBarrier>();
+    mirror::Object* new_object = visitor->IsMarked(object);
+    bool survived = (new_object != nullptr);
+    if (survived) {
+      sample.object = GcRoot<mirror::Object>(new_object);
+      if (++sample.survived_gcs < kAllocationSampleSurvivedGcs) {
+        return false;
+      }
+    }
+    // The method may have lost its profiling info since the sample was taken, in
+    // which case we just drop the sample.
+    auto it = profiling_infos_.find(sample.method);
+    if (it != profiling_infos_.end()) {
+      AllocationSiteCache* cache = it->second->GetAllocationSiteCache(sample.dex_pc);
+      if (cache != nullptr) {
+        cache->AddSample(survived);
+      }
+    }
+    return true;
+  };
+  allocation_samples_.erase(
+      std::remove_if(allocation_samples_.begin(), allocation_samples_.end(), is_resolved),
+      allocation_samples_.end());
+}
+
+void JitCodeCache::AddAllocationSample(Thread* self,
+                                       ArtMethod* method,
+                                       uint32_t dex_pc,
+                                       ObjPtr<mirror::Object> object) {
+  if (!IsWeakAccessEnabled(self)) {
+    // The GC is sweeping the samples, drop this one rather than waiting.
+    return;
+  }
+  MutexLock mu(self, *Locks::jit_lock_);
+  if (allocation_samples_.size() >= kMaxAllocationSamples) {
+    return;
+  }
+  auto it = profiling_infos_.find(method);
+  if (it == profiling_infos_.end() || it->second->GetAllocationSiteCache(dex_pc) == nullptr) {
+    return;
+  }
+  allocation_samples_.push_back(
+      AllocationSample{GcRoot<mirror::Object>(object), method, dex_pc, /*survived_gcs=*/ 0u});
 }
 
 void JitCodeCache::FreeCodeAndData(const void* code_ptr) {
@@ -613,17 +676,22 @@ void JitCodeCache::DisallowInlineCacheAccess() {
 
 void JitCodeCache::CopyInlineCacheInto(
     const InlineCache& ic,
-    /*out*/StackHandleScope<InlineCache::kIndividualCacheSize>* classes) {
+    /*out*/StackHandleScope<InlineCache::kIndividualCacheSize>* classes,
+    /*out*/uint32_t* counts) {
   static_assert(arraysize(ic.classes_) == InlineCache::kIndividualCacheSize);
+  static_assert(arraysize(ic.counts_) == InlineCache::kIndividualCacheSize);
   DCHECK_EQ(classes->Capacity(), InlineCache::kIndividualCacheSize);
   DCHECK_EQ(classes->Size(), 0u);
   WaitUntilInlineCacheAccessible(Thread::Current());
   // Note that we don't need to lock `lock_` here, the compiler calling
   // this method has already ensured the inline cache will not be deleted.
-  for (const GcRoot<mirror::Class>& root : ic.classes_) {
-    mirror::Class* object = root.Read();
+  for (size_t i = 0; i < InlineCache::kIndividualCacheSize; ++i) {
+    mirror::Class* object = ic.classes_[i].Read();
     if (object != nullptr) {
       DCHECK_LT(classes->Size(), classes->Capacity());
+      if (counts != nullptr) {
+        counts[classes->Size()] = ic.counts_[i];
+      }
       classes->NewHandle(object);
     }
   }
@@ -696,12 +764,19 @@ bool JitCodeCache::Commit(Thread* self,
     switch (compilation_kind) {
       case CompilationKind::kOsr:
         number_of_osr_compilations_++;
+        osr_code_size_ += code.size();
         break;
       case CompilationKind::kBaseline:
         number_of_baseline_compilations_++;
+        baseline_code_size_ += code.size();
+        break;
+      case CompilationKind::kBaselinePlus:
+        number_of_baseline_plus_compilations_++;
+        baseline_plus_code_size_ += code.size();
         break;
       case CompilationKind::kOptimized:
         number_of_optimized_compilations_++;
+        optimized_code_size_ += code.size();
         break;
     }
 
@@ -1372,18 +1447,21 @@ OatQuickMethodHeader* JitCodeCache::LookupOsrMethodHeader(ArtMethod* method) {
 ProfilingInfo* JitCodeCache::AddProfilingInfo(Thread* self,
                                               ArtMethod* method,
                                               const std::vector<uint32_t>& inline_cache_entries,
-                                              const std::vector<uint32_t>& branch_cache_entries) {
+                                              const std::vector<uint32_t>& branch_cache_entries,
+                                              const std::vector<uint32_t>& allocation_site_entries) {
   DCHECK(CanAllocateProfilingInfo());
   ProfilingInfo* info = nullptr;
   {
     MutexLock mu(self, *Locks::jit_lock_);
-    info = AddProfilingInfoInternal(self, method, inline_cache_entries, branch_cache_entries);
+    info = AddProfilingInfoInternal(
+        self, method, inline_cache_entries, branch_cache_entries, allocation_site_entries);
   }
 
   if (info == nullptr) {
     GarbageCollectCache(self);
     MutexLock mu(self, *Locks::jit_lock_);
-    info = AddProfilingInfoInternal(self, method, inline_cache_entries, branch_cache_entries);
+    info = AddProfilingInfoInternal(
+        self, method, inline_cache_entries, branch_cache_entries, allocation_site_entries);
   }
   return info;
 }
@@ -1392,7 +1470,8 @@ ProfilingInfo* JitCodeCache::AddProfilingInfoInternal(
     Thread* self,
     ArtMethod* method,
     const std::vector<uint32_t>& inline_cache_entries,
-    const std::vector<uint32_t>& branch_cache_entries) {
+    const std::vector<uint32_t>& branch_cache_entries,
+    const std::vector<uint32_t>& allocation_site_entries) {
   ScopedDebugDisallowReadBarriers sddrb(self);
   // Check whether some other thread has concurrently created it.
   auto it = profiling_infos_.find(method);
@@ -1400,16 +1479,17 @@ ProfilingInfo* JitCodeCache::AddProfilingInfoInternal(
     return it->second;
   }
 
-  size_t profile_info_size =
-      ProfilingInfo::ComputeSize(inline_cache_entries.size(), branch_cache_entries.size());
+  size_t profile_info_size = ProfilingInfo::ComputeSize(inline_cache_entries.size(),
+                                                        branch_cache_entries.size(),
+                                                        allocation_site_entries.size());
 
   const uint8_t* data = private_region_.AllocateData(profile_info_size);
   if (data == nullptr) {
     return nullptr;
   }
   uint8_t* writable_data = private_region_.GetWritableDataAddress(data);
-  ProfilingInfo* info =
-      new (writable_data) ProfilingInfo(method, inline_cache_entries, branch_cache_entries);
+  ProfilingInfo* info = new (writable_data) ProfilingInfo(
+      method, inline_cache_entries, branch_cache_entries, allocation_site_entries);
 
   profiling_infos_.Put(method, info);
   histogram_profiling_info_memory_use_.AddValue(profile_info_size);
@@ -1527,8 +1607,14 @@ bool JitCodeCache::NotifyCompilationOf(ArtMethod* method,
   if (compilation_kind != CompilationKind::kOsr && ContainsPc(existing_entry_point)) {
     OatQuickMethodHeader* method_header =
         OatQuickMethodHeader::FromEntryPoint(existing_entry_point);
+    const uint8_t* code_info = method_header->GetOptimizedCodeInfoPtr();
     bool is_baseline = (compilation_kind == CompilationKind::kBaseline);
-    if (CodeInfo::IsBaseline(method_header->GetOptimizedCodeInfoPtr()) == is_baseline) {
+    bool is_baseline_plus = (compilation_kind == CompilationKind::kBaselinePlus);
+    bool already_compiled = is_baseline_plus
+        // Only move baseline code to the baseline-plus tier, never optimized code.
+        ? (!CodeInfo::IsBaseline(code_info) || CodeInfo::IsBaselinePlus(code_info))
+        : (CodeInfo::IsBaseline(code_info) == is_baseline);
+    if (already_compiled) {
       VLOG(jit) << "Not compiling "
                 << method->PrettyMethod()
                 << " because it has already been compiled"
@@ -1597,7 +1683,8 @@ bool JitCodeCache::NotifyCompilationOf(ArtMethod* method,
     }
     return new_compilation;
   } else {
-    if (compilation_kind == CompilationKind::kBaseline) {
+    if (compilation_kind == CompilationKind::kBaseline ||
+        compilation_kind == CompilationKind::kBaselinePlus) {
       DCHECK(CanAllocateProfilingInfo());
       bool has_profiling_info = false;
       {
@@ -1754,9 +1841,17 @@ void JitCodeCache::Dump(std::ostream& os) {
      << "Current number of JIT JNI stub entries: " << jni_stubs_map_.size() << "\n"
      << "Current number of JIT code cache entries: " << method_code_map_.size() << "\n"
      << "Total number of JIT baseline compilations: " << number_of_baseline_compilations_ << "\n"
+     << "Total number of JIT baseline-plus compilations: "
+        << number_of_baseline_plus_compilations_ << "\n"
      << "Total number of JIT optimized compilations: " << number_of_optimized_compilations_ << "\n"
      << "Total number of JIT compilations for on stack replacement: "
         << number_of_osr_compilations_ << "\n"
+     << "Total JIT code committed for baseline: " << PrettySize(baseline_code_size_) << "\n"
+     << "Total JIT code committed for baseline-plus: "
+        << PrettySize(baseline_plus_code_size_) << "\n"
+     << "Total JIT code committed for optimized: " << PrettySize(optimized_code_size_) << "\n"
+     << "Total JIT code committed for on stack replacement: "
+        << PrettySize(osr_code_size_) << "\n"
      << "Total number of JIT code cache collections: " << number_of_collections_ << std::endl;
   histogram_stack_map_memory_use_.PrintMemoryUse(os);
   histogram_code_memory_use_.PrintMemoryUse(os);
@@ -1815,8 +1910,13 @@ void JitCodeCache::PostForkChildAction(bool is_system_server, bool is_zygote) {
 
   // Reset all statistics to be specific to this process.
   number_of_baseline_compilations_ = 0;
+  number_of_baseline_plus_compilations_ = 0;
   number_of_optimized_compilations_ = 0;
   number_of_osr_compilations_ = 0;
+  baseline_code_size_ = 0;
+  baseline_plus_code_size_ = 0;
+  optimized_code_size_ = 0;
+  osr_code_size_ = 0;
   number_of_collections_ = 0;
   histogram_stack_map_memory_use_.Reset();
   histogram_code_memory_use_.Reset();
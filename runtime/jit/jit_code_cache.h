@@ -317,8 +317,11 @@ class JitCodeCache {
       REQUIRES(!Locks::jit_lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Copy the classes of `ic` into `classes`. If `counts` is not null, it receives the number
+  // of calls seen for each of the copied classes, in the same order.
   void CopyInlineCacheInto(const InlineCache& ic,
-                           /*out*/StackHandleScope<InlineCache::kIndividualCacheSize>* classes)
+                           /*out*/StackHandleScope<InlineCache::kIndividualCacheSize>* classes,
+                           /*out*/uint32_t* counts = nullptr)
       REQUIRES(!Locks::jit_lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
@@ -326,7 +329,18 @@ class JitCodeCache {
   ProfilingInfo* AddProfilingInfo(Thread* self,
                                   ArtMethod* method,
                                   const std::vector<uint32_t>& inline_cache_entries,
-                                  const std::vector<uint32_t>& branch_cache_entries)
+                                  const std::vector<uint32_t>& branch_cache_entries,
+                                  const std::vector<uint32_t>& allocation_site_entries)
+      REQUIRES(!Locks::jit_lock_)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
+  // Record that `object` was allocated by the instruction at `dex_pc` in `method`. The
+  // next GCs attribute the survival of `object` to the `AllocationSiteCache` of that
+  // instruction.
+  void AddAllocationSample(Thread* self,
+                           ArtMethod* method,
+                           uint32_t dex_pc,
+                           ObjPtr<mirror::Object> object)
       REQUIRES(!Locks::jit_lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
@@ -428,7 +442,14 @@ class JitCodeCache {
   ProfilingInfo* AddProfilingInfoInternal(Thread* self,
                                           ArtMethod* method,
                                           const std::vector<uint32_t>& inline_cache_entries,
-                                          const std::vector<uint32_t>& branch_cache_entries)
+                                          const std::vector<uint32_t>& branch_cache_entries,
+                                          const std::vector<uint32_t>& allocation_site_entries)
+      REQUIRES(Locks::jit_lock_)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
+  // Update the allocation samples after a GC, and report the fate of the samples
+  // that are resolved to their allocation site.
+  void SweepAllocationSamples(IsMarkedVisitor* visitor)
       REQUIRES(Locks::jit_lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
@@ -552,6 +573,18 @@ class JitCodeCache {
   // ProfilingInfo objects we have allocated.
   SafeMap<ArtMethod*, ProfilingInfo*> profiling_infos_ GUARDED_BY(Locks::jit_lock_);
 
+  // An object sampled at allocation time, and the allocation site it was allocated at.
+  // The object is a weak root: it is only swept, never visited.
+  struct AllocationSample {
+    GcRoot<mirror::Object> object;
+    ArtMethod* method;
+    uint32_t dex_pc;
+    uint32_t survived_gcs;
+  };
+
+  // Allocation samples whose survival is not known yet.
+  std::vector<AllocationSample> allocation_samples_ GUARDED_BY(Locks::jit_lock_);
+
   // Methods that the zygote has compiled and can be shared across processes
   // forked from the zygote.
   ZygoteMap zygote_map_;
@@ -575,12 +608,22 @@ class JitCodeCache {
   // Number of baseline compilations done throughout the lifetime of the JIT.
   size_t number_of_baseline_compilations_ GUARDED_BY(Locks::jit_lock_);
 
+  // Number of baseline-plus compilations done throughout the lifetime of the JIT.
+  size_t number_of_baseline_plus_compilations_ GUARDED_BY(Locks::jit_lock_);
+
   // Number of optimized compilations done throughout the lifetime of the JIT.
   size_t number_of_optimized_compilations_ GUARDED_BY(Locks::jit_lock_);
 
   // Number of compilations for on-stack-replacement done throughout the lifetime of the JIT.
   size_t number_of_osr_compilations_ GUARDED_BY(Locks::jit_lock_);
 
+  // Size of the code committed for each compilation kind throughout the lifetime of the JIT.
+  // Code that was later collected is still accounted for.
+  size_t baseline_code_size_ GUARDED_BY(Locks::jit_lock_);
+  size_t baseline_plus_code_size_ GUARDED_BY(Locks::jit_lock_);
+  size_t optimized_code_size_ GUARDED_BY(Locks::jit_lock_);
+  size_t osr_code_size_ GUARDED_BY(Locks::jit_lock_);
+
   // Number of code cache collections done throughout the lifetime of the JIT.
   size_t number_of_collections_ GUARDED_BY(Locks::jit_lock_);
 
@@ -0,0 +1,130 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "jit/jit_code_cache.h"
+
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "art_method-inl.h"
+#include "class_linker-inl.h"
+#include "class_root-inl.h"
+#include "common_runtime_test.h"
+#include "gc/heap.h"
+#include "handle_scope-inl.h"
+#include "jit/profiling_info.h"
+#include "mirror/class-alloc-inl.h"
+#include "mirror/object-inl.h"
+#include "object_callbacks.h"
+#include "scoped_thread_state_change-inl.h"
+
+namespace art {
+namespace jit {
+
+class JitCodeCacheTest : public CommonRuntimeTest {};
+
+// Treats the objects in `marked` as live and all other objects as dead.
+class FakeIsMarkedVisitor : public IsMarkedVisitor {
+ public:
+  explicit FakeIsMarkedVisitor(const std::set<mirror::Object*>& marked) : marked_(marked) {}
+
+  mirror::Object* IsMarked(mirror::Object* obj) override {
+    return (marked_.find(obj) != marked_.end()) ? obj : nullptr;
+  }
+
+ private:
+  const std::set<mirror::Object*>& marked_;
+};
+
+TEST_F(JitCodeCacheTest, AllocationSamplesDecidePretenuring) {
+  static constexpr uint32_t kLongLivedDexPc = 3u;
+  static constexpr uint32_t kShortLivedDexPc = 7u;
+  static constexpr uint32_t kUnknownDexPc = 11u;
+  static constexpr size_t kSamples = AllocationSiteCache::kMinSamplesForPretenuring;
+
+  std::string error_msg;
+  std::unique_ptr<JitCodeCache> code_cache(
+      JitCodeCache::Create(/*used_only_for_profile_data=*/ true,
+                           /*rwx_memory_allowed=*/ false,
+                           /*is_zygote=*/ false,
+                           &error_msg));
+  ASSERT_TRUE(code_cache != nullptr) << error_msg;
+
+  ScopedObjectAccess soa(Thread::Current());
+  Thread* self = soa.Self();
+  StackHandleScope<1> hs(self);
+  Handle<mirror::Class> object_class = hs.NewHandle(GetClassRoot<mirror::Object>());
+  ArtMethod* method = object_class->FindClassMethod(
+      "toString", "()Ljava/lang/String;", kRuntimePointerSize);
+  ASSERT_TRUE(method != nullptr);
+  ProfilingInfo* info = code_cache->AddProfilingInfo(self,
+                                                     method,
+                                                     /*inline_cache_entries=*/ {},
+                                                     /*branch_cache_entries=*/ {},
+                                                     {kLongLivedDexPc, kShortLivedDexPc});
+  ASSERT_TRUE(info != nullptr);
+  AllocationSiteCache* long_lived = info->GetAllocationSiteCache(kLongLivedDexPc);
+  AllocationSiteCache* short_lived = info->GetAllocationSiteCache(kShortLivedDexPc);
+  ASSERT_TRUE(long_lived != nullptr);
+  ASSERT_TRUE(short_lived != nullptr);
+
+  // Objects of the long-lived site are marked, objects of the short-lived site are not.
+  // Allocate them all first so that no GC moves them once we record their addresses.
+  VariableSizedHandleScope objects(self);
+  std::vector<Handle<mirror::Object>> survivors;
+  std::vector<Handle<mirror::Object>> dead;
+  for (size_t i = 0; i != kSamples; ++i) {
+    survivors.push_back(objects.NewHandle(object_class->AllocObject(self)));
+    dead.push_back(objects.NewHandle(object_class->AllocObject(self)));
+    ASSERT_TRUE(survivors.back() != nullptr);
+    ASSERT_TRUE(dead.back() != nullptr);
+  }
+  std::set<mirror::Object*> marked;
+  for (size_t i = 0; i != kSamples; ++i) {
+    marked.insert(survivors[i].Get());
+    code_cache->AddAllocationSample(self, method, kLongLivedDexPc, survivors[i].Get());
+    code_cache->AddAllocationSample(self, method, kShortLivedDexPc, dead[i].Get());
+    // Samples of instructions without an allocation site cache are dropped.
+    code_cache->AddAllocationSample(self, method, kUnknownDexPc, survivors[i].Get());
+  }
+
+  FakeIsMarkedVisitor visitor(marked);
+  // Deaths are known after the first GC, survival only after the second one.
+  code_cache->SweepRootTables(&visitor);
+  EXPECT_EQ(0u, long_lived->GetSurvivors());
+  EXPECT_EQ(0u, long_lived->GetDeaths());
+  EXPECT_FALSE(long_lived->ShouldPretenure());
+  EXPECT_EQ(0u, short_lived->GetSurvivors());
+  EXPECT_EQ(kSamples, short_lived->GetDeaths());
+  EXPECT_FALSE(short_lived->ShouldPretenure());
+
+  code_cache->SweepRootTables(&visitor);
+  EXPECT_EQ(kSamples, long_lived->GetSurvivors());
+  EXPECT_EQ(0u, long_lived->GetDeaths());
+  EXPECT_TRUE(long_lived->ShouldPretenure());
+  EXPECT_FALSE(short_lived->ShouldPretenure());
+
+  // While the non-moving space is mostly empty, pretenured objects go to the non-moving space.
+  gc::Heap* heap = Runtime::Current()->GetHeap();
+  EXPECT_EQ(heap->GetCurrentNonMovingAllocator(), heap->GetPretenureAllocator());
+}
+
+}  // namespace jit
+}  // namespace art
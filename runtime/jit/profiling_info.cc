@@ -27,11 +27,13 @@ namespace art {
 
 ProfilingInfo::ProfilingInfo(ArtMethod* method,
                              const std::vector<uint32_t>& inline_cache_entries,
-                             const std::vector<uint32_t>& branch_cache_entries)
+                             const std::vector<uint32_t>& branch_cache_entries,
+                             const std::vector<uint32_t>& allocation_site_entries)
       : baseline_hotness_count_(GetOptimizeThreshold()),
         method_(method),
         number_of_inline_caches_(inline_cache_entries.size()),
         number_of_branch_caches_(branch_cache_entries.size()),
+        number_of_allocation_sites_(allocation_site_entries.size()),
         current_inline_uses_(0) {
   InlineCache* inline_caches = GetInlineCaches();
   memset(inline_caches, 0, number_of_inline_caches_ * sizeof(InlineCache));
@@ -44,6 +46,12 @@ ProfilingInfo::ProfilingInfo(ArtMethod* method,
   for (size_t i = 0; i < number_of_branch_caches_; ++i) {
     branch_caches[i].dex_pc_ = branch_cache_entries[i];
   }
+
+  AllocationSiteCache* allocation_sites = GetAllocationSiteCaches();
+  memset(allocation_sites, 0, number_of_allocation_sites_ * sizeof(AllocationSiteCache));
+  for (size_t i = 0; i < number_of_allocation_sites_; ++i) {
+    allocation_sites[i].dex_pc_ = allocation_site_entries[i];
+  }
 }
 
 uint16_t ProfilingInfo::GetOptimizeThreshold() {
@@ -57,6 +65,7 @@ ProfilingInfo* ProfilingInfo::Create(Thread* self, ArtMethod* method) {
 
   std::vector<uint32_t> inline_cache_entries;
   std::vector<uint32_t> branch_cache_entries;
+  std::vector<uint32_t> allocation_site_entries;
   for (const DexInstructionPcPair& inst : method->DexInstructions()) {
     switch (inst->Opcode()) {
       case Instruction::INVOKE_VIRTUAL:
@@ -81,6 +90,13 @@ ProfilingInfo* ProfilingInfo::Create(Thread* self, ArtMethod* method) {
         branch_cache_entries.push_back(inst.DexPc());
         break;
 
+      case Instruction::NEW_INSTANCE:
+      case Instruction::NEW_ARRAY:
+      case Instruction::FILLED_NEW_ARRAY:
+      case Instruction::FILLED_NEW_ARRAY_RANGE:
+        allocation_site_entries.push_back(inst.DexPc());
+        break;
+
       default:
         break;
     }
@@ -91,7 +107,8 @@ ProfilingInfo* ProfilingInfo::Create(Thread* self, ArtMethod* method) {
 
   // Allocate the `ProfilingInfo` object int the JIT's data space.
   jit::JitCodeCache* code_cache = Runtime::Current()->GetJit()->GetCodeCache();
-  return code_cache->AddProfilingInfo(self, method, inline_cache_entries, branch_cache_entries);
+  return code_cache->AddProfilingInfo(
+      self, method, inline_cache_entries, branch_cache_entries, allocation_site_entries);
 }
 
 InlineCache* ProfilingInfo::GetInlineCache(uint32_t dex_pc) {
@@ -120,13 +137,27 @@ BranchCache* ProfilingInfo::GetBranchCache(uint32_t dex_pc) {
   return nullptr;
 }
 
+AllocationSiteCache* ProfilingInfo::GetAllocationSiteCache(uint32_t dex_pc) {
+  // TODO: binary search if array is too long.
+  AllocationSiteCache* caches = GetAllocationSiteCaches();
+  for (size_t i = 0; i < number_of_allocation_sites_; ++i) {
+    if (caches[i].dex_pc_ == dex_pc) {
+      return &caches[i];
+    }
+  }
+  // The runtime may sample allocations done on behalf of other instructions,
+  // for example reflection or string allocations.
+  return nullptr;
+}
+
 void ProfilingInfo::AddInvokeInfo(uint32_t dex_pc, mirror::Class* cls) {
   InlineCache* cache = GetInlineCache(dex_pc);
   for (size_t i = 0; i < InlineCache::kIndividualCacheSize; ++i) {
     mirror::Class* existing = cache->classes_[i].Read<kWithoutReadBarrier>();
     mirror::Class* marked = ReadBarrier::IsMarked(existing);
     if (marked == cls) {
-      // Receiver type is already in the cache, nothing else to do.
+      // Receiver type is already in the cache, just count the call.
+      ++cache->counts_[i];
       return;
     } else if (marked == nullptr) {
       // Cache entry is empty, try to put `cls` in it.
@@ -141,13 +172,16 @@ void ProfilingInfo::AddInvokeInfo(uint32_t dex_pc, mirror::Class* cls) {
         // entry in case the entry contains `cls`.
         --i;
       } else {
-        // We successfully set `cls`, just return.
+        // We successfully set `cls`, count the call and return.
+        ++cache->counts_[i];
         return;
       }
     }
   }
   // Unsuccessfull - cache is full, making it megamorphic. We do not DCHECK it though,
-  // as the garbage collector might clear the entries concurrently.
+  // as the garbage collector might clear the entries concurrently. Count the call with
+  // the other receivers that did not fit in the cache.
+  ++cache->counts_[InlineCache::kIndividualCacheSize - 1];
 }
 
 ScopedProfilingInfoUse::ScopedProfilingInfoUse(jit::Jit* jit, ArtMethod* method, Thread* self)
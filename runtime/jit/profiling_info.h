@@ -41,6 +41,8 @@ class Class;
 
 // Structure to store the classes seen at runtime for a specific instruction.
 // Once the classes_ array is full, we consider the INVOKE to be megamorphic.
+// The last entry of a megamorphic cache holds the latest receiver that did not
+// match the other entries, and its count is the number of such calls.
 class InlineCache {
  public:
   // This is hard coded in the assembly stub art_quick_update_inline_cache.
@@ -50,9 +52,18 @@ class InlineCache {
     return MemberOffset(OFFSETOF_MEMBER(InlineCache, classes_));
   }
 
+  // The counts are updated by baseline compiled code and the assembly stub
+  // art_quick_update_inline_cache, which expect them to follow the classes.
+  static constexpr MemberOffset CountsOffset() {
+    return MemberOffset(OFFSETOF_MEMBER(InlineCache, counts_));
+  }
+
  private:
   uint32_t dex_pc_;
   GcRoot<mirror::Class> classes_[kIndividualCacheSize];
+  // Number of calls seen with the receiver class in the corresponding `classes_` entry. The
+  // updates are not atomic, so the counts are only an approximation.
+  uint32_t counts_[kIndividualCacheSize];
 
   friend class jit::JitCodeCache;
   friend class ProfilingInfo;
@@ -92,6 +103,52 @@ class BranchCache {
   DISALLOW_COPY_AND_ASSIGN(BranchCache);
 };
 
+// Structure to store the survival of objects sampled at runtime for a specific
+// allocation instruction. Updated by the JIT code cache with the JIT lock held.
+class AllocationSiteCache {
+ public:
+  // Number of sampled objects whose fate must be known before we decide to pretenure.
+  static constexpr uint32_t kMinSamplesForPretenuring = 8;
+  // Percentage of sampled objects that must have survived for the site to be pretenured.
+  static constexpr uint32_t kPretenureSurvivalPercent = 90;
+
+  uint16_t GetSurvivors() const {
+    return survivors_;
+  }
+
+  uint16_t GetDeaths() const {
+    return deaths_;
+  }
+
+  // Whether objects allocated at this site are long-lived enough to be directly
+  // allocated in the non-moving space.
+  bool ShouldPretenure() const {
+    uint32_t samples = static_cast<uint32_t>(survivors_) + deaths_;
+    return samples >= kMinSamplesForPretenuring &&
+        survivors_ * 100u >= samples * kPretenureSurvivalPercent;
+  }
+
+ private:
+  void AddSample(bool survived) {
+    uint16_t& counter = survived ? survivors_ : deaths_;
+    if (counter == std::numeric_limits<uint16_t>::max()) {
+      // Decay both counters, keeping the ratio but letting recent samples weigh more.
+      survivors_ /= 2;
+      deaths_ /= 2;
+    }
+    ++counter;
+  }
+
+  uint32_t dex_pc_;
+  uint16_t survivors_;
+  uint16_t deaths_;
+
+  friend class jit::JitCodeCache;
+  friend class ProfilingInfo;
+
+  DISALLOW_COPY_AND_ASSIGN(AllocationSiteCache);
+};
+
 /**
  * Profiling info for a method, created and filled by the interpreter once the
  * method is warm, and used by the compiler to drive optimizations.
@@ -115,6 +172,7 @@ class ProfilingInfo {
 
   InlineCache* GetInlineCache(uint32_t dex_pc);
   BranchCache* GetBranchCache(uint32_t dex_pc);
+  AllocationSiteCache* GetAllocationSiteCache(uint32_t dex_pc);
 
   InlineCache* GetInlineCaches() {
     return reinterpret_cast<InlineCache*>(
@@ -125,11 +183,19 @@ class ProfilingInfo {
         reinterpret_cast<uintptr_t>(this) + sizeof(ProfilingInfo) +
         number_of_inline_caches_ * sizeof(InlineCache));
   }
+  AllocationSiteCache* GetAllocationSiteCaches() {
+    return reinterpret_cast<AllocationSiteCache*>(
+        reinterpret_cast<uintptr_t>(GetBranchCaches()) +
+        number_of_branch_caches_ * sizeof(BranchCache));
+  }
 
-  static size_t ComputeSize(uint32_t number_of_inline_caches, uint32_t number_of_branch_caches) {
+  static size_t ComputeSize(uint32_t number_of_inline_caches,
+                            uint32_t number_of_branch_caches,
+                            uint32_t number_of_allocation_sites) {
     return sizeof(ProfilingInfo) +
         number_of_inline_caches * sizeof(InlineCache) +
-        number_of_branch_caches * sizeof(BranchCache);
+        number_of_branch_caches * sizeof(BranchCache) +
+        number_of_allocation_sites * sizeof(AllocationSiteCache);
   }
 
   // Increments the number of times this method is currently being inlined.
@@ -173,7 +239,8 @@ class ProfilingInfo {
  private:
   ProfilingInfo(ArtMethod* method,
                 const std::vector<uint32_t>& inline_cache_entries,
-                const std::vector<uint32_t>& branch_cache_entries);
+                const std::vector<uint32_t>& branch_cache_entries,
+                const std::vector<uint32_t>& allocation_site_entries);
 
   // Hotness count for methods compiled with the JIT baseline compiler. Once
   // a threshold is hit (currentily the maximum value of uint16_t), we will
@@ -191,6 +258,9 @@ class ProfilingInfo {
   // Number of branches we are profiling in the ArtMethod.
   const uint32_t number_of_branch_caches_;
 
+  // Number of allocation instructions we are sampling in the ArtMethod.
+  const uint32_t number_of_allocation_sites_;
+
   // When the compiler inlines the method associated to this ProfilingInfo,
   // it updates this counter so that the GC does not try to clear the inline caches.
   uint16_t current_inline_uses_;
@@ -198,6 +268,7 @@ class ProfilingInfo {
   // Memory following the object:
   // - Dynamically allocated array of `InlineCache` of size `number_of_inline_caches_`.
   // - Dynamically allocated array of `BranchCache of size `number_of_branch_caches_`.
+  // - Dynamically allocated array of `AllocationSiteCache` of size `number_of_allocation_sites_`.
   friend class jit::JitCodeCache;
 
   DISALLOW_COPY_AND_ASSIGN(ProfilingInfo);
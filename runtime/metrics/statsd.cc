@@ -195,6 +195,18 @@ constexpr std::optional<int32_t> EncodeDatumId(DatumId datum_id) {
     case DatumId::kTimeElapsedDelta:
       return std::make_optional(
           statsd::ART_DATUM_DELTA_REPORTED__KIND__ART_DATUM_DELTA_TIME_ELAPSED_MS);
+    // The adaptive heap ergonomics decisions have no atom yet.
+    case DatumId::kGcAdaptiveTargetUtilizationAvg:
+    case DatumId::kGcAdaptiveTargetFootprintAvg:
+    case DatumId::kGcAdaptiveConcurrentStartBytesAvg:
+      return std::nullopt;
+    // Neither has the finalizer backlog.
+    case DatumId::kFinalizerReferencesEnqueued:
+    case DatumId::kReferenceQueueHandoffDelayUsAvg:
+      return std::nullopt;
+    // Nor the JIT compilations that ran out of budget.
+    case DatumId::kJitMethodCompileOverBudgetCount:
+      return std::nullopt;
   }
 }
 
@@ -434,6 +434,10 @@ bool OatHeader::RequiresImage() const {
   return IsKeyEnabled(OatHeader::kRequiresImage);
 }
 
+bool OatHeader::AssumesClosedClassHierarchy() const {
+  return IsKeyEnabled(OatHeader::kAssumeClosedClassHierarchyKey);
+}
+
 CompilerFilter::Filter OatHeader::GetCompilerFilter() const {
   CompilerFilter::Filter filter;
   const char* key_value = GetStoreValueByKey(kCompilerFilter);
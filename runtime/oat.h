@@ -44,8 +44,8 @@ std::ostream& operator<<(std::ostream& stream, StubType stub_type);
 class PACKED(4) OatHeader {
  public:
   static constexpr std::array<uint8_t, 4> kOatMagic { { 'o', 'a', 't', '\n' } };
-  // Last oat version changed reason: Refactor OatQuickMethodHeader for assembly stubs.
-  static constexpr std::array<uint8_t, 4> kOatVersion{{'2', '3', '9', '\0'}};
+  // Last oat version changed reason: Record CHA assumptions of AOT code in CodeInfo.
+  static constexpr std::array<uint8_t, 4> kOatVersion{{'2', '4', '1', '\0'}};
 
   static constexpr const char* kDex2OatCmdLineKey = "dex2oat-cmdline";
   static constexpr const char* kDebuggableKey = "debuggable";
@@ -58,6 +58,7 @@ class PACKED(4) OatHeader {
   static constexpr const char* kConcurrentCopying = "concurrent-copying";
   static constexpr const char* kCompilationReasonKey = "compilation-reason";
   static constexpr const char* kRequiresImage = "requires-image";
+  static constexpr const char* kAssumeClosedClassHierarchyKey = "assume-closed-class-hierarchy";
 
   static constexpr const char kTrueValue[] = "true";
   static constexpr const char kFalseValue[] = "false";
@@ -122,6 +123,7 @@ class PACKED(4) OatHeader {
   CompilerFilter::Filter GetCompilerFilter() const;
   bool IsConcurrentCopying() const;
   bool RequiresImage() const;
+  bool AssumesClosedClassHierarchy() const;
 
   const uint8_t* GetOatAddress(StubType type) const;
 
@@ -253,7 +253,8 @@ std::unique_ptr<OatFileAssistant> OatFileAssistant::Create(
 
     if (!tmp_context->OpenDexFiles(android::base::Dirname(filename),
                                    /*context_fds=*/{},
-                                   /*only_read_checksums=*/true)) {
+                                   /*only_read_checksums=*/true,
+                                   ofa_context)) {
       *error_msg =
           StringPrintf("Failed to load class loader context files for '%s' with context '%s'",
                        filename.c_str(),
@@ -721,11 +722,19 @@ bool OatFileAssistant::GetRequiredDexChecksum(std::optional<uint32_t>* checksum,
     required_dex_checksums_attempted_ = true;
 
     File file(zip_fd_, /*check_usage=*/false);
-    ArtDexFileLoader dex_loader(&file, dex_location_);
     std::optional<uint32_t> checksum2;
     std::string error2;
-    if (dex_loader.GetMultiDexChecksum(
-            &checksum2, &error2, &zip_file_only_contains_uncompressed_dex_)) {
+    bool ok;
+    if (std::holds_alternative<OatFileAssistantContext*>(ofa_context_)) {
+      // The context is shared with other OatFileAssistant instances, use its checksum cache.
+      ok = GetOatFileAssistantContext()->GetMultiDexChecksum(
+          dex_location_, &file, &checksum2, &error2, &zip_file_only_contains_uncompressed_dex_);
+    } else {
+      ArtDexFileLoader dex_loader(&file, dex_location_);
+      ok = dex_loader.GetMultiDexChecksum(
+          &checksum2, &error2, &zip_file_only_contains_uncompressed_dex_);
+    }
+    if (ok) {
       cached_required_dex_checksums_ = checksum2;
       cached_required_dex_checksums_error_ = std::nullopt;
     } else {
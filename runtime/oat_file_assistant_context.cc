@@ -16,6 +16,9 @@
 
 #include "oat_file_assistant_context.h"
 
+#include <sys/stat.h>
+
+#include <algorithm>
 #include <memory>
 #include <optional>
 #include <string>
@@ -32,6 +35,9 @@
 #include "dex/art_dex_file_loader.h"
 #include "gc/heap.h"
 #include "gc/space/image_space.h"
+#include "thread-current-inl.h"
+#include "thread.h"
+#include "thread_pool.h"
 
 namespace art {
 
@@ -184,4 +190,113 @@ const std::string& OatFileAssistantContext::GetApexVersions() {
   return apex_versions_.value();
 }
 
+bool OatFileAssistantContext::DexChecksumInfo::Matches(const struct stat& st) const {
+  return dev == st.st_dev &&
+         ino == st.st_ino &&
+         size == st.st_size &&
+         mtime.tv_sec == st.st_mtim.tv_sec &&
+         mtime.tv_nsec == st.st_mtim.tv_nsec;
+}
+
+bool OatFileAssistantContext::LookupDexChecksum(const std::string& location,
+                                                const struct stat& st,
+                                                /*out*/ std::optional<uint32_t>* checksum,
+                                                /*out*/ bool* only_contains_uncompressed_dex) {
+  MutexLock mu(Thread::Current(), dex_checksums_lock_);
+  auto it = dex_checksums_.find(location);
+  if (it == dex_checksums_.end() || !it->second.Matches(st)) {
+    return false;
+  }
+  *checksum = it->second.checksum;
+  if (only_contains_uncompressed_dex != nullptr) {
+    *only_contains_uncompressed_dex = it->second.only_contains_uncompressed_dex;
+  }
+  return true;
+}
+
+bool OatFileAssistantContext::GetMultiDexChecksum(const std::string& location,
+                                                  File* file,
+                                                  /*out*/ std::optional<uint32_t>* checksum,
+                                                  /*out*/ std::string* error_msg,
+                                                  /*out*/ bool* only_contains_uncompressed_dex) {
+  auto stat_file = [&](struct stat* st) {
+    return (file->IsValid() ? fstat(file->Fd(), st) : stat(location.c_str(), st)) == 0;
+  };
+
+  struct stat st_before;
+  bool has_stat = stat_file(&st_before);
+  if (has_stat &&
+      LookupDexChecksum(location, st_before, checksum, only_contains_uncompressed_dex)) {
+    return true;
+  }
+
+  bool only_uncompressed = false;
+  ArtDexFileLoader dex_loader(file, location);
+  if (!dex_loader.GetMultiDexChecksum(checksum, error_msg, &only_uncompressed)) {
+    return false;
+  }
+  if (only_contains_uncompressed_dex != nullptr) {
+    *only_contains_uncompressed_dex = only_uncompressed;
+  }
+
+  // Only cache the result if the file did not change while we were reading it.
+  struct stat st_after;
+  if (has_stat && stat_file(&st_after) && st_after.st_size == st_before.st_size &&
+      st_after.st_mtim.tv_sec == st_before.st_mtim.tv_sec &&
+      st_after.st_mtim.tv_nsec == st_before.st_mtim.tv_nsec) {
+    MutexLock mu(Thread::Current(), dex_checksums_lock_);
+    dex_checksums_.insert_or_assign(location,
+                                    DexChecksumInfo{.dev = st_before.st_dev,
+                                                    .ino = st_before.st_ino,
+                                                    .size = st_before.st_size,
+                                                    .mtime = st_before.st_mtim,
+                                                    .checksum = *checksum,
+                                                    .only_contains_uncompressed_dex =
+                                                        only_uncompressed});
+  }
+  return true;
+}
+
+void OatFileAssistantContext::PrefetchMultiDexChecksums(
+    const std::vector<std::string>& locations) {
+  // The runtime thread pool needs a runtime and an attached thread. A runnable thread must not
+  // block GCs while waiting for file I/O. In these cases the checksums are computed one by one
+  // by the subsequent `GetMultiDexChecksum` calls.
+  Thread* self = Thread::Current();
+  if (Runtime::Current() == nullptr ||
+      self == nullptr ||
+      self->GetState() == ThreadState::kRunnable) {
+    return;
+  }
+
+  std::vector<const std::string*> missing;
+  for (const std::string& location : locations) {
+    struct stat st;
+    std::optional<uint32_t> checksum;
+    if (stat(location.c_str(), &st) != 0 ||
+        !LookupDexChecksum(location, st, &checksum, /*only_contains_uncompressed_dex=*/nullptr)) {
+      missing.push_back(&location);
+    }
+  }
+  if (missing.size() <= 1u) {
+    // Not worth using the thread pool, the caller computes the checksum anyway.
+    return;
+  }
+
+  Runtime::ScopedThreadPoolUsage stpu;
+  ThreadPool* const pool = stpu.GetThreadPool();
+  if (pool == nullptr) {
+    return;
+  }
+  for (const std::string* location : missing) {
+    pool->AddTask(self, new FunctionTask([this, location](Thread*) {
+      File no_file;
+      std::optional<uint32_t> checksum;
+      std::string error_msg;
+      GetMultiDexChecksum(*location, &no_file, &checksum, &error_msg);
+    }));
+  }
+  pool->Wait(self, /*do_work=*/ true, /*may_hold_locks=*/ false);
+}
+
 }  // namespace art
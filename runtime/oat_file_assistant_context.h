@@ -17,12 +17,16 @@
 #ifndef ART_RUNTIME_OAT_FILE_ASSISTANT_CONTEXT_H_
 #define ART_RUNTIME_OAT_FILE_ASSISTANT_CONTEXT_H_
 
+#include <sys/stat.h>
+
 #include <optional>
 #include <string>
 #include <unordered_map>
 #include <vector>
 
 #include "arch/instruction_set.h"
+#include "base/macros.h"
+#include "base/mutex.h"
 #include "runtime.h"
 
 namespace art {
@@ -30,7 +34,8 @@ namespace art {
 // A helper class for OatFileAssistant that fetches and caches information including boot image
 // checksums, bootclasspath checksums, and APEX versions. The same instance can be reused across
 // OatFileAssistant calls on different dex files for different instruction sets.
-// This class is not thread-safe until `FetchAll` is called.
+// This class is not thread-safe until `FetchAll` is called, except for the dex checksum cache,
+// which is always thread-safe.
 class OatFileAssistantContext {
  public:
   // Options that a runtime would take.
@@ -76,12 +81,50 @@ class OatFileAssistantContext {
   // Returns a string that represents the apex versions of boot classpath jars. See
   // `Runtime::apex_versions_` for the encoding format.
   const std::string& GetApexVersions();
+  // Returns the multidex checksum of the dex file or zip at `location`, like
+  // `ArtDexFileLoader::GetMultiDexChecksum`. `file` is used if valid, otherwise `location` is
+  // opened. Results are cached and reused while the file's identity, size and modification time
+  // are unchanged, so class path elements shared by many apps are only read once.
+  bool GetMultiDexChecksum(const std::string& location,
+                           File* file,
+                           /*out*/ std::optional<uint32_t>* checksum,
+                           /*out*/ std::string* error_msg,
+                           /*out*/ bool* only_contains_uncompressed_dex = nullptr)
+      REQUIRES(!dex_checksums_lock_);
+  // Computes and caches the multidex checksums of the given locations that are not cached yet,
+  // on the runtime thread pool if there is more than one. Does nothing without a runtime or
+  // when called from a runnable thread. Errors are ignored here and reported by the subsequent
+  // `GetMultiDexChecksum` calls.
+  void PrefetchMultiDexChecksums(const std::vector<std::string>& locations)
+      REQUIRES(!dex_checksums_lock_);
 
  private:
+  // A cached multidex checksum and the file state it was computed from.
+  struct DexChecksumInfo {
+    dev_t dev;
+    ino_t ino;
+    off_t size;
+    timespec mtime;
+    std::optional<uint32_t> checksum;
+    bool only_contains_uncompressed_dex;
+
+    bool Matches(const struct stat& st) const;
+  };
+
+  // Returns the cached checksum of `location` if `st` shows that the file did not change.
+  bool LookupDexChecksum(const std::string& location,
+                         const struct stat& st,
+                         /*out*/ std::optional<uint32_t>* checksum,
+                         /*out*/ bool* only_contains_uncompressed_dex)
+      REQUIRES(!dex_checksums_lock_);
+
   std::unique_ptr<RuntimeOptions> runtime_options_;
   std::unordered_map<InstructionSet, std::vector<BootImageInfo>> boot_image_info_list_by_isa_;
   std::unordered_map<size_t, std::vector<std::string>> bcp_checksums_by_index_;
   std::optional<std::string> apex_versions_;
+
+  Mutex dex_checksums_lock_{"OatFileAssistantContext dex checksums lock", kGenericBottomLock};
+  std::unordered_map<std::string, DexChecksumInfo> dex_checksums_ GUARDED_BY(dex_checksums_lock_);
 };
 
 }  // namespace art
@@ -19,6 +19,7 @@
 #include <fcntl.h>
 #include <gtest/gtest.h>
 #include <sys/param.h>
+#include <sys/stat.h>
 
 #include <functional>
 #include <iterator>
@@ -28,6 +29,7 @@
 #include <type_traits>
 #include <vector>
 
+#include "android-base/file.h"
 #include "android-base/scopeguard.h"
 #include "android-base/strings.h"
 #include "arch/instruction_set.h"
@@ -37,6 +39,7 @@
 #include "class_linker.h"
 #include "class_loader_context.h"
 #include "common_runtime_test.h"
+#include "dex/art_dex_file_loader.h"
 #include "dexopt_test.h"
 #include "oat.h"
 #include "oat_file.h"
@@ -2619,6 +2622,72 @@ TEST_P(OatFileAssistantTest, ValidateBootClassPathChecksums) {
   }
 }
 
+// Case: We read multidex checksums through a shared OatFileAssistantContext.
+// Expect: The cached checksum is used until the file changes.
+TEST_P(OatFileAssistantTest, MultiDexChecksumCache) {
+  std::string dex_location = GetScratchDir() + "/ChecksumCache.jar";
+  std::string other_location = GetScratchDir() + "/ChecksumCacheOther.jar";
+  Copy(GetDexSrc1(), dex_location);
+  Copy(GetMultiDexSrc1(), other_location);
+
+  auto scoped_maybe_without_runtime = ScopedMaybeWithoutRuntime();
+
+  auto read_checksum = [](const std::string& location) {
+    File no_file;
+    ArtDexFileLoader dex_loader(&no_file, location);
+    std::optional<uint32_t> checksum;
+    std::string error_msg;
+    EXPECT_TRUE(dex_loader.GetMultiDexChecksum(&checksum, &error_msg)) << error_msg;
+    return checksum;
+  };
+  auto cached_checksum = [&](const std::string& location) {
+    File no_file;
+    std::optional<uint32_t> checksum;
+    std::string error_msg;
+    EXPECT_TRUE(ofa_context_->GetMultiDexChecksum(location, &no_file, &checksum, &error_msg))
+        << error_msg;
+    return checksum;
+  };
+
+  ofa_context_->PrefetchMultiDexChecksums({dex_location, other_location});
+  EXPECT_EQ(read_checksum(dex_location), cached_checksum(dex_location));
+  EXPECT_EQ(read_checksum(other_location), cached_checksum(other_location));
+
+  std::optional<uint32_t> old_checksum = read_checksum(dex_location);
+
+  // Overwrite the file in place with garbage of the same size, and restore its modification
+  // time. The second lookup must be served from the cache, as reading the file would fail.
+  struct stat st;
+  ASSERT_EQ(0, stat(dex_location.c_str(), &st));
+  ASSERT_TRUE(android::base::WriteStringToFile(
+      std::string(st.st_size, '\0'), dex_location, /*follow_symlinks=*/ true));
+  struct timespec times[2] = {st.st_atim, st.st_mtim};
+  ASSERT_EQ(0, utimensat(AT_FDCWD, dex_location.c_str(), times, /*flags=*/ 0));
+  EXPECT_EQ(old_checksum, cached_checksum(dex_location));
+
+  // Changing the modification time invalidates the cached checksum, so the garbage is read.
+  times[1].tv_sec += 1;
+  ASSERT_EQ(0, utimensat(AT_FDCWD, dex_location.c_str(), times, /*flags=*/ 0));
+  {
+    File no_file;
+    std::optional<uint32_t> checksum;
+    std::string error_msg;
+    EXPECT_FALSE(ofa_context_->GetMultiDexChecksum(dex_location, &no_file, &checksum, &error_msg));
+  }
+
+  // Replacing the file invalidates the cached checksum.
+  Copy(GetDexSrc2(), dex_location);
+  EXPECT_EQ(read_checksum(dex_location), cached_checksum(dex_location));
+  EXPECT_NE(old_checksum, cached_checksum(dex_location));
+
+  // A missing file is an error.
+  File no_file;
+  std::optional<uint32_t> checksum;
+  std::string error_msg;
+  EXPECT_FALSE(ofa_context_->GetMultiDexChecksum(
+      GetScratchDir() + "/Missing.jar", &no_file, &checksum, &error_msg));
+}
+
 // TODO: More Tests:
 //  * Test class linker falls back to unquickened dex for DexNoOat
 //  * Test class linker falls back to unquickened dex for MultiDexNoOat
@@ -19,6 +19,7 @@
 #include <stdlib.h>
 #include <sys/stat.h>
 
+#include <atomic>
 #include <memory>
 #include <queue>
 #include <vector>
@@ -28,9 +29,11 @@
 #include "android-base/strings.h"
 #include "art_field-inl.h"
 #include "base/bit_vector-inl.h"
+#include "base/casts.h"
 #include "base/file_utils.h"
 #include "base/logging.h"  // For VLOG.
 #include "base/mutex-inl.h"
+#include "base/scoped_flock.h"
 #include "base/sdk_version.h"
 #include "base/stl_util.h"
 #include "base/systrace.h"
@@ -51,6 +54,7 @@
 #include "oat_file.h"
 #include "oat_file_assistant.h"
 #include "obj_ptr-inl.h"
+#include "profile/profile_compilation_info.h"
 #include "runtime_image.h"
 #include "scoped_thread_state_change-inl.h"
 #include "thread-current-inl.h"
@@ -862,16 +866,208 @@ void OatFileManager::RunBackgroundVerification(const std::vector<const DexFile*>
       GetVdexFilename(odex_filename)));
 }
 
+class StartupVerificationTask final : public Task {
+ public:
+  // State shared by all the tasks verifying the classes of one dex file.
+  class SharedState {
+   public:
+    SharedState(const DexFile* dex_file, jobject class_loader)
+        : dex_file_(dex_file), class_loader_(class_loader), next_index_(0u) {}
+
+    ~SharedState() {
+      Thread* const self = Thread::Current();
+      ScopedObjectAccess soa(self);
+      soa.Vm()->DeleteGlobalRef(self, class_loader_);
+    }
+
+   private:
+    const DexFile* const dex_file_;
+    const jobject class_loader_;
+    // Class defs to verify, in order. Written by the planning task before it adds the
+    // helper tasks to the thread pool, read-only afterwards.
+    std::vector<uint16_t> class_def_indexes_;
+    std::atomic<size_t> next_index_;
+
+    friend class StartupVerificationTask;
+    DISALLOW_COPY_AND_ASSIGN(SharedState);
+  };
+
+  StartupVerificationTask(std::shared_ptr<SharedState> state,
+                          ThreadPool* thread_pool,
+                          size_t num_helpers)
+      : state_(std::move(state)), thread_pool_(thread_pool), num_helpers_(num_helpers) {}
+
+  void Run(Thread* self) override {
+    if (thread_pool_ != nullptr) {
+      ScopedTrace trace("Startup verification planning");
+      ComputeVerificationOrder();
+      for (size_t i = 0; i != num_helpers_; ++i) {
+        thread_pool_->AddTask(self, new StartupVerificationTask(
+            state_, /* thread_pool= */ nullptr, /* num_helpers= */ 0u));
+      }
+    }
+    VerifyClasses(self);
+  }
+
+  void Finalize() override {
+    delete this;
+  }
+
+ private:
+  // Collect the class defs that are not recorded as verified in the oat file, putting the
+  // classes of the reference profile first as they are the ones the app needs to start.
+  void ComputeVerificationOrder() {
+    const DexFile& dex_file = *state_->dex_file_;
+    const OatDexFile* oat_dex_file = dex_file.GetOatDexFile();
+    DCHECK(oat_dex_file != nullptr);
+
+    ProfileCompilationInfo profile_info(/* for_boot_image= */ false);
+    const ArenaSet<dex::TypeIndex>* profile_classes = nullptr;
+    std::string profile_file = Runtime::Current()->GetAppInfo()->GetPrimaryApkReferenceProfile();
+    if (!profile_file.empty()) {
+      // The profile could be concurrently updated by the system. Don't block.
+      std::string error;
+      ScopedFlock profile =
+          LockedFile::Open(profile_file.c_str(), O_RDONLY, /*block=*/false, &error);
+      if (profile == nullptr) {
+        VLOG(oat) << "Couldn't lock the profile file " << profile_file << ": " << error;
+      } else if (profile_info.Load(profile->Fd())) {
+        profile_classes = profile_info.GetClasses(dex_file);
+      }
+    }
+
+    std::vector<uint16_t>& order = state_->class_def_indexes_;
+    std::vector<uint16_t> other_classes;
+    for (uint32_t cdef_idx = 0; cdef_idx < dex_file.NumClassDefs(); cdef_idx++) {
+      if (oat_dex_file->GetOatClass(cdef_idx).GetStatus() >= ClassStatus::kVerified) {
+        continue;
+      }
+      dex::TypeIndex type_idx = dex_file.GetClassDef(cdef_idx).class_idx_;
+      if (profile_classes != nullptr && profile_classes->count(type_idx) != 0u) {
+        order.push_back(dchecked_integral_cast<uint16_t>(cdef_idx));
+      } else {
+        other_classes.push_back(dchecked_integral_cast<uint16_t>(cdef_idx));
+      }
+    }
+    order.insert(order.end(), other_classes.begin(), other_classes.end());
+  }
+
+  void VerifyClasses(Thread* self) {
+    Runtime* const runtime = Runtime::Current();
+    ClassLinker* const class_linker = runtime->GetClassLinker();
+    const DexFile& dex_file = *state_->dex_file_;
+    const std::vector<uint16_t>& order = state_->class_def_indexes_;
+    for (size_t i = state_->next_index_.fetch_add(1u, std::memory_order_relaxed);
+         i < order.size();
+         i = state_->next_index_.fetch_add(1u, std::memory_order_relaxed)) {
+      if (runtime->IsShuttingDown(self)) {
+        return;
+      }
+      const dex::ClassDef& class_def = dex_file.GetClassDef(order[i]);
+
+      // Take handles inside the loop so that we do not hold on to the mutator lock
+      // for the whole dex file.
+      ScopedObjectAccess soa(self);
+      StackHandleScope<2> hs(self);
+      Handle<mirror::ClassLoader> h_loader(hs.NewHandle(
+          soa.Decode<mirror::ClassLoader>(state_->class_loader_)));
+      Handle<mirror::Class> h_class(hs.NewHandle<mirror::Class>(class_linker->FindClass(
+          self,
+          dex_file.GetClassDescriptor(class_def),
+          h_loader)));
+
+      if (h_class == nullptr) {
+        // The class loader chain is not known to the runtime, or the class is missing
+        // a dependency. Leave it to the thread that first uses it.
+        DCHECK(self->IsExceptionPending());
+        self->ClearException();
+        continue;
+      }
+
+      if (&h_class->GetDexFile() != &dex_file || h_class->IsVerified()) {
+        // Either the descriptor resolves to a different class, or another thread
+        // already verified the class.
+        continue;
+      }
+
+      class_linker->VerifyClass(self, /* verifier_deps= */ nullptr, h_class);
+      if (self->IsExceptionPending()) {
+        // ClassLinker::VerifyClass can throw, but the exception isn't useful here.
+        self->ClearException();
+      }
+    }
+  }
+
+  const std::shared_ptr<SharedState> state_;
+  // The pool to add helper tasks to, null for the helper tasks themselves.
+  ThreadPool* const thread_pool_;
+  const size_t num_helpers_;
+
+  DISALLOW_COPY_AND_ASSIGN(StartupVerificationTask);
+};
+
+void OatFileManager::RunStartupVerification(const DexFile& dex_file,
+                                            ObjPtr<mirror::ClassLoader> class_loader) {
+  Runtime* const runtime = Runtime::Current();
+  Thread* const self = Thread::Current();
+  const size_t num_threads = runtime->GetStartupVerificationThreads();
+
+  if (num_threads == 0u || class_loader == nullptr) {
+    return;
+  }
+
+  if (runtime->IsAotCompiler() || runtime->IsZygote() || runtime->IsJavaDebuggable()) {
+    // The compiler verifies classes itself, the zygote must not start threads before
+    // forking, and runtime threads are not allowed to load classes when debuggable.
+    return;
+  }
+
+  if (dex_file.GetOatDexFile() == nullptr || dex_file.GetOatDexFile()->GetOatFile() == nullptr) {
+    // Without an oat file there is no record of verified classes. Dex files loaded
+    // without one are handled by RunBackgroundVerification().
+    return;
+  }
+
+  if (runtime->IsShuttingDown(self)) {
+    // Not allowed to create new threads during runtime shutdown.
+    return;
+  }
+
+  // Create a global ref for `class_loader` because it will be accessed from different threads.
+  jobject global_class_loader = runtime->GetJavaVM()->AddGlobalRef(self, class_loader);
+  CHECK(global_class_loader != nullptr);
+  auto state = std::make_shared<StartupVerificationTask::SharedState>(&dex_file,
+                                                                      global_class_loader);
+
+  // Do not hold the mutator lock while starting threads.
+  ScopedThreadSuspension sts(self, ThreadState::kNative);
+  {
+    WriterMutexLock mu(self, *Locks::oat_file_manager_lock_);
+    if (startup_verification_thread_pool_ == nullptr) {
+      startup_verification_thread_pool_.reset(
+          new ThreadPool("Startup verification thread pool", num_threads));
+      startup_verification_thread_pool_->StartWorkers(self);
+    }
+  }
+  ThreadPool* const thread_pool = startup_verification_thread_pool_.get();
+  thread_pool->AddTask(self, new StartupVerificationTask(
+      std::move(state), thread_pool, /* num_helpers= */ num_threads - 1u));
+}
+
 void OatFileManager::WaitForWorkersToBeCreated() {
   DCHECK(!Runtime::Current()->IsShuttingDown(Thread::Current()))
       << "Cannot create new threads during runtime shutdown";
   if (verification_thread_pool_ != nullptr) {
     verification_thread_pool_->WaitForWorkersToBeCreated();
   }
+  if (startup_verification_thread_pool_ != nullptr) {
+    startup_verification_thread_pool_->WaitForWorkersToBeCreated();
+  }
 }
 
 void OatFileManager::DeleteThreadPool() {
   verification_thread_pool_.reset(nullptr);
+  startup_verification_thread_pool_.reset(nullptr);
 }
 
 void OatFileManager::WaitForBackgroundVerificationTasksToFinish() {
@@ -891,6 +1087,16 @@ void OatFileManager::WaitForBackgroundVerificationTasks() {
   }
 }
 
+bool OatFileManager::WaitForStartupVerificationTasks() {
+  if (startup_verification_thread_pool_ == nullptr) {
+    return false;
+  }
+  Thread* const self = Thread::Current();
+  startup_verification_thread_pool_->WaitForWorkersToBeCreated();
+  startup_verification_thread_pool_->Wait(self, /* do_work= */ true, /* may_hold_locks= */ false);
+  return true;
+}
+
 void OatFileManager::ClearOnlyUseTrustedOatFiles() {
   only_use_system_oat_files_ = false;
 }
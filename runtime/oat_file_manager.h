@@ -27,6 +27,7 @@
 #include "base/locks.h"
 #include "base/macros.h"
 #include "jni.h"
+#include "obj_ptr.h"
 
 namespace art {
 
@@ -36,6 +37,10 @@ class ImageSpace;
 }  // namespace space
 }  // namespace gc
 
+namespace mirror {
+class ClassLoader;
+}  // namespace mirror
+
 class ClassLoaderContext;
 class DexFile;
 class MemMap;
@@ -127,11 +132,18 @@ class OatFileManager {
   void RunBackgroundVerification(const std::vector<const DexFile*>& dex_files,
                                  jobject class_loader);
 
+  // If enabled with -Xstartup-verification-threads, verify the classes of `dex_file` that the
+  // oat file does not record as verified on a background thread pool, classes listed in the
+  // app's reference profile first. Later VerifyClass() calls then find the classes verified.
+  void RunStartupVerification(const DexFile& dex_file, ObjPtr<mirror::ClassLoader> class_loader)
+      REQUIRES_SHARED(Locks::mutator_lock_)
+      REQUIRES(!Locks::oat_file_manager_lock_);
+
   // Wait for thread pool workers to be created. This is used during shutdown as
   // threads are not allowed to attach while runtime is in shutdown lock.
   void WaitForWorkersToBeCreated();
 
-  // If allocated, delete a thread pool of background verification threads.
+  // If allocated, delete the thread pools of background verification threads.
   void DeleteThreadPool();
 
   // Wait for any ongoing background verification tasks to finish.
@@ -140,6 +152,10 @@ class OatFileManager {
   // Wait for all background verification tasks to finish. This is only used by tests.
   void WaitForBackgroundVerificationTasks();
 
+  // Wait for all startup verification tasks to finish. Returns false if startup verification
+  // was never started. This is only used by tests.
+  bool WaitForStartupVerificationTasks();
+
   // Maximum number of anonymous vdex files kept in the process' data folder.
   static constexpr size_t kAnonymousVdexCacheSize = 8u;
 
@@ -169,6 +185,9 @@ class OatFileManager {
   // Single-thread pool used to run the verifier in the background.
   std::unique_ptr<ThreadPool> verification_thread_pool_;
 
+  // Thread pool used to verify app classes at startup, see RunStartupVerification().
+  std::unique_ptr<ThreadPool> startup_verification_thread_pool_;
+
   DISALLOW_COPY_AND_ASSIGN(OatFileManager);
 };
 
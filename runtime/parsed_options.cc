@@ -169,6 +169,15 @@ std::unique_ptr<RuntimeParser> ParsedOptions::MakeParser(bool ignore_unrecognize
           .IntoKey(M::ForegroundHeapGrowthMultiplier)
       .Define("-XX:LowMemoryMode")
           .IntoKey(M::LowMemoryMode)
+      .Define("-XX:UseTransparentHugePages")
+          .IntoKey(M::UseTransparentHugePages)
+      .Define("-XX:PretenureAllocationSites")
+          .IntoKey(M::PretenureAllocationSites)
+      .Define("-XX:NumaAwareRegions")
+          .IntoKey(M::NumaAwareRegions)
+      .Define("-XX:FakeNumaNodes=_")
+          .WithType<unsigned int>()
+          .IntoKey(M::FakeNumaNodes)
       .Define("-Xprofile:_")
           .WithType<TraceClockSource>()
           .WithValueMap({{"threadcpuclock", TraceClockSource::kThreadCpu},
@@ -206,12 +215,20 @@ std::unique_ptr<RuntimeParser> ParsedOptions::MakeParser(bool ignore_unrecognize
       .Define("-XX:StopForNativeAllocs=_")
           .WithType<MemoryKiB>()
           .IntoKey(M::StopForNativeAllocs)
+      .Define("-XX:GcCpuBudgetPercent=_")
+          .WithType<unsigned int>()
+          .IntoKey(M::GcCpuBudgetPercent)
+      .Define("-XX:GcPauseGoalMs=_")
+          .WithType<unsigned int>()
+          .IntoKey(M::GcPauseGoalMs)
       .Define("-XX:ParallelGCThreads=_")
           .WithType<unsigned int>()
           .IntoKey(M::ParallelGCThreads)
       .Define("-XX:ConcGCThreads=_")
           .WithType<unsigned int>()
           .IntoKey(M::ConcGCThreads)
+      .Define("-XX:PinGCWorkers")
+          .IntoKey(M::PinGCWorkers)
       .Define("-XX:FinalizerTimeoutMs=_")
           .WithType<unsigned int>()
           .IntoKey(M::FinalizerTimeoutMs)
@@ -444,6 +461,15 @@ std::unique_ptr<RuntimeParser> ParsedOptions::MakeParser(bool ignore_unrecognize
       .Define("-Xverifier-logging-threshold=_")
           .WithType<unsigned int>()
           .IntoKey(M::VerifierLoggingThreshold)
+      .Define("-Xstartup-verification-threads=_")
+          .WithType<unsigned int>()
+          .IntoKey(M::StartupVerificationThreads)
+      .Define("-Xruntime-image-dir:_")
+          .WithType<std::string>()
+          .IntoKey(M::RuntimeImageDir)
+      .Define("-Xruntime-image-startup-timeout:_")  // in ms
+          .WithType<MillisecondsToNanoseconds>()  // store as ns
+          .IntoKey(M::RuntimeImageStartupTimeout)
       .Define("-XX:FastClassNotFoundException=_")
           .WithType<bool>()
           .WithValueMap({{"false", false}, {"true", true}})
@@ -713,9 +739,11 @@ bool ParsedOptions::DoParse(const RuntimeOptions& options,
     args.SetIfMissing(M::ClassPath, std::string(getenv("CLASSPATH")));
   }
 
-  // Default to number of processors minus one since the main GC thread also does work.
+  // Default to number of processors minus one since the main GC thread also does work. Count only
+  // the processors the cgroup cpuset and CPU quota let us use, so that a container with a small
+  // CPU budget on a large host does not get throttled by spinning up one GC thread per core.
   args.SetIfMissing(M::ParallelGCThreads, gc::Heap::kDefaultEnableParallelGC ?
-      static_cast<unsigned int>(sysconf(_SC_NPROCESSORS_CONF) - 1u) : 0u);
+      static_cast<unsigned int>(GetEffectiveCpuCount() - 1u) : 0u);
 
   // -verbose:
   {
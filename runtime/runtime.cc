@@ -173,6 +173,7 @@
 #include "sigchain.h"
 #include "signal_catcher.h"
 #include "signal_set.h"
+#include "startup_completed_task.h"
 #include "thread.h"
 #include "thread_list.h"
 #include "ti/agent.h"
@@ -314,6 +315,8 @@ Runtime::Runtime()
       process_state_(kProcessStateJankPerceptible),
       zygote_no_threads_(false),
       verifier_logging_threshold_ms_(100),
+      startup_verification_threads_(0u),
+      runtime_image_startup_timeout_ns_(0u),
       verifier_missing_kthrow_fatal_(false),
       perfetto_hprof_enabled_(false),
       perfetto_javaheapprof_enabled_(false),
@@ -1091,6 +1094,29 @@ bool Runtime::Start() {
     callbacks_->NextRuntimePhase(RuntimePhaseCallback::RuntimePhase::kStart);
   }
 
+  if (!is_zygote_ && !runtime_image_dir_.empty()) {
+    // A standalone process (e.g. started with dalvikvm) asked for warm starts. Register its
+    // class path as the primary APK so that the oat file manager loads the runtime app image
+    // generated by a previous run, and StartupCompletedTask writes a new one if there is none
+    // or it was rejected as stale. The image lives in the `cache/oat_primary` subdirectory of
+    // the data directory, as for apps.
+    if (process_data_directory_.empty()) {
+      process_data_directory_ = runtime_image_dir_;
+    }
+    std::vector<std::string> dex_filenames;
+    Split(class_path_string_, ':', &dex_filenames);
+    app_info_.RegisterAppInfo(/*package_name=*/ "",
+                              dex_filenames,
+                              /*cur_profile_path=*/ "",
+                              /*ref_profile_path=*/ "",
+                              AppInfo::CodeType::kPrimaryApk);
+    // There is no framework to notify us of the end of startup, so assume it is done after
+    // -Xruntime-image-startup-timeout unless the process calls VMRuntime.notifyStartupCompleted
+    // earlier. The default of 5 seconds is the same as ZygoteHooks uses for apps which never
+    // notify the runtime.
+    heap_->AddHeapTask(new StartupCompletedTask(NanoTime() + runtime_image_startup_timeout_ns_));
+  }
+
   system_class_loader_ = CreateSystemClassLoader(this);
 
   if (!is_zygote_) {
@@ -1760,7 +1786,14 @@ bool Runtime::Init(RuntimeArgumentMap&& runtime_options_in) {
                        use_generational_cc,
                        runtime_options.GetOrDefault(Opt::HSpaceCompactForOOMMinIntervalsMs),
                        runtime_options.Exists(Opt::DumpRegionInfoBeforeGC),
-                       runtime_options.Exists(Opt::DumpRegionInfoAfterGC));
+                       runtime_options.Exists(Opt::DumpRegionInfoAfterGC),
+                       runtime_options.Exists(Opt::UseTransparentHugePages),
+                       runtime_options.GetOrDefault(Opt::GcCpuBudgetPercent),
+                       runtime_options.GetOrDefault(Opt::GcPauseGoalMs),
+                       runtime_options.Exists(Opt::PretenureAllocationSites),
+                       runtime_options.Exists(Opt::NumaAwareRegions),
+                       runtime_options.GetOrDefault(Opt::FakeNumaNodes),
+                       runtime_options.Exists(Opt::PinGCWorkers));
 
   dump_gc_performance_on_shutdown_ = runtime_options.Exists(Opt::DumpGCPerformanceOnShutdown);
 
@@ -1887,6 +1920,10 @@ bool Runtime::Init(RuntimeArgumentMap&& runtime_options_in) {
   }
 
   verifier_logging_threshold_ms_ = runtime_options.GetOrDefault(Opt::VerifierLoggingThreshold);
+  startup_verification_threads_ = runtime_options.GetOrDefault(Opt::StartupVerificationThreads);
+  runtime_image_dir_ = runtime_options.ReleaseOrDefault(Opt::RuntimeImageDir);
+  runtime_image_startup_timeout_ns_ =
+      runtime_options.GetOrDefault(Opt::RuntimeImageStartupTimeout);
 
   std::string error_msg;
   java_vm_ = JavaVMExt::Create(this, runtime_options, &error_msg);
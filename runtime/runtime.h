@@ -1044,6 +1044,12 @@ class Runtime {
     return verifier_logging_threshold_ms_;
   }
 
+  // Number of threads used to verify app classes in the background when their dex file is
+  // registered. Zero means classes are only verified lazily by the thread that first uses them.
+  uint32_t GetStartupVerificationThreads() const {
+    return startup_verification_threads_;
+  }
+
   // Atomically delete the thread pool if the reference count is 0.
   bool DeleteThreadPool() REQUIRES(!Locks::runtime_thread_pool_lock_);
 
@@ -1572,6 +1578,16 @@ class Runtime {
 
   uint32_t verifier_logging_threshold_ms_;
 
+  uint32_t startup_verification_threads_;
+
+  // Directory under which a non-zygote process stores the runtime app image of its class
+  // path, see -Xruntime-image-dir. Empty if disabled.
+  std::string runtime_image_dir_;
+
+  // Time after which such a process is assumed to have completed startup, unless it calls
+  // VMRuntime.notifyStartupCompleted earlier. See -Xruntime-image-startup-timeout.
+  uint64_t runtime_image_startup_timeout_ns_;
+
   bool load_app_image_startup_cache_ = false;
 
   // If startup has completed, must happen at most once.
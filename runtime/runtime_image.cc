@@ -1859,7 +1859,11 @@ bool RuntimeImage::WriteImageToDisk(std::string* error_msg) {
     return false;
   }
   std::string oat_path = GetRuntimeImageDir(Runtime::Current()->GetProcessDataDirectory());
-  if (!oat_path.empty() && !EnsureDirectoryExists(oat_path, error_msg)) {
+  // The `cache` directory exists for apps but not necessarily for a data directory
+  // given with -Xruntime-image-dir.
+  if (!oat_path.empty() &&
+      (!EnsureDirectoryExists(android::base::Dirname(oat_path), error_msg) ||
+       !EnsureDirectoryExists(oat_path, error_msg))) {
     return false;
   }
 
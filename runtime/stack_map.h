@@ -363,6 +363,12 @@ class CodeInfo {
     return GetMethodInfoOf(inline_info).GetMethodIndex();
   }
 
+  // Methods that AOT code assumed to have a single implementation when devirtualizing calls.
+  // The dex file index of each entry is relative to the oat file of the compiled method.
+  const BitTable<MethodInfo>& GetCHADependencies() const {
+    return cha_dependencies_;
+  }
+
   // Returns the dex registers for `stack_map`, ignoring any inlined dex registers.
   ALWAYS_INLINE DexRegisterMap GetDexRegisterMapOf(StackMap stack_map) const {
     return GetDexRegisterMapOf(stack_map, /* first= */ 0, number_of_dex_registers_);
@@ -509,6 +515,11 @@ class CodeInfo {
     return HasFlag<kIsBaseline>(code_info_data);
   }
 
+  // Baseline-plus code is also baseline code.
+  ALWAYS_INLINE static bool IsBaselinePlus(const uint8_t* code_info_data) {
+    return HasFlag<kIsBaselinePlus>(code_info_data);
+  }
+
   ALWAYS_INLINE static bool IsDebuggable(const uint8_t* code_info_data) {
     return HasFlag<kIsDebuggable>(code_info_data);
   }
@@ -552,6 +563,7 @@ class CodeInfo {
     callback(index++, &CodeInfo::dex_register_masks_);
     callback(index++, &CodeInfo::dex_register_maps_);
     callback(index++, &CodeInfo::dex_register_catalog_);
+    callback(index++, &CodeInfo::cha_dependencies_);
     DCHECK_EQ(index, kNumBitTables);
   }
 
@@ -567,6 +579,7 @@ class CodeInfo {
     kHasShouldDeoptimizeFlag = 1 << 1,
     kIsBaseline = 1 << 2,
     kIsDebuggable = 1 << 3,
+    kIsBaselinePlus = 1 << 4,
   };
 
   // The CodeInfo starts with sequence of variable-length bit-encoded integers.
@@ -582,7 +595,7 @@ class CodeInfo {
 
   // The encoded bit-tables follow the header.  Based on the above flags field,
   // bit-tables might be omitted or replaced by relative bit-offset if deduped.
-  static constexpr size_t kNumBitTables = 8;
+  static constexpr size_t kNumBitTables = 9;
   BitTable<StackMap> stack_maps_;
   BitTable<RegisterMask> register_masks_;
   BitTable<StackMask> stack_masks_;
@@ -591,6 +604,7 @@ class CodeInfo {
   BitTable<DexRegisterMask> dex_register_masks_;
   BitTable<DexRegisterMapInfo> dex_register_maps_;
   BitTable<DexRegisterInfo> dex_register_catalog_;
+  BitTable<MethodInfo> cha_dependencies_;
 
   friend class linker::CodeInfoTableDeduper;
   friend class StackMapStream;
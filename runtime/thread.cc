@@ -3752,6 +3752,8 @@ void Thread::DumpThreadOffset(std::ostream& os, uint32_t offset) {
   QUICK_ENTRY_POINT_INFO(pAllocStringFromBytes)
   QUICK_ENTRY_POINT_INFO(pAllocStringFromChars)
   QUICK_ENTRY_POINT_INFO(pAllocStringFromString)
+  QUICK_ENTRY_POINT_INFO(pAllocObjectNonMoving)
+  QUICK_ENTRY_POINT_INFO(pAllocArrayNonMoving)
   QUICK_ENTRY_POINT_INFO(pInstanceofNonTrivial)
   QUICK_ENTRY_POINT_INFO(pCheckInstanceOf)
   QUICK_ENTRY_POINT_INFO(pInitializeStaticStorage)
@@ -4614,6 +4616,9 @@ void Thread::ResetTlab() {
                << " adjustment = "
                << (tlsPtr_.thread_local_pos - tlsPtr_.thread_local_start);
   }
+  if (tlsPtr_.thread_local_start != nullptr) {
+    heap->RecordTlabWaste(TlabSize());
+  }
   SetTlab(nullptr, nullptr, nullptr);
 }
 
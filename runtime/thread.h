@@ -1297,6 +1297,25 @@ class Thread {
   uint8_t* GetTlabEnd() {
     return tlsPtr_.thread_local_end;
   }
+
+  // Adaptive TLAB sizing state, see gc::Heap::NextTlabSize(). Only accessed by the thread itself.
+  size_t GetDesiredTlabSize() const {
+    return desired_tlab_size_;
+  }
+  void SetDesiredTlabSize(size_t size, uint32_t gc_num) {
+    desired_tlab_size_ = size;
+    tlab_bytes_since_resize_ = 0u;
+    tlab_resize_gc_num_ = gc_num;
+  }
+  size_t GetTlabBytesSinceResize() const {
+    return tlab_bytes_since_resize_;
+  }
+  uint32_t GetTlabResizeGcNum() const {
+    return tlab_resize_gc_num_;
+  }
+  void AddTlabBytesSinceResize(size_t bytes) {
+    tlab_bytes_since_resize_ += bytes;
+  }
   // Remove the suspend trigger for this thread by making the suspend_trigger_ TLS value
   // equal to a valid pointer.
   // TODO: does this need to atomic?  I don't think so.
@@ -2177,6 +2196,12 @@ class Thread {
   // the caller is allowed to access all fields and methods in the Core Platform API.
   uint32_t core_platform_api_cookie_ = 0;
 
+  // TLAB size this thread currently asks for, or 0 until its first TLAB. Resized from the bytes
+  // of TLABs the thread obtained since the GC number it was last resized at.
+  size_t desired_tlab_size_ = 0;
+  size_t tlab_bytes_since_resize_ = 0;
+  uint32_t tlab_resize_gc_num_ = 0;
+
   friend class gc::collector::SemiSpace;  // For getting stack traces.
   friend class Runtime;  // For CreatePeer.
   friend class QuickExceptionHandler;  // For dumping the stack.
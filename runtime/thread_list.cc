@@ -78,6 +78,7 @@ static constexpr bool kDumpUnattachedThreadNativeStackForSigQuit = true;
 
 ThreadList::ThreadList(uint64_t thread_suspend_timeout_ns)
     : suspend_all_count_(0),
+      exclusive_pause_count_(0u),
       unregistering_count_(0),
       suspend_all_historam_("suspend all histogram", 16, 64),
       long_suspend_(false),
@@ -569,6 +570,7 @@ size_t ThreadList::FlipThreadRoots(Closure* thread_flip_visitor,
 
   // Run the flip callback for the collector.
   Locks::mutator_lock_->ExclusiveLock(self);
+  exclusive_pause_count_.fetch_add(1u, std::memory_order_relaxed);
   suspend_all_historam_.AdjustAndAddValue(NanoTime() - suspend_start_time);
   flip_callback->Run(self);
   // Releasing mutator-lock *before* setting up flip function in the threads
@@ -621,6 +623,29 @@ size_t ThreadList::FlipThreadRoots(Closure* thread_flip_visitor,
   }
   collector->GetHeap()->ThreadFlipEnd(self);
 
+  if (gUseReadBarrier) {
+    // With CC the from-space stays accessible until every flip function has run, so the exclusive
+    // lock is not needed past this point. Release it before walking the stacks of the other
+    // threads. They keep their suspend count until this thread has run their flip function, in
+    // list order, and each one is resumed right after its own flip. A thread thus waits for the
+    // stacks before it in the list instead of the stacks of every thread in the process. A flip
+    // function already run by one of the threads resumed above is not run again.
+    Locks::mutator_lock_->ExclusiveUnlock(self);
+    ReaderMutexLock mu(self, *Locks::mutator_lock_);
+    TimingLogger::ScopedTiming split3("FlipAndResumeOtherThreads", collector->GetTimings());
+    for (Thread* thread : other_threads) {
+      thread->EnsureFlipFunctionStarted(self);
+      DCHECK(!thread->ReadFlag(ThreadFlag::kPendingFlipFunction));
+      MutexLock mu2(self, *Locks::thread_suspend_count_lock_);
+      bool updated = thread->ModifySuspendCount(self, -1, nullptr, SuspendReason::kInternal);
+      DCHECK(updated);
+      Thread::resume_cond_->Broadcast(self);
+    }
+    self->EnsureFlipFunctionStarted(self);
+    DCHECK(!self->ReadFlag(ThreadFlag::kPendingFlipFunction));
+    return runnable_thread_count + other_threads.size() + 1;  // +1 for self.
+  }
+
   // Try to run the closure on the other threads.
   {
     TimingLogger::ScopedTiming split3("FlipOtherThreads", collector->GetTimings());
@@ -682,6 +707,7 @@ void ThreadList::SuspendAll(const char* cause, bool long_suspend) {
 #endif
 
     long_suspend_ = long_suspend;
+    exclusive_pause_count_.fetch_add(1u, std::memory_order_relaxed);
 
     const uint64_t end_time = NanoTime();
     const uint64_t suspend_time = end_time - start_time;
@@ -181,6 +181,13 @@ class ThreadList {
 
   size_t Size() REQUIRES(Locks::thread_list_lock_) { return list_.size(); }
 
+  // Number of times the mutator lock was taken exclusively after suspending all threads, by
+  // SuspendAll() or FlipThreadRoots(). Code running with the mutator lock shared before such a
+  // pause has finished by the time this is incremented.
+  uint32_t GetExclusivePauseCount() const {
+    return exclusive_pause_count_.load(std::memory_order_relaxed);
+  }
+
   void DumpNativeStacks(std::ostream& os)
       REQUIRES(!Locks::thread_list_lock_);
 
@@ -222,6 +229,9 @@ class ThreadList {
   // Ongoing suspend all requests, used to ensure threads added to list_ respect SuspendAll.
   int suspend_all_count_ GUARDED_BY(Locks::thread_suspend_count_lock_);
 
+  // See GetExclusivePauseCount().
+  std::atomic<uint32_t> exclusive_pause_count_;
+
   // Number of threads unregistering, ~ThreadList blocks until this hits 0.
   int unregistering_count_ GUARDED_BY(Locks::thread_list_lock_);
 
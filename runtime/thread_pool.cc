@@ -22,6 +22,9 @@
 #include <sys/time.h>
 
 #include <pthread.h>
+#include <sched.h>
+
+#include <vector>
 
 #include <android-base/logging.h>
 #include <android-base/stringprintf.h>
@@ -98,6 +101,24 @@ void ThreadPoolWorker::SetPthreadPriority(int priority) {
 #endif
 }
 
+void ThreadPoolWorker::SetCpuAffinity(int cpu) {
+#if defined(__linux__)
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  CPU_SET(cpu, &cpu_set);
+#if defined(ART_TARGET_ANDROID)
+  int result = sched_setaffinity(pthread_gettid_np(pthread_), sizeof(cpu_set), &cpu_set);
+#else
+  int result = pthread_setaffinity_np(pthread_, sizeof(cpu_set), &cpu_set);
+#endif
+  if (result != 0) {
+    PLOG(WARNING) << "Failed to pin " << name_ << " to cpu " << cpu;
+  }
+#else
+  UNUSED(cpu);
+#endif
+}
+
 int ThreadPoolWorker::GetPthreadPriority() {
 #if defined(ART_TARGET_ANDROID)
   return getpriority(PRIO_PROCESS, pthread_gettid_np(pthread_));
@@ -340,6 +361,30 @@ void ThreadPool::SetPthreadPriority(int priority) {
   }
 }
 
+void ThreadPool::PinWorkersToCpus() {
+#if defined(__linux__)
+  cpu_set_t cpu_set;
+  if (sched_getaffinity(0, sizeof(cpu_set), &cpu_set) != 0) {
+    PLOG(WARNING) << "Failed to get the cpu affinity of " << name_;
+    return;
+  }
+  std::vector<int> cpus;
+  for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+    if (CPU_ISSET(cpu, &cpu_set)) {
+      cpus.push_back(cpu);
+    }
+  }
+  if (cpus.empty()) {
+    return;
+  }
+  // Spread the workers over the allowed CPUs, starting from the highest ones, which are the least
+  // likely to be running the main and UI threads.
+  for (size_t i = 0; i != threads_.size(); ++i) {
+    threads_[i]->SetCpuAffinity(cpus[cpus.size() - 1u - i % cpus.size()]);
+  }
+#endif
+}
+
 void ThreadPool::CheckPthreadPriority(int priority) {
 #if defined(ART_TARGET_ANDROID)
   for (ThreadPoolWorker* worker : threads_) {
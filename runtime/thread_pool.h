@@ -89,6 +89,9 @@ class ThreadPoolWorker {
   // Get the "nice" priority for this worker.
   int GetPthreadPriority();
 
+  // Restrict this worker to run on the given CPU.
+  void SetCpuAffinity(int cpu);
+
   Thread* GetThread() const { return thread_; }
 
  protected:
@@ -172,6 +175,10 @@ class ThreadPool {
   // Set the "nice" priority for threads in the pool.
   void SetPthreadPriority(int priority);
 
+  // Pin each worker of the pool to a different CPU of the process' affinity mask, wrapping around
+  // if there are more workers than CPUs.
+  void PinWorkersToCpus();
+
   // CHECK that the "nice" priority of threads in the pool is the given
   // `priority`.
   void CheckPthreadPriority(int priority);
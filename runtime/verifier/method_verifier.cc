@@ -1058,14 +1058,16 @@ bool MethodVerifier<kVerifierDebug>::ComputeWidthsAndCountOps() {
     Fail(VERIFY_ERROR_BAD_CLASS_HARD) << "code item has no opcode";
     return false;
   }
-  for ( ; !it.IsErrorState() && it < code_item_accessor_.end(); ++it) {
+  while (!it.IsErrorState() && it < code_item_accessor_.end()) {
     // In case the instruction goes past the end of the code item, make sure to not process it.
+    // Advance a copy so that the size of each instruction is decoded only once.
     SafeDexInstructionIterator next = it;
     ++next;
     if (next.IsErrorState()) {
       break;
     }
     GetModifiableInstructionFlags(it.DexPc()).SetIsOpcode();
+    it = next;
   }
 
   if (it != code_item_accessor_.end()) {
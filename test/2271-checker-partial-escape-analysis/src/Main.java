@@ -0,0 +1,81 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+class Point {
+    int x;
+    int y;
+}
+
+public class Main {
+    public static void main(String[] args) {
+        assertEquals(3, $noinline$escapeOnRarePath(false, 1, 2));
+        assertEquals(-1, $noinline$escapeOnRarePath(true, 1, 2));
+        assertEquals(3, sLogged.x + sLogged.y);
+
+        assertEquals(7, $noinline$escapeAfterMerge(false, 3, 4));
+        assertEquals(7, $noinline$escapeAfterMerge(true, 3, 4));
+    }
+
+    /// CHECK-START: int Main.$noinline$escapeOnRarePath(boolean, int, int) partial_escape_analysis (before)
+    /// CHECK:     NewInstance
+    /// CHECK:     If
+    /// CHECK:     InvokeStaticOrDirect method_name:Main.$noinline$log
+
+    /// CHECK-START: int Main.$noinline$escapeOnRarePath(boolean, int, int) partial_escape_analysis (after)
+    /// CHECK:     If
+    /// CHECK:     NewInstance
+    /// CHECK:     InstanceFieldSet
+    /// CHECK:     InstanceFieldSet
+    /// CHECK:     InvokeStaticOrDirect method_name:Main.$noinline$log
+    private static int $noinline$escapeOnRarePath(boolean rare, int x, int y) {
+        Point p = new Point();
+        p.x = x;
+        p.y = y;
+        if (rare) {
+            $noinline$log(p);
+            return -1;
+        }
+        return p.x + p.y;
+    }
+
+    // The object is used after the escaping branch merges back, so it must stay where it is.
+
+    /// CHECK-START: int Main.$noinline$escapeAfterMerge(boolean, int, int) partial_escape_analysis (after)
+    /// CHECK:     NewInstance
+    /// CHECK:     If
+    /// CHECK:     InvokeStaticOrDirect method_name:Main.$noinline$log
+    private static int $noinline$escapeAfterMerge(boolean rare, int x, int y) {
+        Point p = new Point();
+        p.x = x;
+        if (rare) {
+            $noinline$log(p);
+        }
+        p.y = y;
+        return p.x + p.y;
+    }
+
+    private static void $noinline$log(Point p) {
+        sLogged = p;
+    }
+
+    private static void assertEquals(int expected, int result) {
+        if (expected != result) {
+            throw new Error("Expected: " + expected + ", found: " + result);
+        }
+    }
+
+    static Point sLogged;
+}
@@ -0,0 +1,53 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+import dalvik.system.PathClassLoader;
+
+public class Main {
+    static final String DEX_FILE =
+        System.getenv("DEX_LOCATION") + "/2272-cha-closed-hierarchy-aot-ex.jar";
+
+    // Base.value() has a single implementation when the main dex file is compiled, so
+    // these calls can be devirtualized and inlined behind a CHA guard.
+    static int callValue(Base b) {
+        return b.value();
+    }
+
+    static int callValueAroundLoading(Base b) throws Exception {
+        int result = b.value();
+        // Loading Derived invalidates the devirtualization while this frame is on the stack,
+        // so it has to be deoptimized for the call below to reach Derived.value().
+        Base derived = loadDerived();
+        if (result != 1) {
+            throw new Error("Unexpected value " + result);
+        }
+        return derived.value();
+    }
+
+    static Base loadDerived() throws Exception {
+        ClassLoader loader = new PathClassLoader(DEX_FILE, Main.class.getClassLoader());
+        return (Base) loader.loadClass("Derived").getDeclaredConstructor().newInstance();
+    }
+
+    public static void main(String[] args) throws Exception {
+        Base base = new Base();
+        System.out.println("Before loading: " + callValue(base));
+        System.out.println("On stack: " + callValueAroundLoading(base));
+        // The AOT code of callValue() must not be used anymore.
+        Base derived = loadDerived();
+        System.out.println("After loading: " + callValue(base) + " " + callValue(derived));
+    }
+}
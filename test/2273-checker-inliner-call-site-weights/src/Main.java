@@ -0,0 +1,160 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+class Base {
+    final int compute(int x) {
+        return ((x * 3 + 7) ^ (x >>> 2)) * 5 + ((x << 3) - 11) * (x | 13) + (x & 0x55) * 17;
+    }
+}
+
+class Other {
+    final int compute(int x) {
+        return ((x * 3 + 7) ^ (x >>> 2)) * 5 + ((x << 3) - 11) * (x | 13) + (x & 0x55) * 17;
+    }
+}
+
+public class Main {
+    static int straight(int x) {
+        return ((x * 3 + 7) ^ (x >>> 2)) * 5 + ((x << 3) - 11) * (x | 13) + (x & 0x55) * 17;
+    }
+
+    static int inLoop(int x) {
+        return ((x * 3 + 7) ^ (x >>> 2)) * 5 + ((x << 3) - 11) * (x | 13) + (x & 0x55) * 17;
+    }
+
+    // The profile has an inline cache for the call on `b` only, so the call on `o` was not
+    // reached and only small methods are inlined there.
+
+    /// CHECK-START: int Main.$noinline$coldSite(Base, Other, int) inliner (after)
+    /// CHECK-NOT:   InvokeVirtual method_name:Base.compute
+
+    /// CHECK-START: int Main.$noinline$coldSite(Base, Other, int) inliner (after)
+    /// CHECK:       InvokeVirtual method_name:Other.compute
+    static int $noinline$coldSite(Base b, Other o, int x) {
+        return b.compute(x) + o.compute(x);
+    }
+
+    // The profile has no inline caches for this method, which says nothing about its call sites.
+
+    /// CHECK-START: int Main.$noinline$noInlineCaches(Other, int) inliner (after)
+    /// CHECK-NOT:   InvokeVirtual method_name:Other.compute
+    static int $noinline$noInlineCaches(Other o, int x) {
+        return o.compute(x);
+    }
+
+    // The straight-line calls come first but use up the inlining budget only after the call in
+    // the loop, which is visited first, has been inlined.
+
+    /// CHECK-START: int Main.$noinline$loopFirst(int) inliner (after)
+    /// CHECK:       InvokeStaticOrDirect method_name:Main.straight
+
+    /// CHECK-START: int Main.$noinline$loopFirst(int) inliner (after)
+    /// CHECK-NOT:   InvokeStaticOrDirect method_name:Main.inLoop
+    static int $noinline$loopFirst(int x) {
+        int sum = 0;
+        sum += straight(x + 0);
+        sum += straight(x + 1);
+        sum += straight(x + 2);
+        sum += straight(x + 3);
+        sum += straight(x + 4);
+        sum += straight(x + 5);
+        sum += straight(x + 6);
+        sum += straight(x + 7);
+        sum += straight(x + 8);
+        sum += straight(x + 9);
+        sum += straight(x + 10);
+        sum += straight(x + 11);
+        sum += straight(x + 12);
+        sum += straight(x + 13);
+        sum += straight(x + 14);
+        sum += straight(x + 15);
+        sum += straight(x + 16);
+        sum += straight(x + 17);
+        sum += straight(x + 18);
+        sum += straight(x + 19);
+        sum += straight(x + 20);
+        sum += straight(x + 21);
+        sum += straight(x + 22);
+        sum += straight(x + 23);
+        sum += straight(x + 24);
+        sum += straight(x + 25);
+        sum += straight(x + 26);
+        sum += straight(x + 27);
+        sum += straight(x + 28);
+        sum += straight(x + 29);
+        sum += straight(x + 30);
+        sum += straight(x + 31);
+        sum += straight(x + 32);
+        sum += straight(x + 33);
+        sum += straight(x + 34);
+        sum += straight(x + 35);
+        sum += straight(x + 36);
+        sum += straight(x + 37);
+        sum += straight(x + 38);
+        sum += straight(x + 39);
+        sum += straight(x + 40);
+        sum += straight(x + 41);
+        sum += straight(x + 42);
+        sum += straight(x + 43);
+        sum += straight(x + 44);
+        sum += straight(x + 45);
+        sum += straight(x + 46);
+        sum += straight(x + 47);
+        sum += straight(x + 48);
+        sum += straight(x + 49);
+        sum += straight(x + 50);
+        sum += straight(x + 51);
+        sum += straight(x + 52);
+        sum += straight(x + 53);
+        sum += straight(x + 54);
+        sum += straight(x + 55);
+        sum += straight(x + 56);
+        sum += straight(x + 57);
+        sum += straight(x + 58);
+        sum += straight(x + 59);
+        sum += straight(x + 60);
+        sum += straight(x + 61);
+        sum += straight(x + 62);
+        sum += straight(x + 63);
+        for (int i = 0; i < x; ++i) {
+            sum += inLoop(i);
+        }
+        return sum;
+    }
+
+    public static void main(String[] args) {
+        Base b = new Base();
+        Other o = new Other();
+        int expected = 2 * b.compute(42);
+        if ($noinline$coldSite(b, o, 42) != expected) {
+            throw new Error("Unexpected result from $noinline$coldSite");
+        }
+        if ($noinline$noInlineCaches(o, 42) != expected / 2) {
+            throw new Error("Unexpected result from $noinline$noInlineCaches");
+        }
+        int sum = 0;
+        for (int i = 0; i < 64; ++i) {
+            sum += straight(10 + i);
+        }
+        for (int i = 0; i < 10; ++i) {
+            sum += inLoop(i);
+        }
+        if ($noinline$loopFirst(10) != sum) {
+            throw new Error("Unexpected result from $noinline$loopFirst");
+        }
+        System.out.println("passed");
+    }
+}
@@ -0,0 +1,108 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+public class Main {
+  static final int DOMINANT_CALLS = 1000;
+  static final int OTHER_CALLS = 10;
+
+  public static void main(String[] args) {
+    System.loadLibrary(args[0]);
+    if (!hasJit()) {
+      // Inline caches are only updated by JIT baseline code.
+      System.out.println("passed");
+      return;
+    }
+
+    // Load all receiver classes first, so that class hierarchy analysis does not
+    // devirtualize the call.
+    Base[] others = { new B(), new C(), new D(), new E(), new F() };
+    Base dominant = new A();
+
+    ensureJitBaselineCompiled(Main.class, "$noinline$call");
+    // Keep running the baseline code, and avoid a GC marking phase, during which
+    // the inline caches are not updated.
+    stopJit();
+    Runtime.getRuntime().gc();
+
+    for (int i = 0; i < DOMINANT_CALLS; ++i) {
+      $noinline$call(dominant);
+    }
+    for (Base other : others) {
+      for (int i = 0; i < OTHER_CALLS; ++i) {
+        $noinline$call(other);
+      }
+    }
+
+    // The first call of each receiver fills its entry and must be counted too.
+    expectCount(DOMINANT_CALLS, A.class);
+    expectCount(OTHER_CALLS, B.class);
+    expectCount(OTHER_CALLS, C.class);
+    expectCount(OTHER_CALLS, D.class);
+    // The last entry is shared by all receivers that did not fit in the others.
+    expectCount(0, E.class);
+    expectCount(2 * OTHER_CALLS, F.class);
+    startJit();
+
+    System.out.println("passed");
+  }
+
+  public static int $noinline$call(Base b) {
+    return b.value();
+  }
+
+  static void expectCount(int expected, Class<?> receiver) {
+    int count = getInlineCacheCount(Main.class, "$noinline$call", receiver);
+    if (count != expected) {
+      throw new Error("Expected " + expected + " calls with " + receiver + ", got " + count);
+    }
+  }
+
+  private static native boolean hasJit();
+  private static native void ensureJitBaselineCompiled(Class<?> cls, String methodName);
+  private static native void stopJit();
+  private static native void startJit();
+  private static native int getInlineCacheCount(
+      Class<?> cls, String methodName, Class<?> receiver);
+}
+
+abstract class Base {
+  abstract int value();
+}
+
+class A extends Base {
+  int value() { return 1; }
+}
+
+class B extends Base {
+  int value() { return 2; }
+}
+
+class C extends Base {
+  int value() { return 3; }
+}
+
+class D extends Base {
+  int value() { return 4; }
+}
+
+class E extends Base {
+  int value() { return 5; }
+}
+
+class F extends Base {
+  int value() { return 6; }
+}
@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+public class Main {
+  static final int ARRAY_SIZE = 100;
+  static final int MAX_ROUNDS = 1000;
+  static final int CALLS_PER_ROUND = 1000;
+
+  public static void main(String[] args) {
+    System.loadLibrary(args[0]);
+    int[] array = new int[ARRAY_SIZE];
+    for (int i = 0; i < ARRAY_SIZE; ++i) {
+      array[i] = i;
+    }
+    int expected = ARRAY_SIZE * (ARRAY_SIZE - 1) / 2;
+    if (!hasJit()) {
+      // Nothing to test, print the expected output.
+      System.out.println("baseline");
+      System.out.println("baseline-plus");
+      System.out.println("optimized");
+      return;
+    }
+
+    ensureJitBaselineCompiled(Main.class, "$noinline$sum");
+    System.out.println(getJitTier(Main.class, "$noinline$sum"));
+    check(expected, $noinline$sum(array));
+
+    ensureJitBaselinePlusCompiled(Main.class, "$noinline$sum");
+    System.out.println(getJitTier(Main.class, "$noinline$sum"));
+    check(expected, $noinline$sum(array));
+
+    // Baseline-plus code still counts its hotness. Once it is hot, the method must be
+    // compiled optimized and not go through the baseline-plus tier again.
+    for (int round = 0; round < MAX_ROUNDS; ++round) {
+      for (int i = 0; i < CALLS_PER_ROUND; ++i) {
+        check(expected, $noinline$sum(array));
+      }
+      waitForCompilation();
+      if (!getJitTier(Main.class, "$noinline$sum").equals("baseline-plus")) {
+        break;
+      }
+    }
+    System.out.println(getJitTier(Main.class, "$noinline$sum"));
+    check(expected, $noinline$sum(array));
+  }
+
+  public static int $noinline$sum(int[] array) {
+    int sum = 0;
+    for (int i = 0; i < array.length; ++i) {
+      sum += array[i];
+    }
+    return sum;
+  }
+
+  static void check(int expected, int actual) {
+    if (expected != actual) {
+      throw new Error("Expected " + expected + ", got " + actual);
+    }
+  }
+
+  private static native boolean hasJit();
+  private static native void ensureJitBaselineCompiled(Class<?> cls, String methodName);
+  private static native void ensureJitBaselinePlusCompiled(Class<?> cls, String methodName);
+  private static native String getJitTier(Class<?> cls, String methodName);
+  private static native void waitForCompilation();
+}
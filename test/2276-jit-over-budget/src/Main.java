@@ -0,0 +1,117 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+public class Main {
+  static final int ARRAY_SIZE = 100;
+
+  static class Point {
+    int x;
+    int y;
+  }
+
+  public static void main(String[] args) {
+    System.loadLibrary(args[0]);
+    int[] array = new int[ARRAY_SIZE];
+    for (int i = 0; i < ARRAY_SIZE; ++i) {
+      array[i] = i;
+    }
+
+    // Each method exercises at least one optional pass: BCE, LICM and loop
+    // optimization for the loops, the inliner for the call, LSE for the
+    // allocation and the select generator for the conditional.
+    String[] methods = {
+        "$noinline$sum",
+        "$noinline$sumTimesInvariant",
+        "$noinline$load",
+        "$noinline$addThroughCall",
+        "$noinline$allocate",
+        "$noinline$max",
+    };
+    long overBudgetBefore = getJitOverBudgetCount();
+    for (String method : methods) {
+      ensureJitCompiled(Main.class, method);
+    }
+    if (hasJit() && getJitOverBudgetCount() - overBudgetBefore < methods.length) {
+      throw new Error("Expected " + methods.length + " compilations over budget, got " +
+          (getJitOverBudgetCount() - overBudgetBefore));
+    }
+
+    int expectedSum = ARRAY_SIZE * (ARRAY_SIZE - 1) / 2;
+    check(expectedSum, $noinline$sum(array));
+    check(3 * expectedSum, $noinline$sumTimesInvariant(array, 1, 2));
+    check(42, $noinline$load(array, 42));
+    try {
+      $noinline$load(array, ARRAY_SIZE);
+      throw new Error("Expected ArrayIndexOutOfBoundsException");
+    } catch (ArrayIndexOutOfBoundsException expected) {
+      // Bounds checks must still be there without BCE.
+    }
+    check(5, $noinline$addThroughCall(2, 3));
+    check(7, $noinline$allocate(3, 4));
+    check(9, $noinline$max(9, -1));
+    check(9, $noinline$max(-1, 9));
+    System.out.println("passed");
+  }
+
+  public static int $noinline$sum(int[] array) {
+    int sum = 0;
+    for (int i = 0; i < array.length; ++i) {
+      sum += array[i];
+    }
+    return sum;
+  }
+
+  public static int $noinline$sumTimesInvariant(int[] array, int a, int b) {
+    int sum = 0;
+    for (int i = 0; i < array.length; ++i) {
+      sum += array[i] * (a + b);
+    }
+    return sum;
+  }
+
+  public static int $noinline$load(int[] array, int index) {
+    return array[index];
+  }
+
+  public static int $noinline$addThroughCall(int a, int b) {
+    return $inline$add(a, b);
+  }
+
+  public static int $inline$add(int a, int b) {
+    return a + b;
+  }
+
+  public static int $noinline$allocate(int x, int y) {
+    Point p = new Point();
+    p.x = x;
+    p.y = y;
+    return p.x + p.y;
+  }
+
+  public static int $noinline$max(int a, int b) {
+    return (a > b) ? a : b;
+  }
+
+  static void check(int expected, int actual) {
+    if (expected != actual) {
+      throw new Error("Expected " + expected + ", got " + actual);
+    }
+  }
+
+  private static native boolean hasJit();
+  private static native void ensureJitCompiled(Class<?> cls, String methodName);
+  private static native long getJitOverBudgetCount();
+}
@@ -0,0 +1,125 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+import java.util.concurrent.CyclicBarrier;
+
+// The concurrent copying collector flips the roots of the threads suspended for the
+// thread flip after it has given up the exclusive mutator lock, resuming each thread
+// right after its flip. Run many flips while threads are parked deep in their stacks
+// and others are running, then check every frame still sees its objects.
+public class Main {
+  static final int DEEP_THREADS = 8;
+  static final int DEPTH = 100;
+  static final int CHURN_THREADS = 4;
+  static final int ROUNDS = 20;
+  static final int GCS_PER_ROUND = 2;
+
+  static class Node {
+    final int depth;
+    final Node parent;
+    final String name;
+
+    Node(int depth, Node parent) {
+      this.depth = depth;
+      this.parent = parent;
+      this.name = "frame" + depth;
+    }
+
+    void check(int expectedDepth, Node expectedParent) {
+      if (depth != expectedDepth || parent != expectedParent || !name.equals("frame" + depth)) {
+        throw new Error("Corrupted node at depth " + expectedDepth);
+      }
+    }
+  }
+
+  static final CyclicBarrier parked = new CyclicBarrier(DEEP_THREADS + 1);
+  static final CyclicBarrier resumed = new CyclicBarrier(DEEP_THREADS + 1);
+  static volatile boolean done = false;
+
+  public static void main(String[] args) throws Exception {
+    Thread[] threads = new Thread[DEEP_THREADS + CHURN_THREADS];
+    for (int i = 0; i < DEEP_THREADS; ++i) {
+      threads[i] = new Thread(() -> $noinline$recurse(DEPTH, null, new Node[DEPTH + 1]));
+    }
+    for (int i = 0; i < CHURN_THREADS; ++i) {
+      threads[DEEP_THREADS + i] = new Thread(Main::churn);
+    }
+    for (Thread thread : threads) {
+      thread.start();
+    }
+
+    for (int round = 0; round < ROUNDS; ++round) {
+      // The deep threads are now blocked at the bottom of their stacks.
+      parked.await();
+      for (int i = 0; i < GCS_PER_ROUND; ++i) {
+        Runtime.getRuntime().gc();
+      }
+      resumed.await();
+    }
+    done = true;
+    for (Thread thread : threads) {
+      thread.join();
+    }
+    System.out.println("passed");
+  }
+
+  // Each frame holds a node in a local, checked again when the frame returns. The
+  // nodes are also recorded in `nodes`, indexed by depth.
+  static void $noinline$recurse(int depth, Node parent, Node[] nodes) {
+    Node node = new Node(depth, parent);
+    nodes[depth] = node;
+    if (depth == 0) {
+      for (int round = 0; round < ROUNDS; ++round) {
+        await(parked);
+        await(resumed);
+        if (nodes[0] != node) {
+          throw new Error("Corrupted local at depth 0");
+        }
+        // Check the parent of each node against the node recorded by the frame above.
+        for (int d = 0; d <= DEPTH; ++d) {
+          nodes[d].check(d, (d == DEPTH) ? null : nodes[d + 1]);
+        }
+      }
+    } else {
+      $noinline$recurse(depth - 1, node, nodes);
+    }
+    node.check(depth, parent);
+  }
+
+  // Keeps allocating and walking shallow stacks so that some threads are runnable
+  // during each flip.
+  static void churn() {
+    while (!done) {
+      $noinline$shallow(10, null);
+    }
+  }
+
+  static void $noinline$shallow(int depth, Node parent) {
+    Node node = new Node(depth, parent);
+    if (depth != 0) {
+      $noinline$shallow(depth - 1, node);
+    }
+    node.check(depth, parent);
+  }
+
+  static void await(CyclicBarrier barrier) {
+    try {
+      barrier.await();
+    } catch (Exception e) {
+      throw new Error(e);
+    }
+  }
+}
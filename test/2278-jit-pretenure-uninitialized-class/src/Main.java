@@ -0,0 +1,67 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+class Lazy {
+  static {
+    System.out.println("Lazy.<clinit>");
+    Main.lazyInitialized = true;
+  }
+}
+
+public class Main {
+  static final int SURVIVORS = 16;
+  static final int GCS = 3;
+  static boolean lazyInitialized = false;
+
+  public static void main(String[] args) {
+    System.loadLibrary(args[0]);
+    // Make the allocation site of `Lazy` look long-lived before anything allocates a
+    // `Lazy`, so that the method is compiled while the class is still uninitialized.
+    Object[] survivors = new Object[SURVIVORS];
+    for (int i = 0; i < SURVIVORS; ++i) {
+      survivors[i] = new Object();
+    }
+    addAllocationSamples(Main.class, "$noinline$newLazy", survivors);
+    for (int i = 0; i < GCS; ++i) {
+      Runtime.getRuntime().gc();
+    }
+    if (hasJit() && !shouldPretenure(Main.class, "$noinline$newLazy")) {
+      throw new Error("Expected the allocation site to be pretenured");
+    }
+    ensureJitCompiled(Main.class, "$noinline$newLazy");
+
+    Object lazy = $noinline$newLazy();
+    // Do not touch the statics of `Lazy` here, as that would initialize it.
+    if (!lazyInitialized || !(lazy instanceof Lazy)) {
+      throw new Error("Lazy is not initialized");
+    }
+    // Keep the survivors alive until the site has been compiled.
+    if (survivors.length != SURVIVORS) {
+      throw new Error("Unexpected length");
+    }
+    System.out.println("passed");
+  }
+
+  public static Object $noinline$newLazy() {
+    return new Lazy();
+  }
+
+  private static native boolean hasJit();
+  private static native void ensureJitCompiled(Class<?> cls, String methodName);
+  private static native void addAllocationSamples(
+      Class<?> cls, String methodName, Object[] survivors);
+  private static native boolean shouldPretenure(Class<?> cls, String methodName);
+}
@@ -0,0 +1,119 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+public class Main {
+  // A qword holds 8 compressed or 4 UTF-16 chars. Going up to 3 qwords of compressed
+  // chars covers strings of 1, 2 and 3 qwords, with a partial tail qword or without,
+  // for both encodings, and more than one 16-byte vector for UTF-16 strings.
+  static final int MAX_LENGTH = 24;
+
+  public static void main(String[] args) {
+    System.loadLibrary(args[0]);
+    ensureJitCompiled(Main.class, "$noinline$equals");
+    ensureJitCompiled(Main.class, "$noinline$compareTo");
+    ensureJitCompiled(Main.class, "$noinline$indexOf");
+    ensureJitCompiled(Main.class, "$noinline$indexOfAfter");
+
+    for (int length = 1; length <= MAX_LENGTH; ++length) {
+      testLength(length, 'a');          // Compressed.
+      testLength(length, '\u0100');  // UTF-16.
+    }
+    System.out.println("passed");
+  }
+
+  static void testLength(int length, char first) {
+    String s = makeString(length, first, -1, '\0');
+    check(true, $noinline$equals(s, makeString(length, first, -1, '\0')));
+    check(0, $noinline$compareTo(s, makeString(length, first, -1, '\0')));
+    check(-1, $noinline$indexOf(s, '#'));
+    check(-1, $noinline$indexOfAfter(s, '#', 0));
+
+    // Against a string of the other encoding.
+    char otherFirst = (first == 'a') ? '\u0100' : 'a';
+    String other = makeString(length, otherFirst, -1, '\0');
+    check(first - otherFirst, $noinline$compareTo(s, other));
+    check(otherFirst - first, $noinline$compareTo(other, s));
+    check(false, $noinline$equals(s, other));
+
+    // Differences in each position, including the last char of the tail qword.
+    for (int i = 0; i < length; ++i) {
+      String lower = makeString(length, first, i, (char) (s.charAt(i) - 1));
+      String higher = makeString(length, first, i, (char) (s.charAt(i) + 1));
+      check(false, $noinline$equals(s, lower));
+      check(false, $noinline$equals(s, higher));
+      check(1, $noinline$compareTo(s, lower));
+      check(-1, $noinline$compareTo(s, higher));
+      check(-1, $noinline$compareTo(lower, s));
+
+      String found = makeString(length, first, i, '#');
+      check(i, $noinline$indexOf(found, '#'));
+      check(i, $noinline$indexOfAfter(found, '#', 0));
+      check(i, $noinline$indexOfAfter(found, '#', i));
+      check(-1, $noinline$indexOfAfter(found, '#', i + 1));
+      check(i, $noinline$indexOf(s, s.charAt(i)));
+    }
+
+    // Prefixes compare by length.
+    for (int prefix = 0; prefix < length; ++prefix) {
+      check(length - prefix, $noinline$compareTo(s, s.substring(0, prefix)));
+      check(prefix - length, $noinline$compareTo(s.substring(0, prefix), s));
+      check(false, $noinline$equals(s, s.substring(0, prefix)));
+    }
+  }
+
+  // Returns a new string of distinct chars starting at `first`, with `replacement`
+  // at `index` if it is not -1.
+  static String makeString(int length, char first, int index, char replacement) {
+    char[] chars = new char[length];
+    for (int i = 0; i < length; ++i) {
+      chars[i] = (char) (first + i);
+    }
+    if (index != -1) {
+      chars[index] = replacement;
+    }
+    return new String(chars);
+  }
+
+  public static boolean $noinline$equals(String s, Object o) {
+    return s.equals(o);
+  }
+
+  public static int $noinline$compareTo(String s, String t) {
+    return s.compareTo(t);
+  }
+
+  public static int $noinline$indexOf(String s, int ch) {
+    return s.indexOf(ch);
+  }
+
+  public static int $noinline$indexOfAfter(String s, int ch, int fromIndex) {
+    return s.indexOf(ch, fromIndex);
+  }
+
+  static void check(boolean expected, boolean actual) {
+    if (expected != actual) {
+      throw new Error("Expected " + expected + ", got " + actual);
+    }
+  }
+
+  static void check(int expected, int actual) {
+    if (expected != actual) {
+      throw new Error("Expected " + expected + ", got " + actual);
+    }
+  }
+
+  private static native void ensureJitCompiled(Class<?> cls, String methodName);
+}
@@ -0,0 +1,47 @@
+#!/bin/bash
+#
+# Copyright (C) 2024 The Android Open Source Project
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+
+def run(ctx, args):
+  # Compile the app without verifying it, so that its classes are left to the runtime.
+  # Also pass the option to dex2oat, which must ignore it.
+  compiler_options = [
+      "--compiler-filter=extract", "--runtime-arg", "-Xstartup-verification-threads=2"
+  ]
+  runtime_options = ["-Xstartup-verification-threads=2"]
+
+  ctx.echo("Run")
+  ctx.default_run(
+      args,
+      compiler_only_option=compiler_options,
+      runtime_option=runtime_options,
+      test_args=["enabled"])
+
+  ctx.echo("Run debuggable")
+  ctx.default_run(
+      args,
+      compiler_only_option=compiler_options,
+      runtime_option=runtime_options,
+      Xcompiler_option=["--debuggable"],
+      test_args=["disabled"])
+
+  ctx.echo("Run from zygote")
+  ctx.default_run(
+      args,
+      compiler_only_option=compiler_options,
+      runtime_option=runtime_options,
+      zygote=True,
+      test_args=["disabled"])
@@ -0,0 +1,74 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+public class Main {
+  // Classes that nothing uses, so only startup verification can verify them.
+  static final String[] UNUSED_CLASSES = {
+      "Main$Unused1",
+      "Main$Unused2",
+      "Main$Unused3",
+  };
+
+  public static void main(String[] args) throws Exception {
+    System.loadLibrary(args[0]);
+    boolean enabled = args[1].equals("enabled");
+
+    // Startup verification needs the oat file of the app. It is also off for
+    // debuggable runtimes, which some test configurations use.
+    boolean expected = enabled && hasOatFile() && !isDebuggable();
+    boolean started = waitForStartupVerification();
+    if (started != expected) {
+      throw new Error("Expected startup verification " + (expected ? "on" : "off"));
+    }
+
+    if (started) {
+      for (String name : UNUSED_CLASSES) {
+        Class<?> cls = Class.forName(name, /* initialize= */ false, Main.class.getClassLoader());
+        if (!isVerified(cls)) {
+          throw new Error(name + " is not verified");
+        }
+      }
+    }
+    System.out.println("passed");
+  }
+
+  static class Unused1 {
+    int value;
+
+    int get() {
+      return value;
+    }
+  }
+
+  static class Unused2 extends Unused1 {
+    int twice() {
+      return 2 * get();
+    }
+  }
+
+  static class Unused3 {
+    Object[] objects = new Object[4];
+
+    Object first() {
+      return objects.length != 0 ? objects[0] : null;
+    }
+  }
+
+  private static native boolean hasOatFile();
+  private static native boolean isDebuggable();
+  private static native boolean waitForStartupVerification();
+  private static native boolean isVerified(Class<?> cls);
+}
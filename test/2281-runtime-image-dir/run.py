@@ -0,0 +1,37 @@
+#!/bin/bash
+#
+# Copyright (C) 2024 The Android Open Source Project
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+
+def run(ctx, args):
+  # The runtime only makes images for apps which are not AOT-compiled, and without an
+  # app image from dex2oat.
+  image_dir = f"{ctx.env.DEX_LOCATION}/runtime-image-dir"
+  options = dict(
+      compiler_only_option=["--compiler-filter=verify"],
+      app_image=False,
+      runtime_option=[
+          f"-Xruntime-image-dir:{image_dir}", "-Xruntime-image-startup-timeout:100"
+      ])
+
+  # The first run has no image to load and writes one after startup.
+  ctx.echo("Write")
+  ctx.default_run(args, test_args=["write", image_dir], **options)
+  # The second run loads the image, then makes it stale for the third run.
+  ctx.echo("Load")
+  ctx.default_run(args, test_args=["load", image_dir], **options)
+  # The third run rejects the stale image and writes a new one.
+  ctx.echo("Stale")
+  ctx.default_run(args, test_args=["stale", image_dir], **options)
@@ -0,0 +1,114 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+import dalvik.system.VMRuntime;
+
+import java.io.File;
+import java.io.FileOutputStream;
+import java.io.RandomAccessFile;
+import java.nio.file.Files;
+import java.util.Arrays;
+
+public class Main {
+  // The image header starts with a 4-byte magic followed by a 4-byte version.
+  static final int VERSION_OFFSET = 4;
+  static final byte[] STALE_VERSION = {'0', '0', '0', '\0'};
+
+  public static void main(String[] args) throws Exception {
+    System.loadLibrary(args[0]);
+    String mode = args[1];
+    File image = new File(args[2] + "/cache/oat_primary/" + VMRuntime.getCurrentInstructionSet() +
+        "/2281-runtime-image-dir.art");
+
+    String filter = getCompilerFilter(Main.class);
+    if (!hasOatFile() || !hasImage() || "speed-profile".equals(filter) || "speed".equals(filter)) {
+      // The runtime only makes images with a boot image and a vdex file that is not compiled.
+      System.out.println("passed");
+      return;
+    }
+
+    // Load a few more classes for the image.
+    Helper.run();
+
+    switch (mode) {
+      case "write":
+        check(!isInImageSpace(Main.class), "Unexpected image in the first run");
+        // Startup completion, after -Xruntime-image-startup-timeout, writes the image.
+        waitForImage(image);
+        break;
+      case "load":
+        check(isInImageSpace(Main.class), "Expected the image to be loaded");
+        check(isInImageSpace(Helper.class), "Expected Helper in the image");
+        makeStale(image);
+        break;
+      case "stale":
+        check(!isInImageSpace(Main.class), "Expected the stale image to be rejected");
+        waitForImage(image);
+        break;
+      default:
+        throw new Error("Unexpected mode " + mode);
+    }
+    System.out.println("passed");
+  }
+
+  static class Helper {
+    static String value = "helper";
+
+    static void run() {
+      check(value.equals("helper"), "Unexpected value " + value);
+    }
+  }
+
+  // Waits until a valid image exists at `image`. The runtime writes it to a temporary file
+  // which it then renames, so a file with the expected version is complete.
+  static void waitForImage(File image) throws Exception {
+    while (!image.exists() || hasStaleVersion(image)) {
+      Thread.sleep(10);
+    }
+  }
+
+  static boolean hasStaleVersion(File image) throws Exception {
+    byte[] version = new byte[STALE_VERSION.length];
+    try (RandomAccessFile file = new RandomAccessFile(image, "r")) {
+      file.seek(VERSION_OFFSET);
+      file.readFully(version);
+    }
+    return Arrays.equals(version, STALE_VERSION);
+  }
+
+  // Replaces the image with a copy that has an old version, as left behind by a previous
+  // runtime. Write a new file rather than changing the loaded one in place.
+  static void makeStale(File image) throws Exception {
+    byte[] data = Files.readAllBytes(image.toPath());
+    System.arraycopy(STALE_VERSION, 0, data, VERSION_OFFSET, STALE_VERSION.length);
+    File stale = new File(image.getPath() + ".stale");
+    try (FileOutputStream out = new FileOutputStream(stale)) {
+      out.write(data);
+    }
+    check(stale.renameTo(image), "Could not replace " + image);
+  }
+
+  static void check(boolean condition, String message) {
+    if (!condition) {
+      throw new Error(message);
+    }
+  }
+
+  private static native boolean hasOatFile();
+  private static native boolean hasImage();
+  private static native String getCompilerFilter(Class<?> cls);
+  private static native boolean isInImageSpace(Class<?> cls);
+}
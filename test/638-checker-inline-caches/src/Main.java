@@ -120,6 +120,16 @@ public class Main {
     return a.getValue();
   }
 
+  // The profile marks this inline cache megamorphic without listing any class.
+  /// CHECK-START: int Main.inlineMegamorphicMarker(Super) inliner (before)
+  /// CHECK:       InvokeVirtual method_name:Super.getValue
+
+  /// CHECK-START: int Main.inlineMegamorphicMarker(Super) inliner (after)
+  /// CHECK:       InvokeVirtual method_name:Super.getValue
+  public static int inlineMegamorphicMarker(Super a) {
+    return a.getValue();
+  }
+
   /// CHECK-START: int Main.inlineMissingTypes(Super) inliner (before)
   /// CHECK:       InvokeVirtual method_name:Super.getValue
 
@@ -195,6 +205,9 @@ public class Main {
     if (inlineMegamorphic(new SubA()) != 42) {
       throw new Error("Expected 42");
     }
+    if (inlineMegamorphicMarker(new SubA()) != 42) {
+      throw new Error("Expected 42");
+    }
   }
 
 
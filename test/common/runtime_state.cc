@@ -23,7 +23,9 @@
 #include "base/enums.h"
 #include "common_throws.h"
 #include "dex/dex_file-inl.h"
+#include "dex/dex_instruction.h"
 #include "gc/heap.h"
+#include "handle_scope-inl.h"
 #include "instrumentation.h"
 #include "jit/jit.h"
 #include "jit/jit_code_cache.h"
@@ -32,9 +34,11 @@
 #include "jni/jni_internal.h"
 #include "mirror/class-inl.h"
 #include "mirror/class.h"
+#include "mirror/object_array-inl.h"
 #include "nativehelper/ScopedUtfChars.h"
 #include "oat.h"
 #include "oat_file.h"
+#include "oat_file_manager.h"
 #include "oat_quick_method_header.h"
 #include "profile/profile_compilation_info.h"
 #include "runtime.h"
@@ -89,6 +93,23 @@ extern "C" JNIEXPORT jobject JNICALL Java_Main_getCompilerFilter(JNIEnv* env,
       mirror::String::AllocFromModifiedUtf8(soa.Self(), filter.c_str()));
 }
 
+// public static native boolean waitForStartupVerification();
+
+extern "C" JNIEXPORT jboolean JNICALL Java_Main_waitForStartupVerification(JNIEnv*, jclass) {
+  return Runtime::Current()->GetOatFileManager().WaitForStartupVerificationTasks()
+      ? JNI_TRUE
+      : JNI_FALSE;
+}
+
+// public static native boolean isVerified(Class<?> cls);
+
+extern "C" JNIEXPORT jboolean JNICALL Java_Main_isVerified(JNIEnv* env,
+                                                           [[maybe_unused]] jclass caller,
+                                                           jclass cls) {
+  ScopedObjectAccess soa(env);
+  return soa.Decode<mirror::Class>(cls)->IsVerified() ? JNI_TRUE : JNI_FALSE;
+}
+
 // public static native boolean runtimeIsSoftFail();
 
 extern "C" JNIEXPORT jboolean JNICALL Java_Main_runtimeIsSoftFail([[maybe_unused]] JNIEnv* env,
@@ -281,14 +302,18 @@ static void ForceJitCompiled(Thread* self,
     }
     const void* entry_point = method->GetEntryPointFromQuickCompiledCode();
     if (code_cache->ContainsPc(entry_point)) {
-      // If we're running baseline or not requesting optimized, we're good to go.
-      if (jit->GetJitCompiler()->IsBaselineCompiler() || kind != CompilationKind::kOptimized) {
+      // If we're running baseline or requesting baseline or OSR, we're good to go.
+      if (jit->GetJitCompiler()->IsBaselineCompiler() ||
+          kind == CompilationKind::kBaseline ||
+          kind == CompilationKind::kOsr) {
         break;
       }
-      // If we're requesting optimized, check that we did get the method
-      // compiled optimized.
+      // If we're requesting optimized or baseline-plus, check that we did get the method
+      // compiled that way.
       OatQuickMethodHeader* method_header = OatQuickMethodHeader::FromEntryPoint(entry_point);
-      if (!CodeInfo::IsBaseline(method_header->GetOptimizedCodeInfoPtr())) {
+      const uint8_t* code_info = method_header->GetOptimizedCodeInfoPtr();
+      if (kind == CompilationKind::kBaselinePlus ? CodeInfo::IsBaselinePlus(code_info)
+                                                 : !CodeInfo::IsBaseline(code_info)) {
         break;
       }
     }
@@ -350,6 +375,111 @@ extern "C" JNIEXPORT void JNICALL Java_Main_ensureJitBaselineCompiled(JNIEnv* en
   ForceJitCompiled(self, method, CompilationKind::kBaseline);
 }
 
+extern "C" JNIEXPORT void JNICALL Java_Main_ensureJitBaselinePlusCompiled(JNIEnv* env,
+                                                                          jclass,
+                                                                          jclass cls,
+                                                                          jstring method_name) {
+  jit::Jit* jit = GetJitIfEnabled();
+  if (jit == nullptr) {
+    return;
+  }
+
+  Thread* self = Thread::Current();
+  ArtMethod* method = nullptr;
+  {
+    ScopedObjectAccess soa(self);
+
+    ScopedUtfChars chars(env, method_name);
+    method = GetMethod(soa, cls, chars);
+  }
+  ForceJitCompiled(self, method, CompilationKind::kBaselinePlus);
+}
+
+// Returns the JIT tier of the code the method currently runs: "baseline", "baseline-plus",
+// "optimized", or "none" if it does not run JIT code.
+extern "C" JNIEXPORT jstring JNICALL Java_Main_getJitTier(JNIEnv* env,
+                                                          jclass,
+                                                          jclass cls,
+                                                          jstring method_name) {
+  jit::Jit* jit = GetJitIfEnabled();
+  ScopedObjectAccess soa(Thread::Current());
+  ScopedUtfChars chars(env, method_name);
+  ArtMethod* method = GetMethod(soa, cls, chars);
+  const void* entry_point = method->GetEntryPointFromQuickCompiledCode();
+  const char* tier = "none";
+  if (jit != nullptr && jit->GetCodeCache()->ContainsPc(entry_point)) {
+    OatQuickMethodHeader* method_header = OatQuickMethodHeader::FromEntryPoint(entry_point);
+    const uint8_t* code_info = method_header->GetOptimizedCodeInfoPtr();
+    tier = CodeInfo::IsBaselinePlus(code_info)
+        ? "baseline-plus"
+        : (CodeInfo::IsBaseline(code_info) ? "baseline" : "optimized");
+  }
+  return env->NewStringUTF(tier);
+}
+
+// Records each object of `survivors` as an allocation sample of every new-instance of the
+// method. Once the survivors have lived through enough GCs, the sites are pretenured.
+extern "C" JNIEXPORT void JNICALL Java_Main_addAllocationSamples(JNIEnv* env,
+                                                                jclass,
+                                                                jclass cls,
+                                                                jstring method_name,
+                                                                jobjectArray survivors) {
+  jit::Jit* jit = GetJitIfEnabled();
+  if (jit == nullptr) {
+    return;
+  }
+  ScopedObjectAccess soa(Thread::Current());
+  ScopedUtfChars chars(env, method_name);
+  ArtMethod* method = GetMethod(soa, cls, chars);
+  jit::JitCodeCache* code_cache = jit->GetCodeCache();
+  if (code_cache->GetProfilingInfo(method, soa.Self()) == nullptr &&
+      ProfilingInfo::Create(soa.Self(), method) == nullptr) {
+    return;
+  }
+  ObjPtr<mirror::ObjectArray<mirror::Object>> objects =
+      soa.Decode<mirror::ObjectArray<mirror::Object>>(survivors);
+  for (const DexInstructionPcPair& inst : method->DexInstructions()) {
+    if (inst->Opcode() == Instruction::NEW_INSTANCE) {
+      for (int32_t i = 0; i < objects->GetLength(); ++i) {
+        code_cache->AddAllocationSample(soa.Self(), method, inst.DexPc(), objects->Get(i));
+      }
+    }
+  }
+}
+
+// Returns whether every new-instance of the method is to be pretenured.
+extern "C" JNIEXPORT jboolean JNICALL Java_Main_shouldPretenure(JNIEnv* env,
+                                                               jclass,
+                                                               jclass cls,
+                                                               jstring method_name) {
+  jit::Jit* jit = GetJitIfEnabled();
+  if (jit == nullptr) {
+    return false;
+  }
+  ScopedObjectAccess soa(Thread::Current());
+  ScopedUtfChars chars(env, method_name);
+  ArtMethod* method = GetMethod(soa, cls, chars);
+  ProfilingInfo* info = jit->GetCodeCache()->GetProfilingInfo(method, soa.Self());
+  if (info == nullptr) {
+    return false;
+  }
+  for (const DexInstructionPcPair& inst : method->DexInstructions()) {
+    if (inst->Opcode() == Instruction::NEW_INSTANCE) {
+      AllocationSiteCache* cache = info->GetAllocationSiteCache(inst.DexPc());
+      if (cache == nullptr || !cache->ShouldPretenure()) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+// Returns how many JIT compilations ran over their budget and skipped optional passes.
+extern "C" JNIEXPORT jlong JNICALL Java_Main_getJitOverBudgetCount(JNIEnv*, jclass) {
+  return static_cast<jlong>(
+      Runtime::Current()->GetMetrics()->JitMethodCompileOverBudgetCount()->Value());
+}
+
 extern "C" JNIEXPORT jboolean JNICALL Java_Main_hasSingleImplementation(JNIEnv* env,
                                                                         jclass,
                                                                         jclass cls,
@@ -386,6 +516,45 @@ extern "C" JNIEXPORT int JNICALL Java_Main_getHotnessCounter(JNIEnv* env,
   return std::numeric_limits<int32_t>::min();
 }
 
+// Returns the number of calls recorded for `receiver` by the inline cache of the first virtual
+// or interface invoke in the given method, or -1 if the method has no profiling info.
+extern "C" JNIEXPORT jint JNICALL Java_Main_getInlineCacheCount(JNIEnv* env,
+                                                                jclass,
+                                                                jclass cls,
+                                                                jstring method_name,
+                                                                jclass receiver) {
+  jit::Jit* jit = GetJitIfEnabled();
+  if (jit == nullptr) {
+    return -1;
+  }
+  Thread* self = Thread::Current();
+  ScopedObjectAccess soa(self);
+  ScopedUtfChars chars(env, method_name);
+  ArtMethod* method = GetMethod(soa, cls, chars);
+  ProfilingInfo* info = jit->GetCodeCache()->GetProfilingInfo(method, self);
+  if (info == nullptr) {
+    return -1;
+  }
+  for (const DexInstructionPcPair& inst : method->DexInstructions()) {
+    if (inst->Opcode() != Instruction::INVOKE_VIRTUAL &&
+        inst->Opcode() != Instruction::INVOKE_INTERFACE) {
+      continue;
+    }
+    InlineCache* cache = info->GetInlineCache(inst.DexPc());
+    StackHandleScope<InlineCache::kIndividualCacheSize> classes(self);
+    uint32_t counts[InlineCache::kIndividualCacheSize];
+    jit->GetCodeCache()->CopyInlineCacheInto(*cache, &classes, counts);
+    ObjPtr<mirror::Class> receiver_class = soa.Decode<mirror::Class>(receiver);
+    for (size_t i = 0; i != classes.Size(); ++i) {
+      if (classes.GetReference(i) == receiver_class) {
+        return counts[i];
+      }
+    }
+    return 0;
+  }
+  return -1;
+}
+
 extern "C" JNIEXPORT int JNICALL Java_Main_numberOfDeoptimizations(JNIEnv*, jclass) {
   return Runtime::Current()->GetNumberOfDeoptimizations();
 }